@@ -28,7 +28,9 @@ public class DA2DialogViewer : ModuleRules
 				"EditorStyle",
 				"Projects",
 				"XmlParser",
-				"AudioMixer"
+				"AudioMixer",
+				"AudioMixerCore",
+				"DirectoryWatcher"
 			}
 		);
 	}
@@ -0,0 +1,70 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Audio/AudioFileIndex.h"
+#include "Audio/AudioUtils.h"
+#include "HAL/FileManager.h"
+#include "Misc/PathViews.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
+#include "DA2DialogViewerLog.h"
+
+TSharedPtr<const FAudioFileIndex> FAudioFileIndex::Build(const FString& AudioDirectory)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	TSharedPtr<FAudioFileIndex> Index = MakeShared<FAudioFileIndex>();
+	int32 NumSkipped = 0;
+
+	IFileManager::Get().IterateDirectory(*AudioDirectory, [&Index, &NumSkipped](const TCHAR* Path, bool bIsDirectory)
+	{
+		uint32 FileID = 0;
+		if (!bIsDirectory)
+		{
+			if (FAudioUtils::ParseAudioFileID(FPathViews::GetCleanFilename(Path), FileID))
+			{
+				Index->FileIDs.Add(FileID);
+			}
+			else
+			{
+				++NumSkipped;
+			}
+		}
+		return true;
+	});
+
+	Index->FileIDs.Sort();
+	Index->FileIDs.SetNum(Algo::Unique(Index->FileIDs));
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("Indexed %d audio files in %s (%d other files skipped) in %.2f s"),
+		Index->FileIDs.Num(), *AudioDirectory, NumSkipped, FPlatformTime::Seconds() - StartTime);
+
+	return Index;
+}
+
+TSharedPtr<const FAudioFileIndex> FAudioFileIndex::WithChanges(TConstArrayView<uint32> Added, TConstArrayView<uint32> Removed) const
+{
+	TArray<uint32> SortedRemoved(Removed.GetData(), Removed.Num());
+	SortedRemoved.Sort();
+
+	TSharedPtr<FAudioFileIndex> Index = MakeShared<FAudioFileIndex>();
+	Index->FileIDs.Reserve(FileIDs.Num() + Added.Num());
+
+	for (const uint32 FileID : FileIDs)
+	{
+		if (Algo::BinarySearch(SortedRemoved, FileID) == INDEX_NONE)
+		{
+			Index->FileIDs.Add(FileID);
+		}
+	}
+
+	Index->FileIDs.Append(Added.GetData(), Added.Num());
+	Index->FileIDs.Sort();
+	Index->FileIDs.SetNum(Algo::Unique(Index->FileIDs));
+
+	return Index;
+}
+
+bool FAudioFileIndex::Contains(uint32 FileID) const
+{
+	return Algo::BinarySearch(FileIDs, FileID) != INDEX_NONE;
+}
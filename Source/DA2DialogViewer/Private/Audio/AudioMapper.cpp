@@ -1,8 +1,10 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Audio/AudioMapper.h"
+#include "Audio/AudioUtils.h"
 #include "Data/DialogCSVReader.h"
-#include "Misc/Paths.h"
+#include "Algo/BinarySearch.h"
+#include "DA2DialogViewerLog.h"
 
 FAudioMapper::FAudioMapper()
 {
@@ -19,10 +21,16 @@ bool FAudioMapper::LoadDialogCSV(const FString& CSVPath)
 	TArray<TArray<FString>> Rows;
 	if (!FDialogCSVReader::ReadCSV(CSVPath, Rows))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to load dialog CSV: %s"), *CSVPath);
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to load dialog CSV: %s"), *CSVPath);
 		return false;
 	}
 
+	// Only needed while loading: where each dialog ID's entry is, and each sound bank's index
+	TMap<int32, int32> EntryIndices;
+	TMap<FString, uint16> SoundBankIndices;
+	int32 NumInvalidFileIDs = 0;
+	int32 NumSoundBankOverflows = 0;
+
 	// Parse each row: dialog_id, gender, audio_file_id, sound_bank
 	for (const TArray<FString>& Row : Rows)
 	{
@@ -32,75 +40,133 @@ bool FAudioMapper::LoadDialogCSV(const FString& CSVPath)
 		}
 
 		int32 DialogID = FCString::Atoi(*Row[0]);
-		FString Gender = Row[1].TrimStartAndEnd().ToLower();
-		FString AudioFileID = Row[2].TrimStartAndEnd();
-		FString SoundBank = Row[3].TrimStartAndEnd();
+		FStringView Gender = FStringView(Row[1]).TrimStartAndEnd();
+		FStringView AudioFileID = FStringView(Row[2]).TrimStartAndEnd();
 
 		if (DialogID <= 0 || AudioFileID.IsEmpty())
 		{
 			continue;
 		}
 
+		// Files are all named <id>.wav, anything else can't be found in the audio directory
+		uint32 ParsedFileID = 0;
+		if (!FAudioUtils::ParseAudioFileNumber(AudioFileID, ParsedFileID))
+		{
+			++NumInvalidFileIDs;
+			continue;
+		}
+
 		// Find or create audio info entry
-		FDialogAudioInfo* AudioInfo = AudioMap.Find(DialogID);
-		if (!AudioInfo)
+		int32* EntryIndex = EntryIndices.Find(DialogID);
+		if (!EntryIndex)
 		{
-			FDialogAudioInfo NewInfo;
+			const FString SoundBank(FStringView(Row[3]).TrimStartAndEnd());
+			const uint16* SoundBankIndex = SoundBankIndices.Find(SoundBank);
+			if (!SoundBankIndex)
+			{
+				// Entries store a 16-bit bank index; a malformed CSV with more banks than that loses the extra rows
+				if (SoundBanks.Num() > MAX_uint16)
+				{
+					++NumSoundBankOverflows;
+					continue;
+				}
+				SoundBankIndex = &SoundBankIndices.Add(SoundBank, static_cast<uint16>(SoundBanks.Add(SoundBank)));
+			}
+
+			FDialogAudioInfo& NewInfo = Entries.AddDefaulted_GetRef();
 			NewInfo.DialogID = DialogID;
-			NewInfo.SoundBank = SoundBank;
-			AudioInfo = &AudioMap.Add(DialogID, NewInfo);
+			NewInfo.SoundBankIndex = *SoundBankIndex;
+			EntryIndex = &EntryIndices.Add(DialogID, Entries.Num() - 1);
 		}
 
 		// Set male or female audio file
-		if (Gender == TEXT("m"))
+		FDialogAudioInfo& AudioInfo = Entries[*EntryIndex];
+		if (Gender.Equals(TEXT("m"), ESearchCase::IgnoreCase))
 		{
-			AudioInfo->MaleAudioFile = AudioFileID + TEXT(".wav");
+			AudioInfo.MaleAudioFileID = ParsedFileID;
+			AudioInfo.bHasMaleAudio = true;
 		}
-		else if (Gender == TEXT("f"))
+		else if (Gender.Equals(TEXT("f"), ESearchCase::IgnoreCase))
 		{
-			AudioInfo->FemaleAudioFile = AudioFileID + TEXT(".wav");
+			AudioInfo.FemaleAudioFileID = ParsedFileID;
+			AudioInfo.bHasFemaleAudio = true;
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Loaded %d dialog audio mappings from %s"), AudioMap.Num(), *CSVPath);
-	return AudioMap.Num() > 0;
+	Entries.Sort([](const FDialogAudioInfo& A, const FDialogAudioInfo& B) { return A.DialogID < B.DialogID; });
+	Entries.Shrink();
+	SoundBanks.Shrink();
+
+	if (NumInvalidFileIDs > 0)
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Skipped %d dialog audio mappings with a non-numeric audio file ID"), NumInvalidFileIDs);
+	}
+
+	if (NumSoundBankOverflows > 0)
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Skipped %d dialog audio mappings beyond the first %d sound banks"), NumSoundBankOverflows, MAX_uint16 + 1);
+	}
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("Loaded %d dialog audio mappings (%d sound banks, %.1f KB) from %s"),
+		Entries.Num(), SoundBanks.Num(), GetAllocatedSize() / 1024.0, *CSVPath);
+	return Entries.Num() > 0;
+}
+
+const FDialogAudioInfo* FAudioMapper::FindEntry(int32 DialogID) const
+{
+	const int32 Index = Algo::BinarySearchBy(Entries, DialogID, &FDialogAudioInfo::DialogID);
+	return Index != INDEX_NONE ? &Entries[Index] : nullptr;
 }
 
-FString FAudioMapper::GetAudioFile(int32 DialogID, EPlayerGender Gender) const
+bool FAudioMapper::FindAudioFileID(int32 DialogID, EPlayerGender Gender, uint32& OutAudioFileID) const
 {
-	const FDialogAudioInfo* AudioInfo = AudioMap.Find(DialogID);
+	const FDialogAudioInfo* AudioInfo = FindEntry(DialogID);
 	if (!AudioInfo)
 	{
-		return FString();
+		return false;
 	}
 
 	if (Gender == EPlayerGender::Male)
 	{
-		return AudioInfo->MaleAudioFile;
+		OutAudioFileID = AudioInfo->MaleAudioFileID;
+		return AudioInfo->bHasMaleAudio;
 	}
 	else
 	{
-		return AudioInfo->FemaleAudioFile;
+		OutAudioFileID = AudioInfo->FemaleAudioFileID;
+		return AudioInfo->bHasFemaleAudio;
 	}
 }
 
 FString FAudioMapper::GetAudioFilePath(int32 DialogID, EPlayerGender Gender, const FString& AudioDirectory) const
 {
-	FString AudioFile = GetAudioFile(DialogID, Gender);
-	if (AudioFile.IsEmpty())
+	uint32 AudioFileID = 0;
+	if (!FindAudioFileID(DialogID, Gender, AudioFileID))
 	{
 		return FString();
 	}
 
-	return FPaths::Combine(AudioDirectory, AudioFile);
+	return FAudioUtils::BuildAudioFilePath(AudioDirectory, AudioFileID);
 }
 
-bool FAudioMapper::HasAudioMapping(int32 DialogID) const
+FStringView FAudioMapper::GetSoundBank(int32 DialogID) const
 {
-	return AudioMap.Contains(DialogID);
+	const FDialogAudioInfo* AudioInfo = FindEntry(DialogID);
+	return AudioInfo ? FStringView(SoundBanks[AudioInfo->SoundBankIndex]) : FStringView();
+}
+
+SIZE_T FAudioMapper::GetAllocatedSize() const
+{
+	SIZE_T Size = Entries.GetAllocatedSize() + SoundBanks.GetAllocatedSize();
+	for (const FString& SoundBank : SoundBanks)
+	{
+		Size += SoundBank.GetAllocatedSize();
+	}
+	return Size;
 }
 
 void FAudioMapper::Clear()
 {
-	AudioMap.Empty();
+	Entries.Empty();
+	SoundBanks.Empty();
 }
@@ -4,28 +4,70 @@
 #include "HAL/FileManager.h"
 #include "Misc/Paths.h"
 
-uint32 FAudioUtils::ComputeFNV32Hash(const FString& String)
+namespace AudioUtils
 {
-	// FNV-1a 32-bit hash algorithm
-	// Used by Dragon Age 2 for generating audio file IDs
-
 	// FNV-1a prime and offset basis for 32-bit
-	const uint32 FNV_Prime = 16777619u;
-	const uint32 FNV_OffsetBasis = 2166136261u;
+	static constexpr uint32 FNVPrime = 16777619u;
+	static constexpr uint32 FNVOffsetBasis = 2166136261u;
 
-	uint32 Hash = FNV_OffsetBasis;
+	// Longest "<TLKID>_<m|f>" key: "-2147483648_m" is 13 characters
+	static constexpr int32 MaxKeyLength = 16;
 
-	// Convert string to lowercase ASCII bytes (DA2 uses lowercase for hashing)
-	FString LowerString = String.ToLower();
+	// SIMD lanes per register in the bulk path
+	static constexpr int32 NumLanes = 4;
 
-	// Process each byte
-	for (int32 i = 0; i < LowerString.Len(); ++i)
+	// Write "<TLKID>_<m|f>" as lowercase ASCII, returns the length
+	static int32 WriteAudioFileKey(int32 TLKID, bool bIsMale, uint8 (&OutKey)[MaxKeyLength])
 	{
-		TCHAR Char = LowerString[i];
+		// Digits come out least significant first, so build them at the back of a scratch buffer
+		uint8 Digits[10];
+		int32 NumDigits = 0;
+		uint32 Value = TLKID < 0 ? 0u - static_cast<uint32>(TLKID) : static_cast<uint32>(TLKID);
+		do
+		{
+			Digits[NumDigits++] = static_cast<uint8>('0' + Value % 10);
+			Value /= 10;
+		}
+		while (Value != 0);
 
-		// FNV-1a: XOR with byte, then multiply by prime
-		Hash ^= static_cast<uint8>(Char);
-		Hash *= FNV_Prime;
+		int32 Length = 0;
+		if (TLKID < 0)
+		{
+			OutKey[Length++] = '-';
+		}
+		while (NumDigits > 0)
+		{
+			OutKey[Length++] = Digits[--NumDigits];
+		}
+		OutKey[Length++] = '_';
+		OutKey[Length++] = bIsMale ? 'm' : 'f';
+		return Length;
+	}
+
+	static uint32 HashBytes(const uint8* Bytes, int32 Length)
+	{
+		uint32 Hash = FNVOffsetBasis;
+		for (int32 i = 0; i < Length; ++i)
+		{
+			// FNV-1a: XOR with byte, then multiply by prime
+			Hash ^= Bytes[i];
+			Hash *= FNVPrime;
+		}
+		return Hash;
+	}
+}
+
+uint32 FAudioUtils::ComputeFNV32Hash(FStringView String)
+{
+	// FNV-1a 32-bit hash algorithm
+	// Used by Dragon Age 2 for generating audio file IDs
+	uint32 Hash = AudioUtils::FNVOffsetBasis;
+
+	// DA2 hashes the lowercase ASCII bytes
+	for (const TCHAR Char : String)
+	{
+		Hash ^= static_cast<uint8>(FChar::ToLower(Char));
+		Hash *= AudioUtils::FNVPrime;
 	}
 
 	return Hash;
@@ -33,11 +75,58 @@ uint32 FAudioUtils::ComputeFNV32Hash(const FString& String)
 
 uint32 FAudioUtils::ComputeAudioFileID(int32 TLKID, bool bIsMale)
 {
-	// Build string: "TLKID_M" or "TLKID_F"
 	// Example: TLK ID 6000680 with male = "6000680_m"
-	FString IDString = FString::Printf(TEXT("%d_%s"), TLKID, bIsMale ? TEXT("m") : TEXT("f"));
+	uint8 Key[AudioUtils::MaxKeyLength];
+	const int32 Length = AudioUtils::WriteAudioFileKey(TLKID, bIsMale, Key);
+	return AudioUtils::HashBytes(Key, Length);
+}
+
+void FAudioUtils::ComputeAudioFileIDs(TConstArrayView<int32> TLKIDs, bool bIsMale, TArrayView<uint32> OutAudioFileIDs)
+{
+	using namespace AudioUtils;
+
+	check(OutAudioFileIDs.Num() >= TLKIDs.Num());
+
+	const VectorRegister4Int Prime = VectorIntSet1(static_cast<int32>(FNVPrime));
+	const VectorRegister4Int OffsetBasis = VectorIntSet1(static_cast<int32>(FNVOffsetBasis));
+
+	// FNV is sequential within a key but independent across keys, so each lane hashes its own key
+	const int32 NumVectorized = TLKIDs.Num() / NumLanes * NumLanes;
+	for (int32 Base = 0; Base < NumVectorized; Base += NumLanes)
+	{
+		// Transpose the keys: row i holds character i of every lane, and a mask of the lanes whose key is that long
+		alignas(16) int32 Bytes[MaxKeyLength][NumLanes];
+		alignas(16) int32 Masks[MaxKeyLength][NumLanes];
+		int32 MaxLength = 0;
+
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			uint8 Key[MaxKeyLength];
+			const int32 Length = WriteAudioFileKey(TLKIDs[Base + Lane], bIsMale, Key);
+			for (int32 i = 0; i < MaxKeyLength; ++i)
+			{
+				Bytes[i][Lane] = i < Length ? Key[i] : 0;
+				Masks[i][Lane] = i < Length ? -1 : 0;
+			}
+			MaxLength = FMath::Max(MaxLength, Length);
+		}
+
+		// Lanes past the end of their key keep their hash
+		VectorRegister4Int Hash = OffsetBasis;
+		for (int32 i = 0; i < MaxLength; ++i)
+		{
+			const VectorRegister4Int Mask = VectorIntLoadAligned(Masks[i]);
+			const VectorRegister4Int Next = VectorIntMultiply(VectorIntXor(Hash, VectorIntLoadAligned(Bytes[i])), Prime);
+			Hash = VectorIntOr(VectorIntAnd(Next, Mask), VectorIntAndNot(Mask, Hash));
+		}
 
-	return ComputeFNV32Hash(IDString);
+		VectorIntStore(Hash, OutAudioFileIDs.GetData() + Base);
+	}
+
+	for (int32 Index = NumVectorized; Index < TLKIDs.Num(); ++Index)
+	{
+		OutAudioFileIDs[Index] = ComputeAudioFileID(TLKIDs[Index], bIsMale);
+	}
 }
 
 bool FAudioUtils::DoesAudioFileExist(const FString& AudioDirectory, uint32 AudioFileID)
@@ -50,4 +139,42 @@ FString FAudioUtils::BuildAudioFilePath(const FString& AudioDirectory, uint32 Au
 {
 	// Build path like "Data/all_conv_wav/267111449.wav"
 	return FPaths::Combine(AudioDirectory, FString::Printf(TEXT("%u.wav"), AudioFileID));
+}
+
+bool FAudioUtils::ParseAudioFileID(FStringView FileName, uint32& OutAudioFileID)
+{
+	const FStringView Extension = TEXTVIEW(".wav");
+	if (!FileName.EndsWith(Extension, ESearchCase::IgnoreCase))
+	{
+		return false;
+	}
+
+	return ParseAudioFileNumber(FileName.LeftChop(Extension.Len()), OutAudioFileID);
+}
+
+bool FAudioUtils::ParseAudioFileNumber(FStringView Digits, uint32& OutAudioFileID)
+{
+	// 1-10 digits, no sign or spaces
+	if (Digits.IsEmpty() || Digits.Len() > 10)
+	{
+		return false;
+	}
+
+	uint64 Value = 0;
+	for (const TCHAR Char : Digits)
+	{
+		if (Char < TEXT('0') || Char > TEXT('9'))
+		{
+			return false;
+		}
+		Value = Value * 10 + (Char - TEXT('0'));
+	}
+
+	if (Value > MAX_uint32)
+	{
+		return false;
+	}
+
+	OutAudioFileID = static_cast<uint32>(Value);
+	return true;
 }
\ No newline at end of file
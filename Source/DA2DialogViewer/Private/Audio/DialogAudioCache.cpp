@@ -0,0 +1,236 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Audio/DialogAudioCache.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
+
+namespace DialogAudioCache
+{
+	// Backstop on the number of cached lines (a typical line is a few hundred KB, so bytes run out first)
+	static constexpr int32 MaxEntries = 4096;
+}
+
+FDialogAudioCache::FDialogAudioCache(SIZE_T InMaxBytes)
+	: MaxBytes(InMaxBytes)
+	, Entries(DialogAudioCache::MaxEntries)
+{
+}
+
+FDialogAudioCache::~FDialogAudioCache()
+{
+	Empty();
+}
+
+TSharedPtr<const FDialogDecodedAudio> FDialogAudioCache::Find(const FString& FilePath)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	const TSharedPtr<const FDialogDecodedAudio>* Found = Entries.FindAndTouch(FilePath);
+	return Found ? *Found : nullptr;
+}
+
+TSharedPtr<const FDialogDecodedAudio> FDialogAudioCache::FindOrDecode(const FString& FilePath)
+{
+	if (TSharedPtr<const FDialogDecodedAudio> Cached = Find(FilePath))
+	{
+		return Cached;
+	}
+
+	TSharedPtr<const FDialogDecodedAudio> Decoded = DecodeFile(FilePath);
+	if (Decoded.IsValid())
+	{
+		Add(FilePath, Decoded);
+	}
+	return Decoded;
+}
+
+void FDialogAudioCache::Prefetch(TConstArrayView<FString> FilePaths)
+{
+	bool bStartWorker = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		// Insert in reverse so the first path of this request ends up at the front of the queue
+		for (int32 PathIndex = FilePaths.Num() - 1; PathIndex >= 0; --PathIndex)
+		{
+			const FString& FilePath = FilePaths[PathIndex];
+			if (FilePath.IsEmpty() || (FilePath == InFlightPrefetch && !bInFlightPrefetchStale) || Entries.Contains(FilePath))
+			{
+				continue;
+			}
+
+			PendingPrefetches.Remove(FilePath);
+			PendingPrefetches.Insert(FilePath, 0);
+		}
+
+		if (PendingPrefetches.Num() > MaxPendingPrefetches)
+		{
+			PendingPrefetches.SetNum(MaxPendingPrefetches);
+		}
+
+		if (PendingPrefetches.Num() > 0 && !bPrefetchRunning)
+		{
+			bPrefetchRunning = true;
+			bStartWorker = true;
+		}
+	}
+
+	if (bStartWorker)
+	{
+		TWeakPtr<FDialogAudioCache> WeakThis = AsShared();
+		Async(EAsyncExecution::ThreadPool, [WeakThis]()
+		{
+			if (TSharedPtr<FDialogAudioCache> This = WeakThis.Pin())
+			{
+				This->ProcessPrefetchQueue();
+			}
+		});
+	}
+}
+
+void FDialogAudioCache::ProcessPrefetchQueue()
+{
+	for (;;)
+	{
+		FString FilePath;
+		{
+			FScopeLock ScopeLock(&Lock);
+			InFlightPrefetch.Empty();
+			bInFlightPrefetchStale = false;
+			if (PendingPrefetches.Num() == 0)
+			{
+				bPrefetchRunning = false;
+				return;
+			}
+
+			FilePath = PendingPrefetches[0];
+			PendingPrefetches.RemoveAt(0);
+			InFlightPrefetch = FilePath;
+		}
+
+		// Decoded outside the lock, playback keeps looking lines up while this reads
+		if (TSharedPtr<const FDialogDecodedAudio> Decoded = DecodeFile(FilePath, GetMaxLineBytes()))
+		{
+			// A file rewritten while it was being read may have been decoded half old, half new
+			FScopeLock ScopeLock(&Lock);
+			if (!bInFlightPrefetchStale)
+			{
+				AddLocked(FilePath, MoveTemp(Decoded));
+			}
+		}
+	}
+}
+
+void FDialogAudioCache::Add(const FString& FilePath, TSharedPtr<const FDialogDecodedAudio> Decoded)
+{
+	FScopeLock ScopeLock(&Lock);
+	AddLocked(FilePath, MoveTemp(Decoded));
+}
+
+void FDialogAudioCache::AddLocked(const FString& FilePath, TSharedPtr<const FDialogDecodedAudio> Decoded)
+{
+	const SIZE_T Size = Decoded->GetAllocatedSize();
+
+	if (Size > GetMaxLineBytes())
+	{
+		UE_LOG(LogDA2Dialog, Verbose, TEXT("DialogAudioCache: %s is too large to cache (%llu bytes)"), *FilePath, static_cast<uint64>(Size));
+		return;
+	}
+
+	if (Entries.Contains(FilePath))
+	{
+		return;
+	}
+
+	while (Entries.Num() > 0 && (UsedBytes + Size > MaxBytes || Entries.Num() >= Entries.Max()))
+	{
+		const TSharedPtr<const FDialogDecodedAudio> Evicted = Entries.RemoveLeastRecent();
+		const SIZE_T EvictedSize = Evicted->GetAllocatedSize();
+		UsedBytes -= EvictedSize;
+		DEC_MEMORY_STAT_BY(STAT_DA2Dialog_AudioCacheMemory, EvictedSize);
+	}
+
+	Entries.Add(FilePath, MoveTemp(Decoded));
+	UsedBytes += Size;
+	INC_MEMORY_STAT_BY(STAT_DA2Dialog_AudioCacheMemory, Size);
+}
+
+void FDialogAudioCache::Remove(const FString& FilePath)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	PendingPrefetches.Remove(FilePath);
+	if (FilePath == InFlightPrefetch)
+	{
+		bInFlightPrefetchStale = true;
+	}
+
+	const TSharedPtr<const FDialogDecodedAudio>* Found = Entries.Find(FilePath);
+	if (!Found)
+	{
+		return;
+	}
+
+	UE_LOG(LogDA2Dialog, Verbose, TEXT("DialogAudioCache: %s changed on disk, dropping the cached copy"), *FilePath);
+
+	const SIZE_T Size = (*Found)->GetAllocatedSize();
+	Entries.Remove(FilePath);
+	UsedBytes -= Size;
+	DEC_MEMORY_STAT_BY(STAT_DA2Dialog_AudioCacheMemory, Size);
+}
+
+void FDialogAudioCache::Empty()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	PendingPrefetches.Empty();
+	bInFlightPrefetchStale = !InFlightPrefetch.IsEmpty();
+	Entries.Empty(DialogAudioCache::MaxEntries);
+	DEC_MEMORY_STAT_BY(STAT_DA2Dialog_AudioCacheMemory, UsedBytes);
+	UsedBytes = 0;
+}
+
+SIZE_T FDialogAudioCache::GetUsedBytes() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return UsedBytes;
+}
+
+TSharedPtr<const FDialogDecodedAudio> FDialogAudioCache::DecodeFile(const FString& FilePath, SIZE_T MaxDecodedBytes)
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_DecodeAudio);
+
+	FDialogWavReader Reader;
+	if (!Reader.Open(FilePath))
+	{
+		return nullptr;
+	}
+
+	const FDialogWavFormat& Format = Reader.GetFormat();
+	const int64 NumSamples = Format.GetNumFrames() * Format.NumChannels;
+	if (NumSamples > MAX_int32)
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioCache: %s is too long to decode (%lld samples)"), *FilePath, NumSamples);
+		return nullptr;
+	}
+
+	const uint64 DecodedBytes = sizeof(FDialogDecodedAudio) + static_cast<uint64>(NumSamples) * sizeof(float);
+	if (DecodedBytes > MaxDecodedBytes)
+	{
+		UE_LOG(LogDA2Dialog, Verbose, TEXT("DialogAudioCache: %s is too large to decode into the cache (%llu bytes)"), *FilePath, DecodedBytes);
+		return nullptr;
+	}
+
+	TSharedPtr<FDialogDecodedAudio> Decoded = MakeShared<FDialogDecodedAudio>();
+	Decoded->Format = Format;
+
+	const int32 NumChannels = Decoded->Format.NumChannels;
+	Decoded->Samples.SetNumUninitialized(static_cast<int32>(NumSamples));
+
+	// The reader converts straight from the mapped file, so the whole line is one pass with no staging buffer
+	const int32 FramesDecoded = Reader.ReadFrames(Decoded->Samples.GetData(), static_cast<int32>(Decoded->Format.GetNumFrames()));
+	Decoded->Samples.SetNum(FramesDecoded * NumChannels);
+	return Decoded;
+}
@@ -0,0 +1,389 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Audio/DialogAudioCoverage.h"
+#include "Audio/AudioFileIndex.h"
+#include "Audio/AudioMapper.h"
+#include "Audio/AudioUtils.h"
+#include "Audio/DialogWaveformCache.h"
+#include "Data/DialogDataManager.h"
+#include "Data/ConversationParser.h"
+#include "DialogFlow/Conversation.h"
+#include "HAL/FileManager.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
+
+namespace DialogAudioCoverage
+{
+	// One line as used by one conversation, with what it resolved to
+	struct FLineUse
+	{
+		int32 TLKID;
+		int32 Conversation;
+		int32 NodeIndex;
+		uint32 FileID[2]; // 0 = no file
+		bool bMapped[2];
+	};
+
+	// (File, line) pair, for finding files claimed by more than one line
+	struct FFileClaim
+	{
+		uint32 FileID;
+		int32 TLKID;
+
+		bool operator<(const FFileClaim& Other) const { return FileID != Other.FileID ? FileID < Other.FileID : TLKID < Other.TLKID; }
+		bool operator==(const FFileClaim& Other) const { return FileID == Other.FileID && TLKID == Other.TLKID; }
+	};
+
+	static float ToDecibels(float Linear)
+	{
+		return 20.0f * FMath::LogX(10.0f, FMath::Max(Linear, 1.0e-5f));
+	}
+}
+
+FString FDialogAudioCoverage::GetDefaultReportDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DA2DialogViewer/AudioCoverage"));
+}
+
+bool FDialogAudioCoverage::Run(const FDialogDataManager& DataManager, FDialogAudioCoverageReport& OutReport, const std::atomic<bool>* bCancelled)
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_AudioCoverage);
+
+	using namespace DialogAudioCoverage;
+
+	OutReport = FDialogAudioCoverageReport();
+
+	// One snapshot of the index for the whole pass, so every conversation sees the same files
+	const TSharedPtr<const FAudioFileIndex> Index = DataManager.GetAudioFileIndex();
+	if (!Index.IsValid())
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Audio coverage: the audio directory scan hasn't finished yet, try again in a moment"));
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FString ConversationDirectory = DataManager.GetConversationDirectory();
+	const FString ConversationPrefix = ConversationDirectory + TEXT("/");
+
+	TArray<FString> ConversationFiles;
+	IFileManager::Get().FindFilesRecursive(ConversationFiles, *ConversationDirectory, TEXT("*.xml"), true, false);
+	ConversationFiles.Sort();
+	for (FString& File : ConversationFiles)
+	{
+		FPaths::MakePathRelativeTo(File, *ConversationPrefix);
+	}
+
+	const TMap<int32, FString>& TLKStrings = DataManager.GetTLKStrings();
+	const FAudioMapper& AudioMapper = DataManager.GetAudioMapper();
+
+	TArray<TArray<FLineUse>> ConversationUses;
+	ConversationUses.SetNum(ConversationFiles.Num());
+	std::atomic<int32> NumFailed{0};
+
+	// Conversations are independent: parse, collect the lines, resolve them exactly as playback would
+	ParallelFor(ConversationFiles.Num(), [&](int32 ConversationIndex)
+	{
+		if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		FConversation Conversation;
+		if (!FConversationParser::ParseConversation(FPaths::Combine(ConversationDirectory, ConversationFiles[ConversationIndex]), Conversation))
+		{
+			++NumFailed;
+			return;
+		}
+
+		TArray<FLineUse>& Uses = ConversationUses[ConversationIndex];
+		auto AddUse = [&Uses, ConversationIndex](int32 TLKID, int32 NodeIndex)
+		{
+			if (TLKID > 0)
+			{
+				Uses.Add({TLKID, ConversationIndex, NodeIndex, {0, 0}, {false, false}});
+			}
+		};
+
+		// Node text and link (paraphrase) text, the same lines the tree offers to play
+		for (const FDialogNode& Node : Conversation.Nodes)
+		{
+			AddUse(Node.TLKStringID, Node.NodeIndex);
+			for (const FDialogLink& Link : Node.Links)
+			{
+				AddUse(Link.TLKStringID, Link.TargetNodeIndex);
+			}
+		}
+
+		// A line used several times in one conversation is reported once, at its first node
+		Algo::Sort(Uses, [](const FLineUse& A, const FLineUse& B) { return A.TLKID != B.TLKID ? A.TLKID < B.TLKID : A.NodeIndex < B.NodeIndex; });
+		Uses.SetNum(Algo::Unique(Uses, [](const FLineUse& A, const FLineUse& B) { return A.TLKID == B.TLKID; }));
+
+		TArray<int32> TLKIDs;
+		TArray<uint32> HashedFileIDs;
+		TLKIDs.Reserve(Uses.Num());
+		for (const FLineUse& Use : Uses)
+		{
+			TLKIDs.Add(Use.TLKID);
+		}
+		HashedFileIDs.SetNumUninitialized(TLKIDs.Num());
+
+		for (const EPlayerGender Gender : {EPlayerGender::Male, EPlayerGender::Female})
+		{
+			const uint8 GenderIndex = static_cast<uint8>(Gender);
+			FAudioUtils::ComputeAudioFileIDs(TLKIDs, Gender == EPlayerGender::Male, HashedFileIDs);
+
+			// Same priority as FDialogDataManager::ResolveAudioFilePath: dialog.csv mapping, then the FNV32 hash
+			for (int32 i = 0; i < Uses.Num(); ++i)
+			{
+				uint32 MappedFileID = 0;
+				if (AudioMapper.FindAudioFileID(Uses[i].TLKID, Gender, MappedFileID) && Index->Contains(MappedFileID))
+				{
+					Uses[i].FileID[GenderIndex] = MappedFileID;
+					Uses[i].bMapped[GenderIndex] = true;
+				}
+				else if (Index->Contains(HashedFileIDs[i]))
+				{
+					Uses[i].FileID[GenderIndex] = HashedFileIDs[i];
+				}
+			}
+		}
+	});
+
+	if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+	{
+		UE_LOG(LogDA2Dialog, Log, TEXT("Audio coverage: cancelled"));
+		return false;
+	}
+
+	TArray<FLineUse> AllUses;
+	for (TArray<FLineUse>& Uses : ConversationUses)
+	{
+		AllUses.Append(MoveTemp(Uses));
+	}
+	Algo::Sort(AllUses, [](const FLineUse& A, const FLineUse& B)
+	{
+		return A.TLKID != B.TLKID ? A.TLKID < B.TLKID : A.Conversation < B.Conversation;
+	});
+
+	OutReport.NumConversations = ConversationFiles.Num();
+	OutReport.NumFailedConversations = NumFailed;
+	OutReport.NumFiles = Index->Num();
+
+	// Walk each line's uses; resolution only depends on the TLK ID, so the first use speaks for all of them
+	TArray<FFileClaim> Claims;
+	for (int32 First = 0; First < AllUses.Num();)
+	{
+		int32 End = First + 1;
+		while (End < AllUses.Num() && AllUses[End].TLKID == AllUses[First].TLKID)
+		{
+			++End;
+		}
+
+		const FLineUse& Use = AllUses[First];
+		const FString* Text = TLKStrings.Find(Use.TLKID);
+		if (!Text || Text->IsEmpty())
+		{
+			// Nothing is spoken, so no audio is expected
+			++OutReport.NumLinesWithoutText;
+			First = End;
+			continue;
+		}
+
+		++OutReport.NumLines;
+
+		FDialogAudioCoverageReport::FMissingLine Missing;
+		for (int32 GenderIndex = 0; GenderIndex < 2; ++GenderIndex)
+		{
+			if (Use.FileID[GenderIndex] == 0)
+			{
+				Missing.bMissing[GenderIndex] = true;
+				continue;
+			}
+
+			if (Use.bMapped[GenderIndex])
+			{
+				++OutReport.NumMapped[GenderIndex];
+			}
+			else
+			{
+				++OutReport.NumHashed[GenderIndex];
+			}
+			Claims.Add({Use.FileID[GenderIndex], Use.TLKID});
+		}
+
+		if (Missing.bMissing[0] || Missing.bMissing[1])
+		{
+			Missing.TLKID = Use.TLKID;
+			Missing.NumConversations = End - First;
+			Missing.FirstConversation = ConversationFiles[Use.Conversation];
+			Missing.FirstNodeIndex = Use.NodeIndex;
+			OutReport.MissingLines.Add(MoveTemp(Missing));
+		}
+
+		First = End;
+	}
+
+	// Lines often share one file between genders, so a file is only shared when distinct lines claim it
+	Algo::Sort(Claims);
+	Claims.SetNum(Algo::Unique(Claims));
+
+	TArray<uint32> ClaimedFileIDs;
+	for (int32 First = 0; First < Claims.Num();)
+	{
+		int32 End = First + 1;
+		while (End < Claims.Num() && Claims[End].FileID == Claims[First].FileID)
+		{
+			++End;
+		}
+
+		ClaimedFileIDs.Add(Claims[First].FileID);
+		if (End - First > 1)
+		{
+			FDialogAudioCoverageReport::FSharedFile& Shared = OutReport.SharedFiles.AddDefaulted_GetRef();
+			Shared.FileID = Claims[First].FileID;
+			for (int32 i = First; i < End; ++i)
+			{
+				Shared.TLKIDs.Add(Claims[i].TLKID);
+			}
+		}
+
+		First = End;
+	}
+
+	// Both lists are ascending, so orphans fall out of a single merge
+	const TConstArrayView<uint32> FileIDs = Index->GetFileIDs();
+	for (int32 FileIndex = 0, ClaimIndex = 0; FileIndex < FileIDs.Num(); ++FileIndex)
+	{
+		while (ClaimIndex < ClaimedFileIDs.Num() && ClaimedFileIDs[ClaimIndex] < FileIDs[FileIndex])
+		{
+			++ClaimIndex;
+		}
+		if (ClaimIndex == ClaimedFileIDs.Num() || ClaimedFileIDs[ClaimIndex] != FileIDs[FileIndex])
+		{
+			OutReport.OrphanedFileIDs.Add(FileIDs[FileIndex]);
+		}
+	}
+
+	// Loudness comes from summaries already computed; the audit never decodes audio itself
+	if (const TSharedPtr<FDialogWaveformCache> WaveformCache = DataManager.GetWaveformCache())
+	{
+		for (const uint32 FileID : ClaimedFileIDs)
+		{
+			if (const TSharedPtr<const FDialogWaveformSummary> Summary = WaveformCache->Find(FileID))
+			{
+				OutReport.Loudness.Add({FileID, Summary->Duration, Summary->RMS, Summary->Peak, Summary->NumClippedSamples});
+				OutReport.NumClippedFiles += Summary->IsClipped() ? 1 : 0;
+			}
+		}
+	}
+
+	OutReport.Seconds = FPlatformTime::Seconds() - StartTime;
+	return true;
+}
+
+bool FDialogAudioCoverage::WriteCSV(const FDialogAudioCoverageReport& Report, const FString& Directory)
+{
+	using namespace DialogAudioCoverage;
+
+	IFileManager::Get().MakeDirectory(*Directory, true);
+
+	FString Missing = TEXT("TLKID,MissingMale,MissingFemale,Conversations,FirstConversation,FirstNode\n");
+	for (const FDialogAudioCoverageReport::FMissingLine& Line : Report.MissingLines)
+	{
+		Missing += FString::Printf(TEXT("%d,%d,%d,%d,\"%s\",%d\n"), Line.TLKID, Line.bMissing[0] ? 1 : 0, Line.bMissing[1] ? 1 : 0,
+			Line.NumConversations, *Line.FirstConversation, Line.FirstNodeIndex);
+	}
+
+	FString Shared = TEXT("FileID,Lines,TLKIDs\n");
+	for (const FDialogAudioCoverageReport::FSharedFile& File : Report.SharedFiles)
+	{
+		FString TLKIDs;
+		for (const int32 TLKID : File.TLKIDs)
+		{
+			TLKIDs += TLKIDs.IsEmpty() ? FString::FromInt(TLKID) : TEXT(" ") + FString::FromInt(TLKID);
+		}
+		Shared += FString::Printf(TEXT("%u,%d,%s\n"), File.FileID, File.TLKIDs.Num(), *TLKIDs);
+	}
+
+	FString Orphaned = TEXT("FileID\n");
+	for (const uint32 FileID : Report.OrphanedFileIDs)
+	{
+		Orphaned += FString::Printf(TEXT("%u\n"), FileID);
+	}
+
+	FString Loudness = TEXT("FileID,Duration,RMSdBFS,PeakdBFS,ClippedSamples\n");
+	for (const FDialogAudioCoverageReport::FLoudness& File : Report.Loudness)
+	{
+		Loudness += FString::Printf(TEXT("%u,%.3f,%.1f,%.1f,%u\n"), File.FileID, File.Duration, ToDecibels(File.RMS), ToDecibels(File.Peak), File.NumClippedSamples);
+	}
+
+	const TPair<const TCHAR*, const FString*> Files[] = {
+		{TEXT("Missing.csv"), &Missing},
+		{TEXT("Shared.csv"), &Shared},
+		{TEXT("Orphaned.csv"), &Orphaned},
+		{TEXT("Loudness.csv"), &Loudness},
+	};
+
+	bool bWritten = true;
+	for (const TPair<const TCHAR*, const FString*>& File : Files)
+	{
+		const FString Path = FPaths::Combine(Directory, File.Key);
+		if (!FFileHelper::SaveStringToFile(*File.Value, *Path))
+		{
+			UE_LOG(LogDA2Dialog, Error, TEXT("Audio coverage: failed to write %s"), *Path);
+			bWritten = false;
+		}
+	}
+
+	return bWritten;
+}
+
+void FDialogAudioCoverage::LogSummary(const FDialogAudioCoverageReport& Report)
+{
+	int32 NumMissing[2] = {0, 0};
+	for (const FDialogAudioCoverageReport::FMissingLine& Line : Report.MissingLines)
+	{
+		NumMissing[0] += Line.bMissing[0] ? 1 : 0;
+		NumMissing[1] += Line.bMissing[1] ? 1 : 0;
+	}
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("Audio coverage: %d conversations (%d failed to parse), %d lines with text (%d without) in %.2f s"),
+		Report.NumConversations, Report.NumFailedConversations, Report.NumLines, Report.NumLinesWithoutText, Report.Seconds);
+
+	for (int32 GenderIndex = 0; GenderIndex < 2; ++GenderIndex)
+	{
+		const int32 NumResolved = Report.NumMapped[GenderIndex] + Report.NumHashed[GenderIndex];
+		UE_LOG(LogDA2Dialog, Log, TEXT("  %s: %d resolved (%.1f%%) - %d via dialog.csv, %d via hash - %d missing"),
+			GenderIndex == 0 ? TEXT("Male") : TEXT("Female"), NumResolved, Report.NumLines > 0 ? 100.0 * NumResolved / Report.NumLines : 0.0,
+			Report.NumMapped[GenderIndex], Report.NumHashed[GenderIndex], NumMissing[GenderIndex]);
+	}
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("  Files: %d in the audio directory, %d shared by several lines, %d orphaned"),
+		Report.NumFiles, Report.SharedFiles.Num(), Report.OrphanedFileIDs.Num());
+	UE_LOG(LogDA2Dialog, Log, TEXT("  Loudness: %d files summarized, %d clipped"), Report.Loudness.Num(), Report.NumClippedFiles);
+}
+
+bool FDialogAudioCoverage::RunReport(const FDialogDataManager& DataManager, const std::atomic<bool>* bCancelled)
+{
+	FDialogAudioCoverageReport Report;
+	if (!Run(DataManager, Report, bCancelled))
+	{
+		return false;
+	}
+
+	LogSummary(Report);
+
+	const FString Directory = GetDefaultReportDirectory();
+	if (!WriteCSV(Report, Directory))
+	{
+		return false;
+	}
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("Audio coverage reports written to %s"), *FPaths::ConvertRelativePathToFull(Directory));
+	return true;
+}
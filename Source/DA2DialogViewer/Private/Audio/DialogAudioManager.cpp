@@ -1,33 +1,75 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Audio/DialogAudioManager.h"
+#include "Audio/DialogAudioCache.h"
 #include "Audio/AudioUtils.h"
+#include "Async/Async.h"
 #include "Data/DialogDataManager.h"
-#include "HAL/FileManager.h"
+#include "DA2DialogViewerLog.h"
+
+namespace DialogAudioManager
+{
+	// How often auto-play checks for a finished decode or a handed-over line (a queued line covers anything shorter than its own length)
+	static constexpr float AutoPlayTickInterval = 0.05f;
+}
+
+/**
+ * One auto-play line decoded on a worker thread
+ */
+struct FDialogAutoPlayDecode
+{
+	FString FilePath;
+	TSharedPtr<const FDialogDecodedAudio> Decoded;
+	std::atomic<bool> bDone{false};
+};
 
 FDialogAudioManager::FDialogAudioManager()
 {
 	AudioPlayer = MakeUnique<FDialogAudioPlayer>();
+	AudioCache = MakeShared<FDialogAudioCache>();
 }
 
 FDialogAudioManager::~FDialogAudioManager()
 {
 	StopAudio();
+
+	if (DataManager.IsValid())
+	{
+		DataManager->OnAudioFilesChanged().Remove(AudioFilesChangedHandle);
+	}
 }
 
 void FDialogAudioManager::Initialize(TSharedPtr<FDialogDataManager> InDataManager)
 {
+	if (DataManager.IsValid())
+	{
+		DataManager->OnAudioFilesChanged().Remove(AudioFilesChangedHandle);
+		AudioFilesChangedHandle.Reset();
+	}
+
 	DataManager = InDataManager;
+
+	// Lines re-recorded while the viewer is open must not keep playing their old decoded copy
+	if (DataManager.IsValid())
+	{
+		AudioFilesChangedHandle = DataManager->OnAudioFilesChanged().AddRaw(this, &FDialogAudioManager::OnAudioFilesChanged);
+	}
+
+	// Device setup takes far longer than a click should, so it happens here rather than on the first line played
+	AudioPlayer->Initialize();
 }
 
 bool FDialogAudioManager::PlayDialogAudio(int32 SpokenTLKID, int32 ParaphraseTLKID)
 {
 	if (!DataManager.IsValid())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("DialogAudioManager: No data manager initialized"));
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioManager: No data manager initialized"));
 		return false;
 	}
 
+	// Playing a line by hand takes over from auto-play
+	ResetAutoPlay();
+
 	// Get player gender
 	bool bIsMale = (DataManager->GetPlayerGender() == EPlayerGender::Male);
 
@@ -36,7 +78,7 @@ bool FDialogAudioManager::PlayDialogAudio(int32 SpokenTLKID, int32 ParaphraseTLK
 	{
 		if (TryPlayAudio(SpokenTLKID, bIsMale))
 		{
-			UE_LOG(LogTemp, Log, TEXT("DialogAudioManager: Playing spoken audio for TLK %d"), SpokenTLKID);
+			UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioManager: Playing spoken audio for TLK %d"), SpokenTLKID);
 			return true;
 		}
 	}
@@ -46,18 +88,161 @@ bool FDialogAudioManager::PlayDialogAudio(int32 SpokenTLKID, int32 ParaphraseTLK
 	{
 		if (TryPlayAudio(ParaphraseTLKID, bIsMale))
 		{
-			UE_LOG(LogTemp, Log, TEXT("DialogAudioManager: Playing paraphrase audio for TLK %d (fallback)"), ParaphraseTLKID);
+			UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioManager: Playing paraphrase audio for TLK %d (fallback)"), ParaphraseTLKID);
 			return true;
 		}
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("DialogAudioManager: No audio found for spoken TLK %d or paraphrase TLK %d"),
+	UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioManager: No audio found for spoken TLK %d or paraphrase TLK %d"),
 		SpokenTLKID, ParaphraseTLKID);
 	return false;
 }
 
+void FDialogAudioManager::PrefetchDialogAudio(TConstArrayView<int32> TLKIDs)
+{
+	if (!DataManager.IsValid())
+	{
+		return;
+	}
+
+	// Paths come from the in-memory audio file index, so this is cheap enough for every selection change
+	const EPlayerGender Gender = DataManager->GetPlayerGender();
+	TArray<FString, TInlineAllocator<16>> FilePaths;
+	for (const int32 TLKID : TLKIDs)
+	{
+		FString FilePath = DataManager->ResolveAudioFilePath(TLKID, Gender);
+		if (!FilePath.IsEmpty())
+		{
+			FilePaths.Add(MoveTemp(FilePath));
+		}
+	}
+
+	AudioCache->Prefetch(FilePaths);
+}
+
+bool FDialogAudioManager::StartAutoPlay(TConstArrayView<int32> TLKIDs)
+{
+	StopAudio();
+
+	if (!DataManager.IsValid())
+	{
+		return false;
+	}
+
+	const EPlayerGender Gender = DataManager->GetPlayerGender();
+	for (const int32 TLKID : TLKIDs)
+	{
+		FString FilePath = DataManager->ResolveAudioFilePath(TLKID, Gender);
+		if (!FilePath.IsEmpty())
+		{
+			AutoPlayFiles.Add(MoveTemp(FilePath));
+		}
+	}
+
+	if (AutoPlayFiles.Num() == 0)
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioManager: Auto-play found no audio for %d lines"), TLKIDs.Num());
+		return false;
+	}
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioManager: Auto-playing %d of %d lines"), AutoPlayFiles.Num(), TLKIDs.Num());
+
+	AutoPlayTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FDialogAudioManager::TickAutoPlay), DialogAudioManager::AutoPlayTickInterval);
+	TickAutoPlay(0.0f);
+	return true;
+}
+
+void FDialogAudioManager::StopAutoPlay()
+{
+	if (IsAutoPlaying())
+	{
+		ResetAutoPlay();
+		AudioPlayer->StopAudio();
+	}
+}
+
+void FDialogAudioManager::ResetAutoPlay()
+{
+	if (AutoPlayTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(AutoPlayTickerHandle);
+		AutoPlayTickerHandle.Reset();
+	}
+
+	// A decode still running finishes into a request nobody reads
+	PendingDecode.Reset();
+	AutoPlayFiles.Reset();
+	NextAutoPlayFile = 0;
+}
+
+void FDialogAudioManager::OnAudioFilesChanged(TConstArrayView<uint32> FileIDs)
+{
+	if (FileIDs.Num() == 0)
+	{
+		AudioCache->Empty();
+		return;
+	}
+
+	// Cache entries are keyed by the same paths ResolveAudioFilePath builds
+	const FString AudioDirectory = DataManager->GetAudioDirectory();
+	for (const uint32 FileID : FileIDs)
+	{
+		AudioCache->Remove(FAudioUtils::BuildAudioFilePath(AudioDirectory, FileID));
+	}
+}
+
+bool FDialogAudioManager::TickAutoPlay(float DeltaTime)
+{
+	AudioPlayer->Update();
+
+	// Decoded line ready: chain it behind the playing one (or start it, if nothing is playing yet)
+	if (PendingDecode.IsValid() && PendingDecode->bDone.load(std::memory_order_acquire))
+	{
+		if (!PendingDecode->Decoded.IsValid())
+		{
+			UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioManager: Auto-play skipping unreadable file: %s"), *PendingDecode->FilePath);
+		}
+		else if (!AudioPlayer->QueueDecoded(PendingDecode->FilePath, PendingDecode->Decoded))
+		{
+			UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioManager: Auto-play could not queue %s"), *PendingDecode->FilePath);
+		}
+		PendingDecode.Reset();
+	}
+
+	// The queue slot is free once the queued line has started, decode the next one while this one plays
+	if (!PendingDecode.IsValid() && !AudioPlayer->HasQueuedAudio() && AutoPlayFiles.IsValidIndex(NextAutoPlayFile))
+	{
+		TSharedPtr<FDialogAutoPlayDecode> Request = MakeShared<FDialogAutoPlayDecode>();
+		Request->FilePath = AutoPlayFiles[NextAutoPlayFile++];
+		PendingDecode = Request;
+
+		TSharedPtr<FDialogAudioCache> Cache = AudioCache;
+		Async(EAsyncExecution::ThreadPool, [Request, Cache]()
+		{
+			Request->Decoded = Cache->FindOrDecode(Request->FilePath);
+			Request->bDone.store(true, std::memory_order_release);
+		});
+	}
+
+	// Sequence done once the last line has finished
+	if (!PendingDecode.IsValid() && !AutoPlayFiles.IsValidIndex(NextAutoPlayFile) && !AudioPlayer->IsPlaying())
+	{
+		UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioManager: Auto-play finished"));
+		AutoPlayTickerHandle.Reset();
+		PendingDecode.Reset();
+		AutoPlayFiles.Reset();
+		NextAutoPlayFile = 0;
+		return false;
+	}
+
+	return true;
+}
+
 void FDialogAudioManager::StopAudio()
 {
+	ResetAutoPlay();
+
 	if (AudioPlayer.IsValid())
 	{
 		AudioPlayer->StopAudio();
@@ -79,28 +264,24 @@ void FDialogAudioManager::SetVolume(float Volume)
 
 bool FDialogAudioManager::TryPlayAudio(int32 TLKID, bool bIsMale)
 {
-	// Try audio mapper first (uses dialog.csv)
-	FString AudioDir = DataManager->GetAudioDirectory();
-	FString AudioFilePath = DataManager->GetAudioMapper().GetAudioFilePath(TLKID,
-		bIsMale ? EPlayerGender::Male : EPlayerGender::Female, AudioDir);
-
-	if (!AudioFilePath.IsEmpty() && IFileManager::Get().FileExists(*AudioFilePath))
+	// Mapper then FNV32 hash, resolved against the in-memory audio file index
+	const FString AudioFilePath = DataManager->ResolveAudioFilePath(TLKID, bIsMale ? EPlayerGender::Male : EPlayerGender::Female);
+	if (AudioFilePath.IsEmpty())
 	{
-		// Found via audio mapper
-		return AudioPlayer->PlayAudio(AudioFilePath);
+		return false;
 	}
 
-	// Fallback: Try FNV32 hash
-	uint32 AudioFileID = FAudioUtils::ComputeAudioFileID(TLKID, bIsMale);
-	FString FNVPath = FAudioUtils::BuildAudioFilePath(AudioDir, AudioFileID);
+	if (TSharedPtr<const FDialogDecodedAudio> Decoded = AudioCache->Find(AudioFilePath))
+	{
+		return AudioPlayer->PlayDecoded(AudioFilePath, MoveTemp(Decoded));
+	}
 
-	if (IFileManager::Get().FileExists(*FNVPath))
+	// Stream this play from disk and decode a copy in the background, so replaying the line is instant
+	if (!AudioPlayer->PlayAudio(AudioFilePath))
 	{
-		// Found via FNV32 hash
-		UE_LOG(LogTemp, Log, TEXT("DialogAudioManager: Using FNV32 fallback for TLK %d -> %u"), TLKID, AudioFileID);
-		return AudioPlayer->PlayAudio(FNVPath);
+		return false;
 	}
 
-	// Not found
-	return false;
+	AudioCache->Prefetch(MakeArrayView(&AudioFilePath, 1));
+	return true;
 }
\ No newline at end of file
@@ -1,13 +1,468 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Audio/DialogAudioPlayer.h"
-#include "HAL/FileManager.h"
+#include "Audio/DialogWavReader.h"
+#include "Audio/DialogAudioCache.h"
+#include "AudioMixer.h"
+#include "AudioDevice.h"
+#include "AudioDeviceManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Misc/ScopeLock.h"
+#include "DA2DialogViewerLog.h"
+#include <atomic>
 
-#include "Windows/AllowWindowsPlatformTypes.h"
-#include <mmsystem.h>
-#include "Windows/HideWindowsPlatformTypes.h"
+namespace DialogAudio
+{
+	// Frames per device callback and callbacks queued; about 10 ms of output latency at 48 kHz
+	static constexpr uint32 CallbackFrames = 256;
+	static constexpr uint32 NumOutputBuffers = 2;
+
+	// Rate requested from the device (it may choose another, voices resample to whatever it picks)
+	static constexpr uint32 RequestedSampleRate = 48000;
+
+	// Source frames buffered per voice (~370 ms at 44.1 kHz), refilled when half empty
+	static constexpr int32 RingFrames = 16384;
+
+	// Source frames decoded before a voice starts, so the first callback after PlayAudio already has samples
+	static constexpr int32 PrimeFrames = 4096;
+
+	// Longest the streaming thread sleeps when no voice asks for data
+	static constexpr uint32 StreamerIntervalMs = 10;
+}
+
+/**
+ * One playing line: a ring of decoded source frames, filled by the streaming thread and drained by the mixer
+ */
+struct FDialogAudioVoice
+{
+	// File being played
+	FString FilePath;
+
+	// Source reader, only touched by the streaming thread once the voice is playing
+	FDialogWavReader Reader;
+
+	// Source format
+	int32 NumChannels = 0;
+	int32 SampleRate = 0;
+	int64 NumFrames = 0;
+
+	// Interleaved source frames, RingFrames long (unused when playing a decoded line)
+	TArray<float> Ring;
+
+	// Whole line decoded in memory, played in place instead of streaming through the ring
+	TSharedPtr<const FDialogDecodedAudio> Decoded;
+
+	// What the mixer reads: the ring or the decoded samples (whose length then stands in for the ring size)
+	const float* Samples = nullptr;
+	uint64 BufferFrames = DialogAudio::RingFrames;
+
+	// Frame counters: the streamer writes up to FramesWritten, the mixer has finished with everything before FramesConsumed
+	std::atomic<uint64> FramesWritten{0};
+	std::atomic<uint64> FramesConsumed{0};
+
+	// No more frames will be written
+	std::atomic<bool> bSourceDone{false};
+
+	// Stop requested by the game thread (the mixer fades out over one callback, then finishes)
+	std::atomic<bool> bStopRequested{false};
+
+	// Mixer produced the last sample, the streamer can release the voice
+	std::atomic<bool> bFinished{false};
+
+	// Mixer has started playing the voice
+	std::atomic<bool> bStarted{false};
+
+	// Line to start on the sample after this one ends (only touched under the output's voices lock)
+	TSharedPtr<FDialogAudioVoice> NextVoice;
+
+	// Volume the mixer ramps towards
+	std::atomic<float> TargetVolume{1.0f};
+
+	// Mixer thread state: fractional source position and the gain reached so far
+	double ReadPosition = 0.0;
+	float CurrentGain = 1.0f;
+
+	// Decode up to MaxFrames into free ring space (streaming thread, or the game thread before the voice starts)
+	void Fill(int32 MaxFrames);
+};
+
+void FDialogAudioVoice::Fill(int32 MaxFrames)
+{
+	if (bSourceDone.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	uint64 Written = FramesWritten.load(std::memory_order_relaxed);
+	const uint64 Consumed = FramesConsumed.load(std::memory_order_acquire);
+	int32 FramesToWrite = FMath::Min<int32>(MaxFrames, DialogAudio::RingFrames - static_cast<int32>(Written - Consumed));
+
+	while (FramesToWrite > 0)
+	{
+		// Up to the end of the ring, then wrap
+		const int32 RingOffset = static_cast<int32>(Written % DialogAudio::RingFrames);
+		const int32 Contiguous = FMath::Min(FramesToWrite, DialogAudio::RingFrames - RingOffset);
+		const int32 FramesRead = Reader.ReadFrames(Ring.GetData() + RingOffset * NumChannels, Contiguous);
 
-#pragma comment(lib, "Winmm.lib")
+		Written += FramesRead;
+		FramesWritten.store(Written, std::memory_order_release);
+		FramesToWrite -= FramesRead;
+
+		if (FramesRead < Contiguous || Reader.GetFramesRemaining() == 0)
+		{
+			// Published after the last frames, the mixer reads this flag before FramesWritten
+			Reader.Close();
+			bSourceDone.store(true, std::memory_order_release);
+			return;
+		}
+	}
+}
+
+namespace DialogAudio
+{
+	// Voice over a line decoded in memory: every frame is already written, so the streaming thread never touches it
+	static TSharedPtr<FDialogAudioVoice> MakeDecodedVoice(const FString& FilePath, TSharedPtr<const FDialogDecodedAudio> Decoded)
+	{
+		TSharedPtr<FDialogAudioVoice> Voice = MakeShared<FDialogAudioVoice>();
+		Voice->FilePath = FilePath;
+		Voice->NumChannels = Decoded->Format.NumChannels;
+		Voice->SampleRate = Decoded->Format.SampleRate;
+		Voice->NumFrames = Decoded->GetNumFrames();
+		Voice->Samples = Decoded->Samples.GetData();
+		Voice->BufferFrames = Voice->NumFrames;
+		Voice->FramesWritten = Voice->NumFrames;
+		Voice->bSourceDone = true;
+		Voice->Decoded = MoveTemp(Decoded);
+		return Voice;
+	}
+}
+
+/**
+ * Output device plus a small mixer over the playing voices
+ * The platform layer calls OnProcessAudioStream on its render thread, a streaming thread keeps the voices' rings topped up
+ */
+class FDialogAudioOutput : public Audio::IAudioMixer, public FRunnable
+{
+public:
+	~FDialogAudioOutput();
+
+	// Open the default output device and start the streaming thread
+	bool Initialize();
+
+	// Start mixing a primed voice
+	void AddVoice(TSharedPtr<FDialogAudioVoice> Voice);
+
+	// Start a fully decoded voice the moment Previous ends, false if Previous has already ended or was stopped
+	bool ChainVoice(const TSharedPtr<FDialogAudioVoice>& Previous, TSharedPtr<FDialogAudioVoice> Voice);
+
+	// Output rate voices are resampled to
+	int32 GetSampleRate() const { return OutputSampleRate; }
+
+	// The platform closed the stream (device unplugged or reset), nothing will be mixed any more
+	bool IsStreamLost() const { return bStreamLost.load(std::memory_order_relaxed); }
+
+	//~ Audio::IAudioMixer (device render thread)
+	virtual bool OnProcessAudioStream(Audio::FAlignedFloatBuffer& OutputBuffer) override;
+	virtual void OnAudioStreamShutdown() override;
+
+	//~ FRunnable (streaming thread)
+	virtual uint32 Run() override;
+
+private:
+	// Mix one voice into the interleaved output, returns true if it wants more source frames
+	// OutFramesMixed is how far into the output the voice got before it ran out
+	bool MixVoice(FDialogAudioVoice& Voice, float* Output, int32 NumOutputFrames, int32& OutFramesMixed);
+
+	// Platform output stream
+	TUniquePtr<Audio::IAudioMixerPlatformInterface> Platform;
+
+	// Device format
+	int32 OutputSampleRate = DialogAudio::RequestedSampleRate;
+	int32 OutputChannels = 2;
+
+	// Voices being mixed (shared between the render and streaming threads)
+	TArray<TSharedPtr<FDialogAudioVoice>> Voices;
+	FCriticalSection VoicesLock;
+
+	// Streaming thread and its wake-up (triggered by the mixer when a voice runs low)
+	FRunnableThread* StreamerThread = nullptr;
+	FEvent* StreamerEvent = nullptr;
+	std::atomic<bool> bShuttingDown{false};
+
+	// Set when the platform shuts the stream down
+	std::atomic<bool> bStreamLost{false};
+};
+
+FDialogAudioOutput::~FDialogAudioOutput()
+{
+	if (Platform.IsValid())
+	{
+		Platform->StopAudioStream();
+		Platform->CloseAudioStream();
+		Platform->TeardownHardware();
+		Platform.Reset();
+	}
+
+	if (StreamerThread)
+	{
+		bShuttingDown = true;
+		StreamerEvent->Trigger();
+		StreamerThread->WaitForCompletion();
+		delete StreamerThread;
+		StreamerThread = nullptr;
+	}
+
+	if (StreamerEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(StreamerEvent);
+		StreamerEvent = nullptr;
+	}
+}
+
+bool FDialogAudioOutput::Initialize()
+{
+	// Same platform backend the editor's own audio device uses (XAudio2, CoreAudio, SDL...)
+	FAudioDeviceManager* DeviceManager = FAudioDeviceManager::Get();
+	IAudioDeviceModule* DeviceModule = DeviceManager ? DeviceManager->GetAudioDeviceModule() : nullptr;
+	if (!DeviceModule || !DeviceModule->IsAudioMixerModule())
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioPlayer: No audio mixer backend available (is audio disabled?)"));
+		return false;
+	}
+
+	Platform.Reset(DeviceModule->CreateAudioMixerPlatformInterface());
+	if (!Platform.IsValid() || !Platform->InitializeHardware())
+	{
+		UE_LOG(LogDA2Dialog, Error, TEXT("DialogAudioPlayer: Failed to initialize audio hardware"));
+		Platform.Reset();
+		return false;
+	}
+
+	Audio::FAudioMixerOpenStreamParams StreamParams;
+	StreamParams.OutputDeviceIndex = AUDIO_MIXER_DEFAULT_DEVICE_INDEX;
+	StreamParams.NumFrames = DialogAudio::CallbackFrames;
+	StreamParams.NumBuffers = DialogAudio::NumOutputBuffers;
+	StreamParams.SampleRate = DialogAudio::RequestedSampleRate;
+	StreamParams.AudioMixer = this;
+
+	if (!Platform->OpenAudioStream(StreamParams))
+	{
+		UE_LOG(LogDA2Dialog, Error, TEXT("DialogAudioPlayer: Failed to open audio output stream"));
+		Platform->TeardownHardware();
+		Platform.Reset();
+		return false;
+	}
+
+	const Audio::FAudioPlatformDeviceInfo DeviceInfo = Platform->GetPlatformDeviceInfo();
+	OutputSampleRate = DeviceInfo.SampleRate;
+	OutputChannels = FMath::Max(DeviceInfo.NumChannels, 1);
+
+	StreamerEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	StreamerThread = FRunnableThread::Create(this, TEXT("DA2DialogAudioStreamer"), 0, TPri_AboveNormal);
+
+	if (!Platform->StartAudioStream())
+	{
+		UE_LOG(LogDA2Dialog, Error, TEXT("DialogAudioPlayer: Failed to start audio output stream"));
+		return false;
+	}
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioPlayer: Opened audio output (%d Hz, %d channels, %u-frame buffers)"),
+		OutputSampleRate, OutputChannels, DialogAudio::CallbackFrames);
+	return true;
+}
+
+void FDialogAudioOutput::AddVoice(TSharedPtr<FDialogAudioVoice> Voice)
+{
+	{
+		FScopeLock Lock(&VoicesLock);
+		Voices.Add(MoveTemp(Voice));
+	}
+
+	StreamerEvent->Trigger();
+}
+
+bool FDialogAudioOutput::ChainVoice(const TSharedPtr<FDialogAudioVoice>& Previous, TSharedPtr<FDialogAudioVoice> Voice)
+{
+	// The mixer sets bFinished under this lock, so a voice that hasn't finished here will still hand over
+	FScopeLock Lock(&VoicesLock);
+	if (!Previous.IsValid() || Previous->bFinished || Previous->bStopRequested || Previous->NextVoice.IsValid())
+	{
+		return false;
+	}
+
+	Previous->NextVoice = MoveTemp(Voice);
+
+	// The mixer appends every chained voice when it hands over, make room now so the render thread never allocates
+	int32 NumChained = 0;
+	for (const TSharedPtr<FDialogAudioVoice>& Playing : Voices)
+	{
+		for (const FDialogAudioVoice* Chained = Playing->NextVoice.Get(); Chained; Chained = Chained->NextVoice.Get())
+		{
+			++NumChained;
+		}
+	}
+	Voices.Reserve(Voices.Num() + NumChained);
+	return true;
+}
+
+bool FDialogAudioOutput::OnProcessAudioStream(Audio::FAlignedFloatBuffer& OutputBuffer)
+{
+	float* Output = OutputBuffer.GetData();
+	FMemory::Memzero(Output, OutputBuffer.Num() * sizeof(float));
+	const int32 NumOutputFrames = OutputBuffer.Num() / OutputChannels;
+
+	bool bWantsData = false;
+	{
+		FScopeLock Lock(&VoicesLock);
+
+		// Voices chained in below are appended, and already mixed for this callback
+		const int32 NumVoices = Voices.Num();
+		for (int32 VoiceIndex = 0; VoiceIndex < NumVoices; ++VoiceIndex)
+		{
+			FDialogAudioVoice* Voice = Voices[VoiceIndex].Get();
+			int32 FramesMixed = 0;
+			bWantsData |= MixVoice(*Voice, Output, NumOutputFrames, FramesMixed);
+
+			// A line that ran out on its own hands the rest of the callback to the line queued behind it, so there is no gap
+			while (Voice->bFinished && !Voice->bStopRequested && Voice->NextVoice.IsValid())
+			{
+				TSharedPtr<FDialogAudioVoice> Next = MoveTemp(Voice->NextVoice);
+				Voice->NextVoice.Reset();
+				Voices.Add(Next); // Capacity reserved by ChainVoice
+				Voice = Next.Get();
+
+				int32 NextFramesMixed = 0;
+				bWantsData |= MixVoice(*Voice, Output + FramesMixed * OutputChannels, NumOutputFrames - FramesMixed, NextFramesMixed);
+				FramesMixed += NextFramesMixed;
+			}
+		}
+	}
+
+	if (bWantsData)
+	{
+		StreamerEvent->Trigger();
+	}
+
+	return true;
+}
+
+void FDialogAudioOutput::OnAudioStreamShutdown()
+{
+	bStreamLost = true;
+	UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioPlayer: Audio output stream shut down"));
+}
+
+bool FDialogAudioOutput::MixVoice(FDialogAudioVoice& Voice, float* Output, int32 NumOutputFrames, int32& OutFramesMixed)
+{
+	OutFramesMixed = 0;
+	if (Voice.bFinished.load(std::memory_order_relaxed) || NumOutputFrames <= 0)
+	{
+		return false;
+	}
+
+	Voice.bStarted.store(true, std::memory_order_relaxed);
+
+	// Ramp gain across the callback so volume changes and stops don't click
+	const bool bStopping = Voice.bStopRequested.load(std::memory_order_relaxed);
+	const float TargetGain = bStopping ? 0.0f : Voice.TargetVolume.load(std::memory_order_relaxed);
+	const float GainStep = (TargetGain - Voice.CurrentGain) / NumOutputFrames;
+
+	// Source-done first, so FramesWritten is final when it is set
+	const bool bSourceDone = Voice.bSourceDone.load(std::memory_order_acquire);
+	const uint64 Available = Voice.FramesWritten.load(std::memory_order_acquire);
+
+	const double Step = static_cast<double>(Voice.SampleRate) / OutputSampleRate;
+	const float* Ring = Voice.Samples;
+	const uint64 BufferFrames = Voice.BufferFrames;
+	const int32 SourceChannels = Voice.NumChannels;
+
+	for (int32 Frame = 0; Frame < NumOutputFrames; ++Frame)
+	{
+		const uint64 Index = static_cast<uint64>(Voice.ReadPosition);
+		const bool bHasNext = Index + 1 < Available;
+
+		// Out of data: the line ended, or the streamer fell behind (silence until it catches up)
+		if (Index >= Available || (!bHasNext && !bSourceDone))
+		{
+			if (bSourceDone)
+			{
+				Voice.bFinished = true;
+			}
+			break;
+		}
+
+		// Linear interpolation to the output rate (the last frame of a line holds)
+		const float Alpha = static_cast<float>(Voice.ReadPosition - static_cast<double>(Index));
+		const float* Current = Ring + (Index % BufferFrames) * SourceChannels;
+		const float* Next = bHasNext ? Ring + ((Index + 1) % BufferFrames) * SourceChannels : Current;
+
+		Voice.CurrentGain += GainStep;
+		const float Left = FMath::Lerp(Current[0], Next[0], Alpha) * Voice.CurrentGain;
+		const float Right = SourceChannels > 1 ? FMath::Lerp(Current[1], Next[1], Alpha) * Voice.CurrentGain : Left;
+
+		// Mono lines go to both front speakers
+		float* OutputFrame = Output + Frame * OutputChannels;
+		OutputFrame[0] += Left;
+		if (OutputChannels > 1)
+		{
+			OutputFrame[1] += Right;
+		}
+
+		Voice.ReadPosition += Step;
+		++OutFramesMixed;
+	}
+
+	const uint64 Consumed = FMath::Min(static_cast<uint64>(Voice.ReadPosition), Available);
+	Voice.FramesConsumed.store(Consumed, std::memory_order_release);
+
+	// Faded out
+	if (bStopping)
+	{
+		Voice.bFinished = true;
+		return false;
+	}
+
+	return !bSourceDone && Available - Consumed < static_cast<uint64>(DialogAudio::RingFrames / 2);
+}
+
+uint32 FDialogAudioOutput::Run()
+{
+	TArray<TSharedPtr<FDialogAudioVoice>> ActiveVoices;
+	TArray<TSharedPtr<FDialogAudioVoice>> FinishedVoices;
+
+	while (!bShuttingDown)
+	{
+		StreamerEvent->Wait(DialogAudio::StreamerIntervalMs);
+
+		{
+			FScopeLock Lock(&VoicesLock);
+			for (int32 VoiceIndex = Voices.Num() - 1; VoiceIndex >= 0; --VoiceIndex)
+			{
+				// A finished voice stays until the mixer has handed over to the line chained behind it
+				const FDialogAudioVoice& Voice = *Voices[VoiceIndex];
+				if (Voice.bFinished && (!Voice.NextVoice.IsValid() || Voice.bStopRequested))
+				{
+					FinishedVoices.Add(Voices[VoiceIndex]);
+					Voices.RemoveAtSwap(VoiceIndex, 1, EAllowShrinking::No);
+				}
+			}
+			ActiveVoices = Voices;
+		}
+
+		// Files are closed and rings freed outside the lock, so the render thread never waits on them
+		FinishedVoices.Reset();
+
+		for (const TSharedPtr<FDialogAudioVoice>& Voice : ActiveVoices)
+		{
+			Voice->Fill(DialogAudio::RingFrames);
+		}
+		ActiveVoices.Reset();
+	}
+
+	return 0;
+}
 
 FDialogAudioPlayer::FDialogAudioPlayer()
 	: CurrentVolume(1.0f)
@@ -17,6 +472,36 @@ FDialogAudioPlayer::FDialogAudioPlayer()
 FDialogAudioPlayer::~FDialogAudioPlayer()
 {
 	StopAudio();
+	Output.Reset();
+}
+
+bool FDialogAudioPlayer::Initialize()
+{
+	return EnsureOutput();
+}
+
+bool FDialogAudioPlayer::EnsureOutput()
+{
+	if (Output.IsValid() && !Output->IsStreamLost())
+	{
+		return true;
+	}
+
+	if (Output.IsValid())
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioPlayer: Audio output was lost, reopening it"));
+		StopAudio();
+		Output.Reset();
+	}
+
+	Output = MakeUnique<FDialogAudioOutput>();
+	if (!Output->Initialize())
+	{
+		Output.Reset();
+		return false;
+	}
+
+	return true;
 }
 
 bool FDialogAudioPlayer::PlayAudio(const FString& AudioFilePath)
@@ -24,56 +509,167 @@ bool FDialogAudioPlayer::PlayAudio(const FString& AudioFilePath)
 	// Stop any currently playing audio
 	StopAudio();
 
-	// Check if file exists
-	if (!IFileManager::Get().FileExists(*AudioFilePath))
+	// Callers resolve paths against the audio file index, a missing file fails in Open below
+	if (!EnsureOutput())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("DialogAudioPlayer: Audio file not found: %s"), *AudioFilePath);
+		UE_LOG(LogDA2Dialog, Error, TEXT("DialogAudioPlayer: No audio output, cannot play: %s"), *AudioFilePath);
 		return false;
 	}
 
-	CurrentAudioFile = AudioFilePath;
+	TSharedPtr<FDialogAudioVoice> Voice = MakeShared<FDialogAudioVoice>();
+	if (!Voice->Reader.Open(AudioFilePath))
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DialogAudioPlayer: Audio file missing or not a supported WAV: %s"), *AudioFilePath);
+		return false;
+	}
 
-	// Use Windows PlaySound API - simple, works with raw WAV files, no cooking needed
-	// SND_ASYNC = play asynchronously
-	// SND_FILENAME = first param is a filename, not an alias
-	BOOL Result = PlaySoundW(*AudioFilePath, nullptr, SND_ASYNC | SND_FILENAME);
+	const FDialogWavFormat& Format = Voice->Reader.GetFormat();
+	Voice->FilePath = AudioFilePath;
+	Voice->NumChannels = Format.NumChannels;
+	Voice->SampleRate = Format.SampleRate;
+	Voice->NumFrames = Format.GetNumFrames();
 
-	if (Result)
+	// Float files stream through the ring too: reading the mapping from the device callback could fault pages in from disk
+	// while the voices lock is held, the streaming thread touches the mapping instead
+	Voice->Ring.SetNumZeroed(DialogAudio::RingFrames * Format.NumChannels);
+	Voice->Samples = Voice->Ring.GetData();
+
+	// Decode the start here so the next device callback can play it, the streaming thread takes over from there
+	Voice->Fill(DialogAudio::PrimeFrames);
+
+	StartVoice(AudioFilePath, Voice);
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioPlayer: Playing audio: %s (%d Hz, %d channels, %.2f s)"),
+		*AudioFilePath, Format.SampleRate, Format.NumChannels, Format.GetDuration());
+	return true;
+}
+
+bool FDialogAudioPlayer::PlayDecoded(const FString& AudioFilePath, TSharedPtr<const FDialogDecodedAudio> Decoded)
+{
+	StopAudio();
+
+	if (!Decoded.IsValid() || Decoded->GetNumFrames() <= 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("DialogAudioPlayer: Playing audio: %s"), *AudioFilePath);
-		return true;
+		return false;
 	}
-	else
+
+	if (!EnsureOutput())
 	{
-		UE_LOG(LogTemp, Error, TEXT("DialogAudioPlayer: Windows PlaySound failed for: %s"), *AudioFilePath);
-		CurrentAudioFile.Empty();
+		UE_LOG(LogDA2Dialog, Error, TEXT("DialogAudioPlayer: No audio output, cannot play: %s"), *AudioFilePath);
 		return false;
 	}
+
+	TSharedPtr<FDialogAudioVoice> Voice = DialogAudio::MakeDecodedVoice(AudioFilePath, MoveTemp(Decoded));
+	StartVoice(AudioFilePath, Voice);
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioPlayer: Playing cached audio: %s (%d Hz, %d channels, %.2f s)"),
+		*AudioFilePath, Voice->SampleRate, Voice->NumChannels, static_cast<float>(Voice->NumFrames) / Voice->SampleRate);
+	return true;
+}
+
+bool FDialogAudioPlayer::QueueDecoded(const FString& AudioFilePath, TSharedPtr<const FDialogDecodedAudio> Decoded)
+{
+	if (!Decoded.IsValid() || Decoded->GetNumFrames() <= 0 || QueuedVoice.IsValid())
+	{
+		return false;
+	}
+
+	TSharedPtr<FDialogAudioVoice> Voice = DialogAudio::MakeDecodedVoice(AudioFilePath, Decoded);
+	Voice->TargetVolume = CurrentVolume;
+	Voice->CurrentGain = CurrentVolume;
+
+	// Too late to chain (nothing playing, or the line just ended): start it now, with whatever gap that leaves
+	if (!Output.IsValid() || !Output->ChainVoice(CurrentVoice, Voice))
+	{
+		return PlayDecoded(AudioFilePath, MoveTemp(Decoded));
+	}
+
+	QueuedVoice = MoveTemp(Voice);
+	QueuedAudioFile = AudioFilePath;
+	return true;
+}
+
+void FDialogAudioPlayer::Update()
+{
+	if (QueuedVoice.IsValid() && QueuedVoice->bStarted.load(std::memory_order_relaxed))
+	{
+		CurrentVoice = MoveTemp(QueuedVoice);
+		CurrentAudioFile = MoveTemp(QueuedAudioFile);
+		QueuedVoice.Reset();
+		QueuedAudioFile.Empty();
+
+		UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioPlayer: Playing queued audio: %s"), *CurrentAudioFile);
+	}
+}
+
+void FDialogAudioPlayer::StartVoice(const FString& AudioFilePath, TSharedPtr<FDialogAudioVoice> Voice)
+{
+	Voice->TargetVolume = CurrentVolume;
+	Voice->CurrentGain = CurrentVolume;
+
+	Output->AddVoice(Voice);
+	CurrentVoice = MoveTemp(Voice);
+	CurrentAudioFile = AudioFilePath;
 }
 
 void FDialogAudioPlayer::StopAudio()
 {
-	if (!CurrentAudioFile.IsEmpty())
+	// A queued line may already have been handed over by the mixer, stop it either way
+	if (QueuedVoice.IsValid())
 	{
-		// Stop Windows PlaySound
-		PlaySoundW(nullptr, nullptr, 0);
-		UE_LOG(LogTemp, Log, TEXT("DialogAudioPlayer: Stopped audio: %s"), *CurrentAudioFile);
+		QueuedVoice->bStopRequested = true;
+		QueuedVoice.Reset();
+		QueuedAudioFile.Empty();
+	}
+
+	if (CurrentVoice.IsValid())
+	{
+		// The mixer fades the voice out and the streaming thread releases it
+		CurrentVoice->bStopRequested = true;
+		CurrentVoice.Reset();
+
+		UE_LOG(LogDA2Dialog, Log, TEXT("DialogAudioPlayer: Stopped audio: %s"), *CurrentAudioFile);
 		CurrentAudioFile.Empty();
 	}
 }
 
 bool FDialogAudioPlayer::IsPlaying() const
 {
-	// Windows PlaySound doesn't provide a direct way to query playback status
-	// We'll just track if we have a current file playing
-	return !CurrentAudioFile.IsEmpty();
+	// A queued line counts, it takes over as soon as the current one ends
+	return QueuedVoice.IsValid() || (CurrentVoice.IsValid() && !CurrentVoice->bFinished.load(std::memory_order_relaxed));
 }
 
 void FDialogAudioPlayer::SetVolume(float Volume)
 {
 	CurrentVolume = FMath::Clamp(Volume, 0.0f, 1.0f);
 
-	// Note: Windows PlaySound doesn't support volume control per-sound
-	// Volume is controlled by system mixer
-	// If volume control is needed, would need to use waveOut API instead
+	if (CurrentVoice.IsValid())
+	{
+		CurrentVoice->TargetVolume = CurrentVolume;
+	}
+
+	if (QueuedVoice.IsValid())
+	{
+		QueuedVoice->TargetVolume = CurrentVolume;
+	}
+}
+
+float FDialogAudioPlayer::GetPlaybackTime() const
+{
+	if (!CurrentVoice.IsValid() || CurrentVoice->SampleRate <= 0)
+	{
+		return 0.0f;
+	}
+
+	return static_cast<float>(CurrentVoice->FramesConsumed.load(std::memory_order_relaxed)) / CurrentVoice->SampleRate;
+}
+
+float FDialogAudioPlayer::GetDuration() const
+{
+	if (!CurrentVoice.IsValid() || CurrentVoice->SampleRate <= 0)
+	{
+		return 0.0f;
+	}
+
+	return static_cast<float>(CurrentVoice->NumFrames) / CurrentVoice->SampleRate;
 }
@@ -0,0 +1,223 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Audio/DialogWavReader.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "DA2DialogViewerLog.h"
+
+namespace DialogWavReader
+{
+	static constexpr uint16 FormatPCM = 1;
+	static constexpr uint16 FormatFloat = 3;
+	static constexpr uint16 FormatExtensible = 0xFFFE;
+
+	static uint16 ReadU16(const uint8* Data)
+	{
+		return static_cast<uint16>(Data[0] | (Data[1] << 8));
+	}
+
+	static uint32 ReadU32(const uint8* Data)
+	{
+		return static_cast<uint32>(Data[0]) | (static_cast<uint32>(Data[1]) << 8) | (static_cast<uint32>(Data[2]) << 16) | (static_cast<uint32>(Data[3]) << 24);
+	}
+}
+
+FDialogWavReader::FDialogWavReader()
+{
+}
+
+FDialogWavReader::~FDialogWavReader()
+{
+	Close();
+}
+
+bool FDialogWavReader::Open(const FString& FilePath)
+{
+	Close();
+
+	// Map the file so headers and samples are read in place from the page cache
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion());
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		FileData = MappedRegion->GetMappedPtr();
+		FileSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Platforms without file mapping (and empty files) read the whole file instead
+		MappedRegion.Reset();
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(LoadedData, *FilePath, FILEREAD_Silent))
+		{
+			return false;
+		}
+
+		FileData = LoadedData.GetData();
+		FileSize = LoadedData.Num();
+	}
+
+	if (!FileData || !ReadHeader())
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DialogWavReader: Unsupported or corrupt WAV file: %s"), *FilePath);
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FDialogWavReader::Close()
+{
+	// Region before the handle it was mapped from
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedData.Empty();
+	FileData = nullptr;
+	FileSize = 0;
+	Format = FDialogWavFormat();
+	FramesRead = 0;
+}
+
+bool FDialogWavReader::ReadHeader()
+{
+	using namespace DialogWavReader;
+
+	if (FileSize < 12 || FMemory::Memcmp(FileData, "RIFF", 4) != 0 || FMemory::Memcmp(FileData + 8, "WAVE", 4) != 0)
+	{
+		return false;
+	}
+
+	bool bHasFormat = false;
+
+	// Chunks are word aligned; fmt must come before data
+	int64 ChunkOffset = 12;
+	while (ChunkOffset + 8 <= FileSize)
+	{
+		const uint8* ChunkHeader = FileData + ChunkOffset;
+		const int64 ChunkSize = ReadU32(ChunkHeader + 4);
+		const int64 ChunkStart = ChunkOffset + 8;
+
+		if (FMemory::Memcmp(ChunkHeader, "fmt ", 4) == 0)
+		{
+			const int64 FormatBytes = FMath::Min(ChunkSize, FileSize - ChunkStart);
+			if (FormatBytes < 16)
+			{
+				return false;
+			}
+
+			const uint8* FormatData = FileData + ChunkStart;
+			uint16 FormatTag = ReadU16(FormatData);
+			Format.NumChannels = ReadU16(FormatData + 2);
+			Format.SampleRate = ReadU32(FormatData + 4);
+			Format.BitsPerSample = ReadU16(FormatData + 14);
+
+			// Extensible headers keep the real format tag in the first two bytes of the sub-format GUID
+			if (FormatTag == FormatExtensible && FormatBytes >= 26)
+			{
+				FormatTag = ReadU16(FormatData + 24);
+			}
+
+			Format.bFloat = FormatTag == FormatFloat;
+			const bool bSupportedInteger = FormatTag == FormatPCM && (Format.BitsPerSample == 8 || Format.BitsPerSample == 16 || Format.BitsPerSample == 24 || Format.BitsPerSample == 32);
+			const bool bSupportedFloat = Format.bFloat && Format.BitsPerSample == 32;
+			if ((!bSupportedInteger && !bSupportedFloat) || Format.NumChannels <= 0 || Format.SampleRate <= 0)
+			{
+				return false;
+			}
+
+			bHasFormat = true;
+		}
+		else if (FMemory::Memcmp(ChunkHeader, "data", 4) == 0)
+		{
+			if (!bHasFormat)
+			{
+				return false;
+			}
+
+			// Writers that stream often leave the size unset or too large, clamp to what is in the file
+			Format.DataOffset = ChunkStart;
+			Format.DataSize = FMath::Min(ChunkSize, FileSize - ChunkStart);
+			return true;
+		}
+
+		ChunkOffset = ChunkStart + ChunkSize + (ChunkSize & 1);
+	}
+
+	return false;
+}
+
+const float* FDialogWavReader::GetFloatSamples() const
+{
+	const uint8* SampleData = GetSampleData();
+	if (!SampleData || !Format.bFloat || !IsAligned(SampleData, alignof(float)))
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const float*>(SampleData);
+}
+
+int32 FDialogWavReader::ReadFrames(float* OutSamples, int32 MaxFrames)
+{
+	if (!IsOpen() || MaxFrames <= 0)
+	{
+		return 0;
+	}
+
+	const int32 NumFrames = static_cast<int32>(FMath::Min<int64>(MaxFrames, GetFramesRemaining()));
+	if (NumFrames <= 0)
+	{
+		return 0;
+	}
+
+	// Convert straight out of the mapping, the only copy is into the caller's floats
+	const int32 NumSamples = NumFrames * Format.NumChannels;
+	const uint8* Source = GetSampleData() + FramesRead * Format.GetBlockAlign();
+	if (Format.bFloat)
+	{
+		FMemory::Memcpy(OutSamples, Source, NumSamples * sizeof(float));
+	}
+	else
+	{
+		switch (Format.BitsPerSample)
+		{
+		case 8:
+			for (int32 i = 0; i < NumSamples; ++i)
+			{
+				OutSamples[i] = (static_cast<int32>(Source[i]) - 128) / 128.0f;
+			}
+			break;
+		case 16:
+			for (int32 i = 0; i < NumSamples; ++i)
+			{
+				OutSamples[i] = static_cast<int16>(DialogWavReader::ReadU16(Source + i * 2)) / 32768.0f;
+			}
+			break;
+		case 24:
+			for (int32 i = 0; i < NumSamples; ++i)
+			{
+				const uint8* Sample = Source + i * 3;
+				const int32 Value = static_cast<int32>((static_cast<uint32>(Sample[0]) << 8) | (static_cast<uint32>(Sample[1]) << 16) | (static_cast<uint32>(Sample[2]) << 24)) >> 8;
+				OutSamples[i] = Value / 8388608.0f;
+			}
+			break;
+		default:
+			for (int32 i = 0; i < NumSamples; ++i)
+			{
+				OutSamples[i] = static_cast<int32>(DialogWavReader::ReadU32(Source + i * 4)) / 2147483648.0f;
+			}
+			break;
+		}
+	}
+
+	FramesRead += NumFrames;
+	return NumFrames;
+}
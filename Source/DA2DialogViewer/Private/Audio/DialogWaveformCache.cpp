@@ -0,0 +1,471 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Audio/DialogWaveformCache.h"
+#include "Audio/DialogWavReader.h"
+#include "Audio/AudioUtils.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
+
+namespace DialogWaveformCache
+{
+	// "DA2W"
+	static constexpr uint32 FileMagic = 0x57324144;
+
+	// Bump when FDialogWaveformSummary or the way it is computed changes
+	static constexpr uint32 FileVersion = 2;
+
+	// Samples at or beyond this are counted as clipped
+	static constexpr float ClipThreshold = 0.999f;
+
+	// Followed by summaries up to the end of the file; a file ID recorded twice keeps its last record
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 SummarySize;
+		uint32 Reserved; // Keeps the records 8-byte aligned
+	};
+
+	// Rewrite the file once stale records outnumber live ones
+	static constexpr int32 CompactRatio = 2;
+
+	static int8 Quantize(float Value)
+	{
+		return static_cast<int8>(FMath::Clamp(FMath::RoundToInt(Value * 127.0f), -127, 127));
+	}
+
+	// Min, max, sum of squares and clipped count of a run of samples, four lanes at a time
+	static void ScanSamples(const float* Samples, int32 NumSamples, float& OutMin, float& OutMax, double& OutSumSquares, uint32& OutNumClipped)
+	{
+		const VectorRegister4Float Threshold = VectorSetFloat1(ClipThreshold);
+		VectorRegister4Float Min = VectorSetFloat1(MAX_flt);
+		VectorRegister4Float Max = VectorSetFloat1(-MAX_flt);
+		VectorRegister4Float SumSquares = VectorZeroFloat();
+		uint32 NumClipped = 0;
+
+		int32 Index = 0;
+		for (; Index + 4 <= NumSamples; Index += 4)
+		{
+			const VectorRegister4Float Value = VectorLoad(Samples + Index);
+			Min = VectorMin(Min, Value);
+			Max = VectorMax(Max, Value);
+			SumSquares = VectorMultiplyAdd(Value, Value, SumSquares);
+			NumClipped += FMath::CountBits(VectorMaskBits(VectorCompareGE(VectorAbs(Value), Threshold)));
+		}
+
+		alignas(16) float MinLanes[4], MaxLanes[4], SumLanes[4];
+		VectorStoreAligned(Min, MinLanes);
+		VectorStoreAligned(Max, MaxLanes);
+		VectorStoreAligned(SumSquares, SumLanes);
+
+		float MinValue = FMath::Min(FMath::Min(MinLanes[0], MinLanes[1]), FMath::Min(MinLanes[2], MinLanes[3]));
+		float MaxValue = FMath::Max(FMath::Max(MaxLanes[0], MaxLanes[1]), FMath::Max(MaxLanes[2], MaxLanes[3]));
+		double Sum = static_cast<double>(SumLanes[0]) + SumLanes[1] + SumLanes[2] + SumLanes[3];
+
+		for (; Index < NumSamples; ++Index)
+		{
+			const float Value = Samples[Index];
+			MinValue = FMath::Min(MinValue, Value);
+			MaxValue = FMath::Max(MaxValue, Value);
+			Sum += Value * Value;
+			NumClipped += FMath::Abs(Value) >= ClipThreshold ? 1 : 0;
+		}
+
+		OutMin = MinValue;
+		OutMax = MaxValue;
+		OutSumSquares += Sum;
+		OutNumClipped += NumClipped;
+	}
+}
+
+int32 FDialogWaveformSummary::FindLevel(int32 MinBuckets)
+{
+	for (int32 Level = NumLevels - 1; Level > 0; --Level)
+	{
+		if (GetLevelSize(Level) >= MinBuckets)
+		{
+			return Level;
+		}
+	}
+	return 0;
+}
+
+FDialogWaveformCache::FDialogWaveformCache(const FString& InCachePath, const FString& InAudioDirectory)
+	: CachePath(InCachePath)
+	, AudioDirectory(InAudioDirectory)
+{
+}
+
+FDialogWaveformCache::~FDialogWaveformCache()
+{
+	Cancel();
+}
+
+FString FDialogWaveformCache::GetDefaultCachePath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DA2DialogViewer/Waveforms.bin"));
+}
+
+void FDialogWaveformCache::Load()
+{
+	{
+		FScopeLock Lock(&QueueLock);
+		if (bProcessing)
+		{
+			// The running worker loads before it summarizes anything
+			return;
+		}
+		bProcessing = true;
+	}
+
+	StartWorker();
+}
+
+void FDialogWaveformCache::LoadFromDisk()
+{
+	using namespace DialogWaveformCache;
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *CachePath, FILEREAD_Silent))
+	{
+		return;
+	}
+
+	const FFileHeader* FileHeader = reinterpret_cast<const FFileHeader*>(FileData.GetData());
+	if (FileData.Num() < static_cast<int32>(sizeof(FFileHeader)) || FileHeader->Magic != FileMagic || FileHeader->Version != FileVersion
+		|| FileHeader->SummarySize != sizeof(FDialogWaveformSummary))
+	{
+		UE_LOG(LogDA2Dialog, Log, TEXT("Waveform cache is outdated or corrupt, starting empty: %s"), *CachePath);
+		return;
+	}
+
+	// A partial record at the end is an append that didn't finish; drop it
+	const int32 RecordBytes = FileData.Num() - static_cast<int32>(sizeof(FFileHeader));
+	const int32 NumRecords = RecordBytes / static_cast<int32>(sizeof(FDialogWaveformSummary));
+	const bool bTornRecord = RecordBytes % sizeof(FDialogWaveformSummary) != 0;
+
+	const FDialogWaveformSummary* FileSummaries = reinterpret_cast<const FDialogWaveformSummary*>(FileData.GetData() + sizeof(FFileHeader));
+
+	// Built outside the lock so rows looking up summaries meanwhile aren't held up
+	TMap<uint32, TSharedPtr<const FDialogWaveformSummary>> LoadedSummaries;
+	LoadedSummaries.Reserve(NumRecords);
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		LoadedSummaries.Add(FileSummaries[Index].FileID, MakeShared<FDialogWaveformSummary>(FileSummaries[Index]));
+	}
+	const int32 NumLoaded = LoadedSummaries.Num();
+
+	{
+		FWriteScopeLock WriteLock(SummariesLock);
+		Summaries = MoveTemp(LoadedSummaries);
+	}
+
+	// Otherwise the next save rewrites the file without the torn or superseded records
+	bCanAppend = !bTornRecord && NumRecords <= NumLoaded * CompactRatio;
+	Generation.fetch_add(1, std::memory_order_release);
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("Loaded %d waveform summaries from %s"), NumLoaded, *CachePath);
+}
+
+void FDialogWaveformCache::Save()
+{
+	TArray<TSharedPtr<const FDialogWaveformSummary>> NewSummaries;
+	{
+		FWriteScopeLock WriteLock(SummariesLock);
+		NewSummaries = MoveTemp(UnsavedSummaries);
+		UnsavedSummaries.Reset();
+	}
+
+	if (NewSummaries.Num() == 0)
+	{
+		return;
+	}
+
+	// Appending to a file someone deleted would leave records without a header
+	if (bCanAppend && IFileManager::Get().FileSize(*CachePath) >= static_cast<int64>(sizeof(DialogWaveformCache::FFileHeader)))
+	{
+		// Only the new records are written; Load lets later records replace earlier ones for the same file
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*CachePath, FILEWRITE_Append));
+		if (Writer)
+		{
+			for (const TSharedPtr<const FDialogWaveformSummary>& Summary : NewSummaries)
+			{
+				Writer->Serialize(const_cast<FDialogWaveformSummary*>(Summary.Get()), sizeof(FDialogWaveformSummary));
+			}
+			if (Writer->Close())
+			{
+				return;
+			}
+		}
+
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Failed to append to waveform cache, rewriting it: %s"), *CachePath);
+	}
+
+	bCanAppend = SaveAll();
+}
+
+bool FDialogWaveformCache::SaveAll() const
+{
+	using namespace DialogWaveformCache;
+
+	TArray<uint8> FileData;
+	{
+		FReadScopeLock ReadLock(SummariesLock);
+
+		FFileHeader FileHeader;
+		FileHeader.Magic = FileMagic;
+		FileHeader.Version = FileVersion;
+		FileHeader.SummarySize = sizeof(FDialogWaveformSummary);
+		FileHeader.Reserved = 0;
+
+		FileData.Reserve(sizeof(FFileHeader) + Summaries.Num() * sizeof(FDialogWaveformSummary));
+		FileData.Append(reinterpret_cast<const uint8*>(&FileHeader), sizeof(FileHeader));
+		for (const TPair<uint32, TSharedPtr<const FDialogWaveformSummary>>& Pair : Summaries)
+		{
+			FileData.Append(reinterpret_cast<const uint8*>(Pair.Value.Get()), sizeof(FDialogWaveformSummary));
+		}
+	}
+
+	// Write next to the target and move over it, so a crash never leaves a half-written cache
+	const FString TempPath = CachePath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(FileData, *TempPath) || !IFileManager::Get().Move(*CachePath, *TempPath, true))
+	{
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to write waveform cache: %s"), *CachePath);
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+	return true;
+}
+
+TSharedPtr<const FDialogWaveformSummary> FDialogWaveformCache::Find(uint32 FileID) const
+{
+	FReadScopeLock ReadLock(SummariesLock);
+	const TSharedPtr<const FDialogWaveformSummary>* Found = Summaries.Find(FileID);
+	return Found ? *Found : nullptr;
+}
+
+int32 FDialogWaveformCache::Num() const
+{
+	FReadScopeLock ReadLock(SummariesLock);
+	return Summaries.Num();
+}
+
+void FDialogWaveformCache::Request(TConstArrayView<uint32> FileIDs)
+{
+	bool bStartWorker = false;
+	{
+		FScopeLock Lock(&QueueLock);
+		for (const uint32 FileID : FileIDs)
+		{
+			// Files waiting or being summarized are skipped; once their batch is done a new request re-checks the timestamp
+			bool bAlreadyQueued = false;
+			QueuedFileIDs.Add(FileID, &bAlreadyQueued);
+			if (!bAlreadyQueued)
+			{
+				PendingFileIDs.Add(FileID);
+			}
+		}
+
+		if (PendingFileIDs.Num() > 0 && !bProcessing)
+		{
+			bProcessing = true;
+			bStartWorker = true;
+		}
+	}
+
+	if (bStartWorker)
+	{
+		StartWorker();
+	}
+}
+
+void FDialogWaveformCache::StartWorker()
+{
+	bCancelled = false;
+
+	TWeakPtr<FDialogWaveformCache> WeakThis = AsShared();
+	Async(EAsyncExecution::ThreadPool, [WeakThis]()
+	{
+		if (TSharedPtr<FDialogWaveformCache> This = WeakThis.Pin())
+		{
+			This->ProcessQueue();
+		}
+	});
+}
+
+void FDialogWaveformCache::Cancel()
+{
+	bCancelled = true;
+}
+
+void FDialogWaveformCache::ProcessQueue()
+{
+	// Summaries computed before the load would be overwritten by older ones from the file
+	if (!bLoaded && !bCancelled)
+	{
+		LoadFromDisk();
+		bLoaded = true;
+	}
+
+	for (;;)
+	{
+		TArray<uint32> Batch;
+		{
+			FScopeLock Lock(&QueueLock);
+			if (PendingFileIDs.Num() == 0 || bCancelled)
+			{
+				// Dropped files can be requested again
+				for (const uint32 FileID : PendingFileIDs)
+				{
+					QueuedFileIDs.Remove(FileID);
+				}
+				PendingFileIDs.Reset();
+				bProcessing = false;
+				return;
+			}
+			Batch = MoveTemp(PendingFileIDs);
+			PendingFileIDs.Reset();
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		std::atomic<int32> NumComputed{0};
+
+		// Files are independent; each one is a read, a decode and a few SIMD passes
+		ParallelFor(Batch.Num(), [this, &Batch, &NumComputed](int32 BatchIndex)
+		{
+			if (bCancelled.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+
+			const uint32 FileID = Batch[BatchIndex];
+			const FString FilePath = FAudioUtils::BuildAudioFilePath(AudioDirectory, FileID);
+			const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*FilePath);
+			if (TimeStamp == FDateTime::MinValue())
+			{
+				return;
+			}
+
+			const TSharedPtr<const FDialogWaveformSummary> Existing = Find(FileID);
+			if (Existing.IsValid() && Existing->Timestamp == TimeStamp.GetTicks())
+			{
+				return;
+			}
+
+			if (TSharedPtr<FDialogWaveformSummary> Summary = ComputeSummary(FilePath, FileID, TimeStamp.GetTicks()))
+			{
+				{
+					FWriteScopeLock WriteLock(SummariesLock);
+					UnsavedSummaries.Add(Summary);
+					Summaries.Add(FileID, MoveTemp(Summary));
+				}
+				Generation.fetch_add(1, std::memory_order_release);
+				++NumComputed;
+			}
+		});
+
+		if (NumComputed > 0)
+		{
+			Save();
+			UE_LOG(LogDA2Dialog, Log, TEXT("Computed %d waveform summaries (%d requested) in %.2f s"),
+				NumComputed.load(), Batch.Num(), FPlatformTime::Seconds() - StartTime);
+		}
+
+		// A line re-recorded during the session gets summarized again the next time it is requested
+		{
+			FScopeLock Lock(&QueueLock);
+			for (const uint32 FileID : Batch)
+			{
+				QueuedFileIDs.Remove(FileID);
+			}
+		}
+	}
+}
+
+TSharedPtr<FDialogWaveformSummary> FDialogWaveformCache::ComputeSummary(const FString& FilePath, uint32 FileID, int64 Timestamp)
+{
+	TSharedPtr<FDialogWaveformSummary> Summary = MakeShared<FDialogWaveformSummary>();
+	Summary->FileID = FileID;
+	Summary->Timestamp = Timestamp;
+
+	// Float files are summarized in place from the mapped file; everything else is converted once, straight from the mapping
+	FDialogWavReader Reader;
+	if (!Reader.Open(FilePath))
+	{
+		return nullptr;
+	}
+
+	const FDialogWavFormat& Format = Reader.GetFormat();
+	const int64 NumSamples = Format.GetNumFrames() * Format.NumChannels;
+	if (NumSamples > MAX_int32)
+	{
+		return nullptr;
+	}
+
+	if (const float* MappedSamples = Reader.GetFloatSamples())
+	{
+		SummarizeSamples(MakeArrayView(MappedSamples, static_cast<int32>(NumSamples)), Format.NumChannels, Format.SampleRate, *Summary);
+		return Summary;
+	}
+
+	TArray<float> Samples;
+	Samples.SetNumUninitialized(static_cast<int32>(NumSamples));
+	const int32 NumFrames = Reader.ReadFrames(Samples.GetData(), static_cast<int32>(Format.GetNumFrames()));
+	Samples.SetNum(NumFrames * Format.NumChannels);
+
+	SummarizeSamples(Samples, Format.NumChannels, Format.SampleRate, *Summary);
+	return Summary;
+}
+
+void FDialogWaveformCache::SummarizeSamples(TConstArrayView<float> Samples, int32 NumChannels, int32 SampleRate, FDialogWaveformSummary& OutSummary)
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_SummarizeWaveform);
+
+	using namespace DialogWaveformCache;
+
+	const int64 NumFrames = NumChannels > 0 ? Samples.Num() / NumChannels : 0;
+	OutSummary.Duration = SampleRate > 0 ? static_cast<float>(NumFrames) / SampleRate : 0.0f;
+
+	double SumSquares = 0.0;
+	uint32 NumClipped = 0;
+	float Peak = 0.0f;
+
+	// Finest level straight from the samples; buckets split on frame boundaries so channels stay together
+	for (int32 Bucket = 0; Bucket < FDialogWaveformSummary::NumBaseBuckets; ++Bucket)
+	{
+		const int64 FirstFrame = NumFrames * Bucket / FDialogWaveformSummary::NumBaseBuckets;
+		const int64 EndFrame = NumFrames * (Bucket + 1) / FDialogWaveformSummary::NumBaseBuckets;
+
+		float Min = 0.0f, Max = 0.0f;
+		if (EndFrame > FirstFrame)
+		{
+			ScanSamples(Samples.GetData() + FirstFrame * NumChannels, static_cast<int32>((EndFrame - FirstFrame) * NumChannels), Min, Max, SumSquares, NumClipped);
+		}
+
+		OutSummary.Mins[Bucket] = Quantize(Min);
+		OutSummary.Maxs[Bucket] = Quantize(Max);
+		Peak = FMath::Max(Peak, FMath::Max(-Min, Max));
+	}
+
+	// Each coarser level is the min/max of bucket pairs from the level below
+	for (int32 Level = 1; Level < FDialogWaveformSummary::NumLevels; ++Level)
+	{
+		const int32 Source = FDialogWaveformSummary::GetLevelOffset(Level - 1);
+		const int32 Target = FDialogWaveformSummary::GetLevelOffset(Level);
+		for (int32 Bucket = 0; Bucket < FDialogWaveformSummary::GetLevelSize(Level); ++Bucket)
+		{
+			OutSummary.Mins[Target + Bucket] = FMath::Min(OutSummary.Mins[Source + Bucket * 2], OutSummary.Mins[Source + Bucket * 2 + 1]);
+			OutSummary.Maxs[Target + Bucket] = FMath::Max(OutSummary.Maxs[Source + Bucket * 2], OutSummary.Maxs[Source + Bucket * 2 + 1]);
+		}
+	}
+
+	OutSummary.RMS = Samples.Num() > 0 ? static_cast<float>(FMath::Sqrt(SumSquares / Samples.Num())) : 0.0f;
+	OutSummary.Peak = Peak;
+	OutSummary.NumClippedSamples = NumClipped;
+}
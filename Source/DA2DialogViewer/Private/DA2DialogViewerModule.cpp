@@ -1,20 +1,91 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DA2DialogViewerModule.h"
+#include "DA2DialogViewerLog.h"
+#include "DA2DialogViewerStats.h"
 #include "Data/DialogDataManager.h"
+#include "Audio/DialogAudioCoverage.h"
 #include "UI/SDialogViewerWindow.h"
 #include "ToolMenus.h"
 #include "Misc/Paths.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "Framework/Docking/TabManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/Async.h"
 
 #define LOCTEXT_NAMESPACE "FDA2DialogViewerModule"
 
 static const FName DialogViewerTabName("DA2DialogViewer");
 
+DEFINE_STAT(STAT_DA2Dialog_ParseConversation);
+DEFINE_STAT(STAT_DA2Dialog_ReadCSV);
+DEFINE_STAT(STAT_DA2Dialog_GetTLKString);
+DEFINE_STAT(STAT_DA2Dialog_FindOwnerTag);
+DEFINE_STAT(STAT_DA2Dialog_BuildTreeModel);
+DEFINE_STAT(STAT_DA2Dialog_ResolveAudioAvailability);
+DEFINE_STAT(STAT_DA2Dialog_DecodeAudio);
+DEFINE_STAT(STAT_DA2Dialog_SummarizeWaveform);
+DEFINE_STAT(STAT_DA2Dialog_AudioCoverage);
+DEFINE_STAT(STAT_DA2Dialog_BuildSearchIndex);
+DEFINE_STAT(STAT_DA2Dialog_SearchQuery);
+DEFINE_STAT(STAT_DA2Dialog_BuildTree);
+DEFINE_STAT(STAT_DA2Dialog_WheelSetCurrentNode);
+DEFINE_STAT(STAT_DA2Dialog_WheelPaint);
+DEFINE_STAT(STAT_DA2Dialog_GraphPaint);
+DEFINE_STAT(STAT_DA2Dialog_GraphLayout);
+DEFINE_STAT(STAT_DA2Dialog_NumUTCFilesScanned);
+DEFINE_STAT(STAT_DA2Dialog_NumTreeItems);
+DEFINE_STAT(STAT_DA2Dialog_NumGraphNodesDrawn);
+DEFINE_STAT(STAT_DA2Dialog_NumGraphLinksDrawn);
+DEFINE_STAT(STAT_DA2Dialog_TLKStringMemory);
+DEFINE_STAT(STAT_DA2Dialog_ConversationMemory);
+DEFINE_STAT(STAT_DA2Dialog_AudioCacheMemory);
+DEFINE_STAT(STAT_DA2Dialog_TreeItemMemory);
+
+UE_TRACE_CHANNEL_DEFINE(DA2DialogChannel);
+
+DEFINE_LOG_CATEGORY(LogDA2Dialog);
+
+namespace DA2DialogLog
+{
+	std::atomic<bool> bTreeBuild{false};
+	std::atomic<bool> bSpeaker{false};
+	std::atomic<bool> bUTCScan{false};
+	std::atomic<bool> bActions{false};
+
+	// Console variables can't reference an atomic, so each one copies its value into the switch when it changes
+	static FConsoleVariableDelegate MakeSwitchSetter(std::atomic<bool>& Switch)
+	{
+		return FConsoleVariableDelegate::CreateLambda([&Switch](IConsoleVariable* Variable)
+		{
+			Switch.store(Variable->GetBool(), std::memory_order_relaxed);
+		});
+	}
+
+	static FAutoConsoleVariable CVarLogTreeBuild(
+		TEXT("DA2Dialog.Log.TreeBuild"), false,
+		TEXT("Log per-node tree construction details (party speaker resolution)"),
+		MakeSwitchSetter(bTreeBuild));
+
+	static FAutoConsoleVariable CVarLogSpeaker(
+		TEXT("DA2Dialog.Log.Speaker"), false,
+		TEXT("Log per-row speaker classification details"),
+		MakeSwitchSetter(bSpeaker));
+
+	static FAutoConsoleVariable CVarLogUTCScan(
+		TEXT("DA2Dialog.Log.UTCScan"), false,
+		TEXT("Log per-file details while scanning UTC files for conversation owners"),
+		MakeSwitchSetter(bUTCScan));
+
+	static FAutoConsoleVariable CVarLogActions(
+		TEXT("DA2Dialog.Log.Actions"), false,
+		TEXT("Log plot flag changes made by dialog actions"),
+		MakeSwitchSetter(bActions));
+}
+
 void FDA2DialogViewerModule::StartupModule()
 {
-	UE_LOG(LogTemp, Log, TEXT("DA2DialogViewer: Module starting up"));
+	UE_LOG(LogDA2Dialog, Log, TEXT("DA2DialogViewer: Module starting up"));
 
 	// Create data manager
 	DataManager = MakeShared<FDialogDataManager>();
@@ -29,18 +100,37 @@ void FDA2DialogViewerModule::StartupModule()
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("DA2DialogViewer: Data directory not found: %s"), *DataDir);
+		UE_LOG(LogDA2Dialog, Warning, TEXT("DA2DialogViewer: Data directory not found: %s"), *DataDir);
 	}
 
 	// Register menus
 	RegisterMenus();
 
-	UE_LOG(LogTemp, Log, TEXT("DA2DialogViewer: Module started successfully"));
+	// Whole-corpus audio audit, runs on the thread pool
+	AudioCoverageCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("DA2Dialog.AudioCoverage"),
+		TEXT("Resolve the audio of every line in every conversation and write missing, shared, orphaned and loudness reports to Saved/DA2DialogViewer/AudioCoverage"),
+		FConsoleCommandDelegate::CreateRaw(this, &FDA2DialogViewerModule::RunAudioCoverageReport));
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("DA2DialogViewer: Module started successfully"));
 }
 
 void FDA2DialogViewerModule::ShutdownModule()
 {
-	UE_LOG(LogTemp, Log, TEXT("DA2DialogViewer: Module shutting down"));
+	UE_LOG(LogDA2Dialog, Log, TEXT("DA2DialogViewer: Module shutting down"));
+
+	if (AudioCoverageCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(AudioCoverageCommand);
+		AudioCoverageCommand = nullptr;
+	}
+
+	// The report reads through this module's cancel flag, so it has to finish before the module goes away
+	if (AudioCoverageTask.IsValid())
+	{
+		bAudioCoverageCancelled = true;
+		AudioCoverageTask.Wait();
+	}
 
 	// Clean up data manager
 	DataManager.Reset();
@@ -50,6 +140,26 @@ void FDA2DialogViewerModule::ShutdownModule()
 	UToolMenus::UnregisterOwner(this);
 }
 
+void FDA2DialogViewerModule::RunAudioCoverageReport()
+{
+	if (!DataManager.IsValid())
+		return;
+
+	if (AudioCoverageTask.IsValid() && !AudioCoverageTask.IsReady())
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Audio coverage: a report is already running"));
+		return;
+	}
+
+	// Parsing every conversation takes seconds, so keep it off the game thread; the report logs when it's done
+	UE_LOG(LogDA2Dialog, Log, TEXT("Audio coverage: running in the background"));
+	bAudioCoverageCancelled = false;
+	AudioCoverageTask = Async(EAsyncExecution::ThreadPool, [Manager = DataManager, this]()
+	{
+		return FDialogAudioCoverage::RunReport(*Manager, &bAudioCoverageCancelled);
+	});
+}
+
 void FDA2DialogViewerModule::RegisterMenus()
 {
 	// Register tab spawner
@@ -2,16 +2,20 @@
 
 #include "Data/ConversationParser.h"
 #include "XmlFile.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
 
 bool FConversationParser::ParseConversation(const FString& FilePath, FConversation& OutConversation)
 {
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_ParseConversation);
+
 	OutConversation.Clear();
 
 	// Load XML file
 	TSharedPtr<FXmlFile> XmlFile = MakeShared<FXmlFile>(FilePath, EConstructMethod::ConstructFromFile);
 	if (!XmlFile->IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to parse XML file: %s"), *FilePath);
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to parse XML file: %s"), *FilePath);
 		return false;
 	}
 
@@ -19,7 +23,7 @@ bool FConversationParser::ParseConversation(const FString& FilePath, FConversati
 	const FXmlNode* RootNode = XmlFile->GetRootNode();
 	if (!RootNode)
 	{
-		UE_LOG(LogTemp, Error, TEXT("XML file has no root node: %s"), *FilePath);
+		UE_LOG(LogDA2Dialog, Error, TEXT("XML file has no root node: %s"), *FilePath);
 		return false;
 	}
 
@@ -36,7 +40,7 @@ bool FConversationParser::ParseConversation(const FString& FilePath, FConversati
 
 	if (!ConvNode)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Could not find CONV struct in XML: %s"), *FilePath);
+		UE_LOG(LogDA2Dialog, Error, TEXT("Could not find CONV struct in XML: %s"), *FilePath);
 		return false;
 	}
 
@@ -49,7 +53,7 @@ bool FConversationParser::ParseConversation(const FString& FilePath, FConversati
 	// Parse dialog lines (label 30002)
 	ParseDialogLines(ConvNode, OutConversation);
 
-	UE_LOG(LogTemp, Log, TEXT("Parsed conversation: %s (%d entries, %d nodes)"),
+	UE_LOG(LogDA2Dialog, Log, TEXT("Parsed conversation: %s (%d entries, %d nodes)"),
 		*OutConversation.ConversationName, OutConversation.EntryLinks.Num(), OutConversation.Nodes.Num());
 
 	return true;
@@ -2,16 +2,20 @@
 
 #include "Data/DialogCSVReader.h"
 #include "Misc/FileHelper.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
 
 bool FDialogCSVReader::ReadCSV(const FString& FilePath, TArray<TArray<FString>>& OutRows)
 {
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_ReadCSV);
+
 	OutRows.Empty();
 
 	// Read file into string
 	FString FileContent;
 	if (!FFileHelper::LoadFileToString(FileContent, *FilePath))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to read CSV file: %s"), *FilePath);
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to read CSV file: %s"), *FilePath);
 		return false;
 	}
 
@@ -94,7 +98,7 @@ bool FDialogCSVReader::ReadPlotsCSV(const FString& FilePath, TMap<FString, FStri
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Loaded %d plot mappings from %s"), OutPlotMap.Num(), *FilePath);
+	UE_LOG(LogDA2Dialog, Log, TEXT("Loaded %d plot mappings from %s"), OutPlotMap.Num(), *FilePath);
 	return OutPlotMap.Num() > 0;
 }
 
@@ -124,7 +128,7 @@ bool FDialogCSVReader::ReadPlotsCSVReverse(const FString& FilePath, TMap<FString
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Loaded %d GUID->plot mappings from %s"), OutGUIDMap.Num(), *FilePath);
+	UE_LOG(LogDA2Dialog, Log, TEXT("Loaded %d GUID->plot mappings from %s"), OutGUIDMap.Num(), *FilePath);
 	return OutGUIDMap.Num() > 0;
 }
 
@@ -159,6 +163,6 @@ bool FDialogCSVReader::ReadTLKStringsCSV(const FString& FilePath, TMap<int32, FS
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Loaded %d TLK strings from %s"), OutTLKMap.Num(), *FilePath);
+	UE_LOG(LogDA2Dialog, Log, TEXT("Loaded %d TLK strings from %s"), OutTLKMap.Num(), *FilePath);
 	return OutTLKMap.Num() > 0;
 }
@@ -3,8 +3,19 @@
 #include "Data/DialogDataManager.h"
 #include "Data/ConversationParser.h"
 #include "Data/DialogCSVReader.h"
+#include "Audio/AudioFileIndex.h"
+#include "Audio/AudioUtils.h"
+#include "Audio/DialogWaveformCache.h"
 #include "Misc/Paths.h"
+#include "Misc/PathViews.h"
+#include "HAL/FileManager.h"
+#include "Async/Async.h"
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "Modules/ModuleManager.h"
 #include "XmlFile.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
 
 FDialogDataManager::FDialogDataManager()
 	: PlayerGender(EPlayerGender::Male)
@@ -14,72 +25,147 @@ FDialogDataManager::FDialogDataManager()
 
 FDialogDataManager::~FDialogDataManager()
 {
+	UnregisterAudioDirectoryWatcher();
+
+	if (WaveformCache.IsValid())
+	{
+		WaveformCache->Cancel();
+	}
 }
 
 bool FDialogDataManager::Initialize(const FString& InDataDirectory)
 {
 	DataDirectory = InDataDirectory;
 
+	{
+		// Moving a map keeps every string's character buffer where it is, so outstanding views stay valid
+		FWriteScopeLock WriteLock(ProcessedTLKLock);
+		for (TMap<int32, FString>& Processed : ProcessedTLKStrings)
+		{
+			if (Processed.Num() > 0)
+			{
+				RetiredProcessedTLKStrings.Add(MoveTemp(Processed));
+				Processed.Reset();
+			}
+		}
+	}
+
 	// Load plots.csv
 	FString PlotsCSVPath = FPaths::Combine(DataDirectory, TEXT("plo_727/plots.csv"));
 	if (!PlotDatabase.LoadPlotsCSV(PlotsCSVPath))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Failed to load plots.csv from: %s"), *PlotsCSVPath);
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Failed to load plots.csv from: %s"), *PlotsCSVPath);
 	}
 
 	// Load dialog.csv
 	FString DialogCSVPath = FPaths::Combine(DataDirectory, TEXT("DLG/dialog.csv"));
 	if (!AudioMapper.LoadDialogCSV(DialogCSVPath))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Failed to load dialog.csv from: %s"), *DialogCSVPath);
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Failed to load dialog.csv from: %s"), *DialogCSVPath);
 	}
 
 	// Load TableTalk.csv (TLK strings)
 	FString TableTalkPath = FPaths::Combine(DataDirectory, TEXT("DLG/csv/TableTalk.csv"));
 	if (!FDialogCSVReader::ReadTLKStringsCSV(TableTalkPath, TLKStrings))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Failed to load TableTalk.csv from: %s"), *TableTalkPath);
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Failed to load TableTalk.csv from: %s"), *TableTalkPath);
+	}
+
+#if STATS
+	SIZE_T TLKStringBytes = TLKStrings.GetAllocatedSize();
+	for (const TPair<int32, FString>& Pair : TLKStrings)
+	{
+		TLKStringBytes += Pair.Value.GetAllocatedSize();
 	}
+	SET_MEMORY_STAT(STAT_DA2Dialog_TLKStringMemory, TLKStringBytes);
+#endif
 
 	bIsInitialized = true;
 
-	UE_LOG(LogTemp, Log, TEXT("DialogDataManager initialized with data directory: %s"), *DataDirectory);
-	UE_LOG(LogTemp, Log, TEXT("  - Plots loaded: %d"), PlotDatabase.GetPlotCount());
-	UE_LOG(LogTemp, Log, TEXT("  - TLK strings loaded: %d"), TLKStrings.Num());
+	// Audio lookups use an in-memory index of the audio directory, kept current by a directory watcher
+	RegisterAudioDirectoryWatcher();
+	StartAudioFileScan();
+
+	// Waveforms are computed per conversation as they're shown, and kept across sessions (the saved ones load in the background)
+	if (WaveformCache.IsValid())
+	{
+		WaveformCache->Cancel();
+	}
+	WaveformCache = MakeShared<FDialogWaveformCache>(FDialogWaveformCache::GetDefaultCachePath(), GetAudioDirectory());
+	WaveformCache->Load();
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("DialogDataManager initialized with data directory: %s"), *DataDirectory);
+	UE_LOG(LogDA2Dialog, Log, TEXT("  - Plots loaded: %d"), PlotDatabase.GetPlotCount());
+	UE_LOG(LogDA2Dialog, Log, TEXT("  - TLK strings loaded: %d"), TLKStrings.Num());
 
 	return true;
 }
 
 bool FDialogDataManager::LoadConversation(const FString& ConversationPath)
 {
-	if (!bIsInitialized)
+	TSharedPtr<FConversation> NewConversation = ReadConversation(ConversationPath);
+	if (!NewConversation.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("DialogDataManager not initialized"));
 		return false;
 	}
 
+	SetCurrentConversation(NewConversation);
+	return true;
+}
+
+TSharedPtr<FConversation> FDialogDataManager::ReadConversation(const FString& ConversationPath, const std::atomic<bool>* bCancelled) const
+{
+	// Only reads state that is fixed after Initialize (DataDirectory), so this can run off the game thread
+	if (!bIsInitialized)
+	{
+		UE_LOG(LogDA2Dialog, Error, TEXT("DialogDataManager not initialized"));
+		return nullptr;
+	}
+
 	// Create new conversation
 	TSharedPtr<FConversation> NewConversation = MakeShared<FConversation>();
 
 	// Parse conversation XML
 	if (!FConversationParser::ParseConversation(ConversationPath, *NewConversation))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to parse conversation: %s"), *ConversationPath);
-		return false;
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to parse conversation: %s"), *ConversationPath);
+		return nullptr;
 	}
 
-	// Set as current conversation
-	CurrentConversation = NewConversation;
+	if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
 
 	// Find and set owner tag from UTC files
-	CurrentConversation->OwnerTag = FindOwnerTagForConversation(CurrentConversation->ConversationName);
+	NewConversation->OwnerTag = FindOwnerTagForConversation(NewConversation->ConversationName, bCancelled);
+
+	if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return NewConversation;
+}
+
+void FDialogDataManager::SetCurrentConversation(TSharedPtr<FConversation> InConversation)
+{
+	check(IsInGameThread());
+
+	// Set as current conversation
+	CurrentConversation = InConversation;
+
+	if (!CurrentConversation.IsValid())
+	{
+		return;
+	}
+
+	SET_MEMORY_STAT(STAT_DA2Dialog_ConversationMemory, CurrentConversation->GetAllocatedSize());
 
 	// Reset plot state for new conversation
 	ResetPlotState();
 
-	UE_LOG(LogTemp, Log, TEXT("Loaded conversation: %s (Owner: %s)"), *CurrentConversation->ConversationName, *CurrentConversation->OwnerTag);
-
-	return true;
+	UE_LOG(LogDA2Dialog, Log, TEXT("Loaded conversation: %s (Owner: %s)"), *CurrentConversation->ConversationName, *CurrentConversation->OwnerTag);
 }
 
 FString FDialogDataManager::GetAudioDirectory() const
@@ -87,6 +173,259 @@ FString FDialogDataManager::GetAudioDirectory() const
 	return FPaths::Combine(DataDirectory, TEXT("all_conv_wav"));
 }
 
+FString FDialogDataManager::GetConversationDirectory() const
+{
+	return FPaths::Combine(DataDirectory, TEXT("DLG/cnv"));
+}
+
+TSharedPtr<const FAudioFileIndex> FDialogDataManager::GetAudioFileIndex() const
+{
+	FReadScopeLock ReadLock(AudioFileIndexLock);
+	return AudioFileIndex;
+}
+
+FString FDialogDataManager::ResolveAudioFilePath(int32 TLKID, EPlayerGender Gender) const
+{
+	if (TLKID <= 0)
+	{
+		return FString();
+	}
+
+	const FString AudioDirectory = GetAudioDirectory();
+	const TSharedPtr<const FAudioFileIndex> Index = GetAudioFileIndex();
+
+	auto IsPresent = [&Index, &AudioDirectory](uint32 FileID)
+	{
+		return Index.IsValid() ? Index->Contains(FileID) : FAudioUtils::DoesAudioFileExist(AudioDirectory, FileID);
+	};
+
+	// Priority 1: dialog.csv mapping
+	uint32 MappedFileID = 0;
+	if (AudioMapper.FindAudioFileID(TLKID, Gender, MappedFileID) && IsPresent(MappedFileID))
+	{
+		return FAudioUtils::BuildAudioFilePath(AudioDirectory, MappedFileID);
+	}
+
+	// Priority 2: FNV32 hash of the TLK ID
+	const uint32 HashedFileID = FAudioUtils::ComputeAudioFileID(TLKID, Gender == EPlayerGender::Male);
+	if (IsPresent(HashedFileID))
+	{
+		return FAudioUtils::BuildAudioFilePath(AudioDirectory, HashedFileID);
+	}
+
+	return FString();
+}
+
+bool FDialogDataManager::ResolveAudioAvailability(TConstArrayView<int32> TLKIDs, EPlayerGender Gender, TBitArray<>& OutHasAudio, TArray<uint32>* OutFileIDs) const
+{
+	OutHasAudio.Reset();
+	if (OutFileIDs)
+	{
+		OutFileIDs->Reset();
+	}
+
+	const TSharedPtr<const FAudioFileIndex> Index = GetAudioFileIndex();
+	if (!Index.IsValid())
+	{
+		return false;
+	}
+
+	// Hash every fallback ID up front, four at a time
+	TArray<uint32> HashedFileIDs;
+	HashedFileIDs.SetNumUninitialized(TLKIDs.Num());
+	FAudioUtils::ComputeAudioFileIDs(TLKIDs, Gender == EPlayerGender::Male, HashedFileIDs);
+
+	OutHasAudio.Init(false, TLKIDs.Num());
+	if (OutFileIDs)
+	{
+		OutFileIDs->SetNumZeroed(TLKIDs.Num());
+	}
+
+	for (int32 i = 0; i < TLKIDs.Num(); ++i)
+	{
+		const int32 TLKID = TLKIDs[i];
+		if (TLKID <= 0)
+		{
+			continue;
+		}
+
+		// Same priority as ResolveAudioFilePath: dialog.csv mapping, then the FNV32 hash
+		uint32 MappedFileID = 0;
+		uint32 FileID = 0;
+		if (AudioMapper.FindAudioFileID(TLKID, Gender, MappedFileID) && Index->Contains(MappedFileID))
+		{
+			FileID = MappedFileID;
+		}
+		else if (Index->Contains(HashedFileIDs[i]))
+		{
+			FileID = HashedFileIDs[i];
+		}
+		else
+		{
+			continue;
+		}
+
+		OutHasAudio[i] = true;
+		if (OutFileIDs)
+		{
+			(*OutFileIDs)[i] = FileID;
+		}
+	}
+
+	return true;
+}
+
+void FDialogDataManager::StartAudioFileScan()
+{
+	const uint32 Serial = ++AudioFileScanSerial;
+	const FString AudioDirectory = GetAudioDirectory();
+	TWeakPtr<FDialogDataManager> WeakThis = AsShared();
+
+	{
+		FWriteScopeLock WriteLock(AudioFileIndexLock);
+		bAudioFileScanInFlight = true;
+		PendingAudioFileChanges.Reset();
+	}
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, AudioDirectory, Serial]()
+	{
+		TSharedPtr<const FAudioFileIndex> Index = FAudioFileIndex::Build(AudioDirectory);
+
+		if (TSharedPtr<FDialogDataManager> This = WeakThis.Pin())
+		{
+			FWriteScopeLock WriteLock(This->AudioFileIndexLock);
+			if (This->AudioFileScanSerial != Serial)
+			{
+				return;
+			}
+
+			// The directory listing may have passed a file before it was added or removed, so replay what the watcher saw meanwhile
+			if (This->PendingAudioFileChanges.Num() > 0)
+			{
+				TArray<uint32> Added;
+				TArray<uint32> Removed;
+				for (const TPair<uint32, bool>& Change : This->PendingAudioFileChanges)
+				{
+					(Change.Value ? Added : Removed).Add(Change.Key);
+				}
+				Index = Index->WithChanges(Added, Removed);
+			}
+
+			This->AudioFileIndex = Index;
+			This->PendingAudioFileChanges.Reset();
+			This->bAudioFileScanInFlight = false;
+		}
+	});
+}
+
+void FDialogDataManager::RegisterAudioDirectoryWatcher()
+{
+	UnregisterAudioDirectoryWatcher();
+
+	const FString AudioDirectory = GetAudioDirectory();
+	if (!FPaths::DirectoryExists(AudioDirectory))
+	{
+		return;
+	}
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get())
+	{
+		DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(AudioDirectory,
+			IDirectoryWatcher::FDirectoryChanged::CreateSP(this, &FDialogDataManager::OnAudioDirectoryChanged),
+			AudioDirectoryWatcherHandle, IDirectoryWatcher::WatchOptions::IgnoreChangesInSubtree);
+		WatchedAudioDirectory = AudioDirectory;
+	}
+}
+
+void FDialogDataManager::UnregisterAudioDirectoryWatcher()
+{
+	if (!AudioDirectoryWatcherHandle.IsValid())
+	{
+		return;
+	}
+
+	// The watcher module may already be gone during editor shutdown
+	if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+	{
+		if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+		{
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedAudioDirectory, AudioDirectoryWatcherHandle);
+		}
+	}
+
+	AudioDirectoryWatcherHandle.Reset();
+	WatchedAudioDirectory.Empty();
+}
+
+void FDialogDataManager::OnAudioDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+	// Latest change per file wins, so a file added and removed in one batch ends up removed
+	TMap<uint32, bool> FileChanges;
+
+	// Every file touched, whatever the change (a save that replaces the file shows up as added, not modified)
+	TSet<uint32> ChangedFileIDs;
+
+	for (const FFileChangeData& Change : Changes)
+	{
+		if (Change.Action == FFileChangeData::FCA_RescanRequired)
+		{
+			// The watcher lost track (e.g. buffer overflow on a bulk copy), start over
+			StartAudioFileScan();
+			AudioFilesChangedEvent.Broadcast(TConstArrayView<uint32>());
+			return;
+		}
+
+		uint32 FileID = 0;
+		if (!FAudioUtils::ParseAudioFileID(FPathViews::GetCleanFilename(Change.Filename), FileID))
+		{
+			continue;
+		}
+
+		ChangedFileIDs.Add(FileID);
+
+		if (Change.Action == FFileChangeData::FCA_Added)
+		{
+			FileChanges.Add(FileID, true);
+		}
+		else if (Change.Action == FFileChangeData::FCA_Removed)
+		{
+			FileChanges.Add(FileID, false);
+		}
+	}
+
+	if (ChangedFileIDs.Num() > 0)
+	{
+		AudioFilesChangedEvent.Broadcast(ChangedFileIDs.Array());
+	}
+
+	if (FileChanges.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<uint32> Added;
+	TArray<uint32> Removed;
+	for (const TPair<uint32, bool>& Change : FileChanges)
+	{
+		(Change.Value ? Added : Removed).Add(Change.Key);
+	}
+
+	FWriteScopeLock WriteLock(AudioFileIndexLock);
+
+	// The scan in flight may already have passed these files; its result gets them replayed when it lands
+	if (bAudioFileScanInFlight)
+	{
+		PendingAudioFileChanges.Append(MoveTemp(FileChanges));
+	}
+
+	if (AudioFileIndex.IsValid())
+	{
+		AudioFileIndex = AudioFileIndex->WithChanges(Added, Removed);
+		UE_LOG(LogDA2Dialog, Log, TEXT("Audio file index updated: %d added, %d removed (%d files)"), Added.Num(), Removed.Num(), AudioFileIndex->Num());
+	}
+}
+
 void FDialogDataManager::ResetPlotState()
 {
 	PlotState.Reset();
@@ -94,6 +433,8 @@ void FDialogDataManager::ResetPlotState()
 
 FString FDialogDataManager::GetTLKString(int32 TLKID) const
 {
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_GetTLKString);
+
 	// Handle special case: 4294967295 (unsigned -1) is a placeholder
 	if (TLKID == -1 || static_cast<uint32>(TLKID) == 4294967295)
 	{
@@ -106,24 +447,56 @@ FString FDialogDataManager::GetTLKString(int32 TLKID) const
 		return TEXT("");
 	}
 
-	const FString* FoundString = TLKStrings.Find(TLKID);
-	if (FoundString)
+	if (TLKStrings.Contains(TLKID))
+	{
+		// Processed text comes from the pool (empty if the TLK content is empty)
+		return FString(GetTLKStringView(TLKID));
+	}
+
+	// Return fallback text with TLK ID if not found
+	return FString::Printf(TEXT("[TLK %d - Not Found]"), TLKID);
+}
+
+FStringView FDialogDataManager::GetTLKStringView(int32 TLKID) const
+{
+	return GetTLKStringView(TLKID, GetPlayerGender());
+}
+
+FStringView FDialogDataManager::GetTLKStringView(int32 TLKID, EPlayerGender Gender) const
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_GetTLKString);
+
+	// Placeholder (-1) and invalid IDs have no text
+	if (TLKID <= 0)
 	{
-		// Return empty string if the TLK content is empty
-		if (FoundString->IsEmpty())
+		return FStringView();
+	}
+
+	TMap<int32, FString>& Processed = ProcessedTLKStrings[Gender == EPlayerGender::Male ? 0 : 1];
+
+	{
+		FReadScopeLock ReadLock(ProcessedTLKLock);
+		if (const FString* Found = Processed.Find(TLKID))
 		{
-			return TEXT("");
+			return *Found;
 		}
+	}
 
-		// Process rich text and special markers
-		return ProcessTLKString(*FoundString);
+	const FString* RawString = TLKStrings.Find(TLKID);
+	if (!RawString)
+	{
+		return FStringView();
 	}
 
-	// Return fallback text with TLK ID if not found
-	return FString::Printf(TEXT("[TLK %d - Not Found]"), TLKID);
+	// Process rich text and special markers once per gender
+	// Entries are never removed, and a map rehash moves the FString but not its character buffer
+	FString ProcessedString = ProcessTLKString(*RawString, Gender);
+
+	FWriteScopeLock WriteLock(ProcessedTLKLock);
+	return Processed.FindOrAdd(TLKID, MoveTemp(ProcessedString));
 }
 
-FString FDialogDataManager::ProcessTLKString(const FString& RawString) const
+FString FDialogDataManager::ProcessTLKString(const FString& RawString, EPlayerGender Gender) const
 {
 	if (RawString.IsEmpty())
 	{
@@ -167,7 +540,7 @@ FString FDialogDataManager::ProcessTLKString(const FString& RawString) const
 
 	// Character name placeholders
 	// Default names: Garrett (male), Marian (female)
-	const TCHAR* PlayerName = (PlayerGender == EPlayerGender::Male) ? TEXT("Garrett") : TEXT("Marian");
+	const TCHAR* PlayerName = (Gender == EPlayerGender::Male) ? TEXT("Garrett") : TEXT("Marian");
 	Result = Result.Replace(TEXT("<FirstName/>"), PlayerName);
 	Result = Result.Replace(TEXT("<A/>"), PlayerName);
 
@@ -210,17 +583,26 @@ FString FDialogDataManager::ProcessTLKString(const FString& RawString) const
 	return Result;
 }
 
-FString FDialogDataManager::FindOwnerTagForConversation(const FString& ConversationName) const
+FString FDialogDataManager::FindOwnerTagForConversation(const FString& ConversationName, const std::atomic<bool>* bCancelled) const
 {
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_FindOwnerTag);
+
 	// Search UTC files for one that references this conversation
 	FString UTCDirectory = FPaths::Combine(DataDirectory, TEXT("utc"));
 
 	TArray<FString> UTCFiles;
 	IFileManager::Get().FindFiles(UTCFiles, *(UTCDirectory / TEXT("*.xml")), true, false);
+	SET_DWORD_STAT(STAT_DA2Dialog_NumUTCFilesScanned, 0);
 
 	for (const FString& UTCFile : UTCFiles)
 	{
+		if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+		{
+			return TEXT("");
+		}
+
 		FString FullPath = FPaths::Combine(UTCDirectory, UTCFile);
+		INC_DWORD_STAT(STAT_DA2Dialog_NumUTCFilesScanned);
 
 		// Load and parse UTC XML file
 		TSharedPtr<FXmlFile> XmlFile = MakeShared<FXmlFile>(FullPath, EConstructMethod::ConstructFromFile);
@@ -261,12 +643,12 @@ FString FDialogDataManager::FindOwnerTagForConversation(const FString& Conversat
 			if (Child->GetTag() == TEXT("resref") && Child->GetAttribute(TEXT("label")) == TEXT("ConversationResR"))
 			{
 				ConversationResR = Child->GetContent();
-				UE_LOG(LogTemp, Log, TEXT("DEBUG: Found ConversationResR = '%s'"), *ConversationResR);
+				DA2_LOG(bUTCScan, Verbose, TEXT("DEBUG: Found ConversationResR = '%s'"), *ConversationResR);
 			}
 			else if (Child->GetTag() == TEXT("exostring") && Child->GetAttribute(TEXT("label")) == TEXT("Tag"))
 			{
 				Tag = Child->GetContent();
-				UE_LOG(LogTemp, Log, TEXT("DEBUG: Found Tag = '%s' (Length: %d)"), *Tag, Tag.Len());
+				DA2_LOG(bUTCScan, Verbose, TEXT("DEBUG: Found Tag = '%s' (Length: %d)"), *Tag, Tag.Len());
 			}
 
 			// Early exit if we found both
@@ -279,12 +661,12 @@ FString FDialogDataManager::FindOwnerTagForConversation(const FString& Conversat
 		// Check if this UTC file references our conversation
 		if (ConversationResR == ConversationName)
 		{
-			UE_LOG(LogTemp, Log, TEXT("Found owner tag '%s' for conversation '%s' in UTC file '%s'"),
+			UE_LOG(LogDA2Dialog, Log, TEXT("Found owner tag '%s' for conversation '%s' in UTC file '%s'"),
 				*Tag, *ConversationName, *UTCFile);
 			return Tag;
 		}
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("Could not find UTC file for conversation: %s"), *ConversationName);
+	UE_LOG(LogDA2Dialog, Warning, TEXT("Could not find UTC file for conversation: %s"), *ConversationName);
 	return TEXT("");
 }
@@ -0,0 +1,610 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/DialogSearchIndex.h"
+#include "Data/DialogDataManager.h"
+#include "Data/ConversationParser.h"
+#include "DialogFlow/Conversation.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Hash/CityHash.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
+
+/**
+ * Index file layout (all sections 4-byte aligned, little endian, read in place):
+ * header, words (sorted by UTF-8 bytes), postings (TLK IDs, sorted per word), lines (sorted by TLK ID),
+ * refs (per line), conversations, string pool (UTF-8 words and conversation paths)
+ */
+struct FDialogSearchIndex::FFileHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint64 SourceStamp;
+	uint32 NumWords;
+	uint32 NumPostings;
+	uint32 NumLines;
+	uint32 NumRefs;
+	uint32 NumConversations;
+	uint32 StringBytes;
+};
+
+struct FDialogSearchIndex::FWordEntry
+{
+	uint32 StringOffset;
+	uint32 StringLength;
+	uint32 FirstPosting;
+	uint32 NumPostings;
+};
+
+struct FDialogSearchIndex::FLineEntry
+{
+	uint32 TLKID;
+	uint32 FirstRef;
+	uint32 NumRefs;
+};
+
+struct FDialogSearchIndex::FRefEntry
+{
+	uint32 Conversation;
+	int32 NodeIndex;
+};
+
+struct FDialogSearchIndex::FConversationEntry
+{
+	uint32 StringOffset;
+	uint32 StringLength;
+};
+
+namespace DialogSearchIndex
+{
+	// "DA2S"
+	static constexpr uint32 FileMagic = 0x53324144;
+
+	// Bump when the file layout or tokenization changes
+	static constexpr uint32 FileVersion = 1;
+
+	// Byte order of UTF-8 strings (shorter first on a common prefix), the order words are stored in
+	static int32 CompareBytes(const uint8* A, int32 LengthA, const uint8* B, int32 LengthB)
+	{
+		const int32 Result = FMemory::Memcmp(A, B, FMath::Min(LengthA, LengthB));
+		return Result != 0 ? Result : LengthA - LengthB;
+	}
+
+	static TArray<uint8> ToUTF8(const FString& String)
+	{
+		FTCHARToUTF8 Converted(*String);
+		return TArray<uint8>(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+	}
+}
+
+FDialogSearchIndex::FDialogSearchIndex() = default;
+
+FDialogSearchIndex::~FDialogSearchIndex() = default;
+
+FString FDialogSearchIndex::GetDefaultIndexPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DA2DialogViewer/SearchIndex.bin"));
+}
+
+TSharedPtr<const FDialogSearchIndex> FDialogSearchIndex::LoadOrBuild(const FString& IndexPath, const FDialogDataManager& DataManager,
+	const std::atomic<bool>* bCancelled)
+{
+	TArray<FString> ConversationFiles;
+	const uint64 SourceStamp = ComputeSourceStamp(DataManager, ConversationFiles);
+
+	TSharedPtr<FDialogSearchIndex> Index = MakeShareable(new FDialogSearchIndex());
+	if (Index->Open(IndexPath, SourceStamp))
+	{
+		UE_LOG(LogDA2Dialog, Log, TEXT("Opened search index %s (%d words, %d lines)"), *IndexPath, Index->GetNumWords(), Index->GetNumLines());
+		return Index;
+	}
+
+	// Unmap the stale file before it is overwritten
+	Index.Reset();
+
+	if (!Build(IndexPath, DataManager, ConversationFiles, SourceStamp, bCancelled))
+	{
+		return nullptr;
+	}
+
+	Index = MakeShareable(new FDialogSearchIndex());
+	if (!Index->Open(IndexPath, SourceStamp))
+	{
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to open search index after building it: %s"), *IndexPath);
+		return nullptr;
+	}
+
+	return Index;
+}
+
+uint64 FDialogSearchIndex::ComputeSourceStamp(const FDialogDataManager& DataManager, TArray<FString>& OutConversationFiles)
+{
+	struct FSourceFile
+	{
+		FString RelativePath;
+		int64 Size;
+		int64 ModificationTicks;
+	};
+
+	const FString ConversationDirectory = DataManager.GetConversationDirectory();
+	const FString ConversationPrefix = ConversationDirectory + TEXT("/");
+
+	TArray<FSourceFile> Files;
+	IFileManager::Get().IterateDirectoryStatRecursively(*ConversationDirectory, [&](const TCHAR* Path, const FFileStatData& StatData)
+	{
+		if (!StatData.bIsDirectory && FPaths::GetExtension(Path).Equals(TEXT("xml"), ESearchCase::IgnoreCase))
+		{
+			FString RelativePath = Path;
+			FPaths::MakePathRelativeTo(RelativePath, *ConversationPrefix);
+			Files.Add({MoveTemp(RelativePath), StatData.FileSize, StatData.ModificationTime.GetTicks()});
+		}
+		return true;
+	});
+
+	Files.Sort([](const FSourceFile& A, const FSourceFile& B) { return A.RelativePath < B.RelativePath; });
+
+	uint64 Stamp = DialogSearchIndex::FileVersion;
+	auto HashValue = [&Stamp](int64 Value)
+	{
+		Stamp = CityHash64WithSeed(reinterpret_cast<const char*>(&Value), sizeof(Value), Stamp);
+	};
+
+	const FFileStatData TLKStat = IFileManager::Get().GetStatData(*FPaths::Combine(DataManager.GetDataDirectory(), TEXT("DLG/csv/TableTalk.csv")));
+	HashValue(TLKStat.FileSize);
+	HashValue(TLKStat.ModificationTime.GetTicks());
+	HashValue(DataManager.GetTLKStrings().Num());
+
+	OutConversationFiles.Reset(Files.Num());
+	for (FSourceFile& File : Files)
+	{
+		Stamp = CityHash64WithSeed(reinterpret_cast<const char*>(*File.RelativePath), File.RelativePath.Len() * sizeof(TCHAR), Stamp);
+		HashValue(File.Size);
+		HashValue(File.ModificationTicks);
+		OutConversationFiles.Add(MoveTemp(File.RelativePath));
+	}
+
+	return Stamp;
+}
+
+bool FDialogSearchIndex::Build(const FString& IndexPath, const FDialogDataManager& DataManager, const TArray<FString>& ConversationFiles,
+	uint64 SourceStamp, const std::atomic<bool>* bCancelled)
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_BuildSearchIndex);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FString ConversationDirectory = DataManager.GetConversationDirectory();
+
+	// Every place a line is shown: node text, and link (paraphrase) text at the node the link leads to
+	struct FLineRef
+	{
+		uint32 TLKID;
+		uint32 Conversation;
+		int32 NodeIndex;
+	};
+
+	TArray<TArray<FLineRef>> ConversationRefs;
+	ConversationRefs.SetNum(ConversationFiles.Num());
+
+	ParallelFor(ConversationFiles.Num(), [&](int32 ConversationIndex)
+	{
+		if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		FConversation Conversation;
+		if (!FConversationParser::ParseConversation(FPaths::Combine(ConversationDirectory, ConversationFiles[ConversationIndex]), Conversation))
+		{
+			return;
+		}
+
+		TArray<FLineRef>& Refs = ConversationRefs[ConversationIndex];
+		for (const FDialogNode& Node : Conversation.Nodes)
+		{
+			if (Node.TLKStringID > 0)
+			{
+				Refs.Add({static_cast<uint32>(Node.TLKStringID), static_cast<uint32>(ConversationIndex), Node.NodeIndex});
+			}
+
+			for (const FDialogLink& Link : Node.Links)
+			{
+				if (Link.TLKStringID > 0)
+				{
+					Refs.Add({static_cast<uint32>(Link.TLKStringID), static_cast<uint32>(ConversationIndex), Link.TargetNodeIndex});
+				}
+			}
+		}
+	});
+
+	if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	TArray<FLineRef> AllRefs;
+	for (const TArray<FLineRef>& Refs : ConversationRefs)
+	{
+		AllRefs.Append(Refs);
+	}
+
+	Algo::Sort(AllRefs, [](const FLineRef& A, const FLineRef& B)
+	{
+		if (A.TLKID != B.TLKID)
+			return A.TLKID < B.TLKID;
+		if (A.Conversation != B.Conversation)
+			return A.Conversation < B.Conversation;
+		return A.NodeIndex < B.NodeIndex;
+	});
+	AllRefs.SetNum(Algo::Unique(AllRefs, [](const FLineRef& A, const FLineRef& B)
+	{
+		return A.TLKID == B.TLKID && A.Conversation == B.Conversation && A.NodeIndex == B.NodeIndex;
+	}));
+
+	// Group refs by line and tokenize each line once; lines come in TLK order, so posting lists stay sorted
+	const TMap<int32, FString>& TLKStrings = DataManager.GetTLKStrings();
+	TArray<FLineEntry> LineEntries;
+	TArray<FRefEntry> RefEntries;
+	RefEntries.Reserve(AllRefs.Num());
+	TMap<FString, TArray<uint32>> WordPostings;
+	TArray<FString> LineWords;
+
+	for (const FLineRef& Ref : AllRefs)
+	{
+		if (LineEntries.Num() == 0 || LineEntries.Last().TLKID != Ref.TLKID)
+		{
+			LineEntries.Add({Ref.TLKID, static_cast<uint32>(RefEntries.Num()), 0});
+
+			if (const FString* Text = TLKStrings.Find(static_cast<int32>(Ref.TLKID)))
+			{
+				LineWords.Reset();
+				Tokenize(*Text, LineWords);
+				for (const FString& Word : LineWords)
+				{
+					WordPostings.FindOrAdd(Word).Add(Ref.TLKID);
+				}
+			}
+		}
+
+		RefEntries.Add({Ref.Conversation, Ref.NodeIndex});
+		++LineEntries.Last().NumRefs;
+	}
+
+	// Words sorted by UTF-8 bytes so lookups can binary search the mapped file without converting
+	struct FSortedWord
+	{
+		TArray<uint8> Bytes;
+		const TArray<uint32>* Postings;
+	};
+
+	TArray<FSortedWord> SortedWords;
+	SortedWords.Reserve(WordPostings.Num());
+	for (const TPair<FString, TArray<uint32>>& Pair : WordPostings)
+	{
+		SortedWords.Add({DialogSearchIndex::ToUTF8(Pair.Key), &Pair.Value});
+	}
+
+	Algo::Sort(SortedWords, [](const FSortedWord& A, const FSortedWord& B)
+	{
+		return DialogSearchIndex::CompareBytes(A.Bytes.GetData(), A.Bytes.Num(), B.Bytes.GetData(), B.Bytes.Num()) < 0;
+	});
+
+	TArray<uint8> StringPool;
+	TArray<FWordEntry> WordEntries;
+	TArray<uint32> PostingData;
+	WordEntries.Reserve(SortedWords.Num());
+	for (const FSortedWord& Word : SortedWords)
+	{
+		WordEntries.Add({static_cast<uint32>(StringPool.Num()), static_cast<uint32>(Word.Bytes.Num()),
+			static_cast<uint32>(PostingData.Num()), static_cast<uint32>(Word.Postings->Num())});
+		StringPool.Append(Word.Bytes);
+		PostingData.Append(*Word.Postings);
+	}
+
+	TArray<FConversationEntry> ConversationEntries;
+	ConversationEntries.Reserve(ConversationFiles.Num());
+	for (const FString& ConversationFile : ConversationFiles)
+	{
+		const TArray<uint8> Bytes = DialogSearchIndex::ToUTF8(ConversationFile);
+		ConversationEntries.Add({static_cast<uint32>(StringPool.Num()), static_cast<uint32>(Bytes.Num())});
+		StringPool.Append(Bytes);
+	}
+
+	FFileHeader FileHeader;
+	FileHeader.Magic = DialogSearchIndex::FileMagic;
+	FileHeader.Version = DialogSearchIndex::FileVersion;
+	FileHeader.SourceStamp = SourceStamp;
+	FileHeader.NumWords = WordEntries.Num();
+	FileHeader.NumPostings = PostingData.Num();
+	FileHeader.NumLines = LineEntries.Num();
+	FileHeader.NumRefs = RefEntries.Num();
+	FileHeader.NumConversations = ConversationEntries.Num();
+	FileHeader.StringBytes = StringPool.Num();
+
+	TArray<uint8> FileData;
+	auto AppendSection = [&FileData](const void* Data, int64 Size)
+	{
+		FileData.Append(static_cast<const uint8*>(Data), Size);
+	};
+
+	AppendSection(&FileHeader, sizeof(FileHeader));
+	AppendSection(WordEntries.GetData(), WordEntries.Num() * sizeof(FWordEntry));
+	AppendSection(PostingData.GetData(), PostingData.Num() * sizeof(uint32));
+	AppendSection(LineEntries.GetData(), LineEntries.Num() * sizeof(FLineEntry));
+	AppendSection(RefEntries.GetData(), RefEntries.Num() * sizeof(FRefEntry));
+	AppendSection(ConversationEntries.GetData(), ConversationEntries.Num() * sizeof(FConversationEntry));
+	AppendSection(StringPool.GetData(), StringPool.Num());
+
+	// Write next to the target and move over it, so a reader never maps a half-written file
+	const FString TempPath = IndexPath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(FileData, *TempPath) || !IFileManager::Get().Move(*IndexPath, *TempPath, true))
+	{
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to write search index: %s"), *IndexPath);
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("Built search index from %d conversations: %d words, %d lines, %d references, %.1f MB in %.2f s"),
+		ConversationFiles.Num(), WordEntries.Num(), LineEntries.Num(), RefEntries.Num(),
+		FileData.Num() / (1024.0 * 1024.0), FPlatformTime::Seconds() - StartTime);
+
+	return true;
+}
+
+bool FDialogSearchIndex::Open(const FString& IndexPath, uint64 SourceStamp)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*IndexPath))
+	{
+		return false;
+	}
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	MappedFile.Reset(PlatformFile.OpenMapped(*IndexPath));
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion());
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Platforms without file mapping read the whole file instead
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(LoadedData, *IndexPath))
+		{
+			return false;
+		}
+
+		Data = LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+
+	if (Size < static_cast<int64>(sizeof(FFileHeader)))
+	{
+		return false;
+	}
+
+	const FFileHeader* FileHeader = reinterpret_cast<const FFileHeader*>(Data);
+	if (FileHeader->Magic != DialogSearchIndex::FileMagic || FileHeader->Version != DialogSearchIndex::FileVersion
+		|| FileHeader->SourceStamp != SourceStamp)
+	{
+		return false;
+	}
+
+	// Sections must add up to the file size exactly
+	const uint64 ExpectedSize = sizeof(FFileHeader)
+		+ uint64(FileHeader->NumWords) * sizeof(FWordEntry)
+		+ uint64(FileHeader->NumPostings) * sizeof(uint32)
+		+ uint64(FileHeader->NumLines) * sizeof(FLineEntry)
+		+ uint64(FileHeader->NumRefs) * sizeof(FRefEntry)
+		+ uint64(FileHeader->NumConversations) * sizeof(FConversationEntry)
+		+ FileHeader->StringBytes;
+	if (ExpectedSize != static_cast<uint64>(Size))
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Search index %s is truncated or corrupt, rebuilding"), *IndexPath);
+		return false;
+	}
+
+	const uint8* Cursor = Data + sizeof(FFileHeader);
+	Words = reinterpret_cast<const FWordEntry*>(Cursor);
+	Cursor += FileHeader->NumWords * sizeof(FWordEntry);
+	Postings = reinterpret_cast<const uint32*>(Cursor);
+	Cursor += FileHeader->NumPostings * sizeof(uint32);
+	Lines = reinterpret_cast<const FLineEntry*>(Cursor);
+	Cursor += FileHeader->NumLines * sizeof(FLineEntry);
+	Refs = reinterpret_cast<const FRefEntry*>(Cursor);
+	Cursor += FileHeader->NumRefs * sizeof(FRefEntry);
+	Conversations = reinterpret_cast<const FConversationEntry*>(Cursor);
+	Cursor += FileHeader->NumConversations * sizeof(FConversationEntry);
+	Strings = Cursor;
+
+	Header = FileHeader;
+	return true;
+}
+
+void FDialogSearchIndex::Tokenize(FStringView Text, TArray<FString>& OutWords)
+{
+	FString Word;
+	bool bInTag = false;
+
+	auto EndWord = [&Word, &OutWords]()
+	{
+		if (!Word.IsEmpty())
+		{
+			OutWords.AddUnique(Word);
+			Word.Reset();
+		}
+	};
+
+	for (const TCHAR Char : Text)
+	{
+		if (bInTag)
+		{
+			bInTag = Char != TEXT('>');
+		}
+		else if (Char == TEXT('<'))
+		{
+			EndWord();
+			bInTag = true;
+		}
+		else if (FChar::IsAlnum(Char))
+		{
+			Word.AppendChar(FChar::ToLower(Char));
+		}
+		else if (Char != TEXT('\'') && Char != TCHAR(0x2019))
+		{
+			EndWord();
+		}
+	}
+
+	EndWord();
+}
+
+void FDialogSearchIndex::Search(FStringView Query, int32 MaxHits, TArray<FDialogSearchHit>& OutHits) const
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_SearchQuery);
+
+	OutHits.Reset();
+	if (!Header)
+	{
+		return;
+	}
+
+	TArray<FString> QueryWords;
+	Tokenize(Query, QueryWords);
+	if (QueryWords.Num() == 0)
+	{
+		return;
+	}
+
+	// Intersect the sorted posting lists, the last word matches as a prefix so results show up while typing
+	TArray<uint32> Matches;
+	TArray<uint32> WordMatches;
+	for (int32 WordIndex = 0; WordIndex < QueryWords.Num(); ++WordIndex)
+	{
+		FindWord(QueryWords[WordIndex], WordIndex == QueryWords.Num() - 1, WordMatches);
+
+		if (WordIndex == 0)
+		{
+			Matches = WordMatches;
+		}
+		else
+		{
+			Matches.RemoveAll([&WordMatches](uint32 TLKID) { return Algo::BinarySearch(WordMatches, TLKID) == INDEX_NONE; });
+		}
+
+		if (Matches.Num() == 0)
+		{
+			return;
+		}
+	}
+
+	const TConstArrayView<FLineEntry> LineView(Lines, Header->NumLines);
+	for (const uint32 TLKID : Matches)
+	{
+		const int32 LineIndex = Algo::BinarySearchBy(LineView, TLKID, &FLineEntry::TLKID);
+		if (LineIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FLineEntry& Line = LineView[LineIndex];
+		for (uint32 RefIndex = Line.FirstRef; RefIndex < Line.FirstRef + Line.NumRefs; ++RefIndex)
+		{
+			if (OutHits.Num() >= MaxHits)
+			{
+				return;
+			}
+
+			FDialogSearchHit& Hit = OutHits.AddDefaulted_GetRef();
+			Hit.ConversationPath = GetConversationPath(Refs[RefIndex].Conversation);
+			Hit.NodeIndex = Refs[RefIndex].NodeIndex;
+			Hit.TLKID = static_cast<int32>(TLKID);
+		}
+	}
+}
+
+void FDialogSearchIndex::FindWord(const FString& Word, bool bPrefix, TArray<uint32>& OutLines) const
+{
+	OutLines.Reset();
+
+	const TArray<uint8> WordBytes = DialogSearchIndex::ToUTF8(Word);
+	const int32 WordLength = WordBytes.Num();
+
+	// First stored word not less than Word
+	int32 Low = 0;
+	int32 High = Header->NumWords;
+	while (Low < High)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		const FWordEntry& Entry = Words[Mid];
+		if (DialogSearchIndex::CompareBytes(Strings + Entry.StringOffset, Entry.StringLength, WordBytes.GetData(), WordLength) < 0)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	// Exact match only, or every word sharing the prefix (they are contiguous)
+	int32 NumMatchedWords = 0;
+	for (int32 WordIndex = Low; WordIndex < static_cast<int32>(Header->NumWords); ++WordIndex)
+	{
+		const FWordEntry& Entry = Words[WordIndex];
+		if (Entry.StringLength < static_cast<uint32>(WordLength) || FMemory::Memcmp(Strings + Entry.StringOffset, WordBytes.GetData(), WordLength) != 0)
+		{
+			break;
+		}
+
+		if (!bPrefix && Entry.StringLength != static_cast<uint32>(WordLength))
+		{
+			break;
+		}
+
+		OutLines.Append(Postings + Entry.FirstPosting, Entry.NumPostings);
+		++NumMatchedWords;
+
+		if (!bPrefix)
+		{
+			break;
+		}
+	}
+
+	if (NumMatchedWords > 1)
+	{
+		OutLines.Sort();
+		OutLines.SetNum(Algo::Unique(OutLines));
+	}
+}
+
+FString FDialogSearchIndex::GetConversationPath(uint32 ConversationIndex) const
+{
+	const FConversationEntry& Entry = Conversations[ConversationIndex];
+	FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Strings + Entry.StringOffset), Entry.StringLength);
+	return FString(Converted.Length(), Converted.Get());
+}
+
+int32 FDialogSearchIndex::GetNumWords() const
+{
+	return Header ? Header->NumWords : 0;
+}
+
+int32 FDialogSearchIndex::GetNumLines() const
+{
+	return Header ? Header->NumLines : 0;
+}
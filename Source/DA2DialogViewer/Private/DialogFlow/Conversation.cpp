@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DialogFlow/Conversation.h"
+#include "DA2DialogViewerLog.h"
 
 FConversation::FConversation()
 {
@@ -12,6 +13,12 @@ FConversation::~FConversation()
 
 const FDialogNode* FConversation::FindNode(int32 NodeIndex) const
 {
+	// The parser numbers nodes in array order, so this is almost always a direct hit
+	if (Nodes.IsValidIndex(NodeIndex) && Nodes[NodeIndex].NodeIndex == NodeIndex)
+	{
+		return &Nodes[NodeIndex];
+	}
+
 	for (const FDialogNode& Node : Nodes)
 	{
 		if (Node.NodeIndex == NodeIndex)
@@ -24,14 +31,7 @@ const FDialogNode* FConversation::FindNode(int32 NodeIndex) const
 
 FDialogNode* FConversation::FindNode(int32 NodeIndex)
 {
-	for (FDialogNode& Node : Nodes)
-	{
-		if (Node.NodeIndex == NodeIndex)
-		{
-			return &Node;
-		}
-	}
-	return nullptr;
+	return const_cast<FDialogNode*>(static_cast<const FConversation*>(this)->FindNode(NodeIndex));
 }
 
 TArray<int32> FConversation::GetEntryNodeIndices() const
@@ -51,25 +51,47 @@ void FConversation::Clear()
 	Nodes.Empty();
 }
 
+SIZE_T FConversation::GetAllocatedSize() const
+{
+	SIZE_T Size = ConversationName.GetAllocatedSize() + OwnerTag.GetAllocatedSize();
+	Size += EntryLinks.GetAllocatedSize();
+	Size += Nodes.GetAllocatedSize();
+
+	for (const FDialogNode& Node : Nodes)
+	{
+		Size += Node.Links.GetAllocatedSize();
+		Size += Node.DebugText.GetAllocatedSize();
+		Size += Node.Condition.PlotName.GetAllocatedSize();
+		Size += Node.Action.PlotName.GetAllocatedSize();
+
+		for (const FDialogLink& Link : Node.Links)
+		{
+			Size += Link.PreviewText.GetAllocatedSize();
+		}
+	}
+
+	return Size;
+}
+
 void FConversation::DebugPrint() const
 {
-	UE_LOG(LogTemp, Log, TEXT("=== Conversation: %s ==="), *ConversationName);
-	UE_LOG(LogTemp, Log, TEXT("Entry Links: %d"), EntryLinks.Num());
+	UE_LOG(LogDA2Dialog, Log, TEXT("=== Conversation: %s ==="), *ConversationName);
+	UE_LOG(LogDA2Dialog, Log, TEXT("Entry Links: %d"), EntryLinks.Num());
 	for (int32 i = 0; i < EntryLinks.Num(); ++i)
 	{
 		const FDialogEntryLink& Entry = EntryLinks[i];
-		UE_LOG(LogTemp, Log, TEXT("  Entry %d -> Node %d"), i, Entry.TargetNodeIndex);
+		UE_LOG(LogDA2Dialog, Log, TEXT("  Entry %d -> Node %d"), i, Entry.TargetNodeIndex);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Nodes: %d"), Nodes.Num());
+	UE_LOG(LogDA2Dialog, Log, TEXT("Nodes: %d"), Nodes.Num());
 	for (const FDialogNode& Node : Nodes)
 	{
-		UE_LOG(LogTemp, Log, TEXT("  Node %d: Speaker=%d, TLK=%d, Links=%d"),
+		UE_LOG(LogDA2Dialog, Log, TEXT("  Node %d: Speaker=%d, TLK=%d, Links=%d"),
 			Node.NodeIndex, Node.SpeakerID, Node.TLKStringID, Node.Links.Num());
 
 		for (const FDialogLink& Link : Node.Links)
 		{
-			UE_LOG(LogTemp, Log, TEXT("    -> Node %d (Type=%d)"),
+			UE_LOG(LogDA2Dialog, Log, TEXT("    -> Node %d (Type=%d)"),
 				Link.TargetNodeIndex, (uint8)Link.ResponseType);
 		}
 	}
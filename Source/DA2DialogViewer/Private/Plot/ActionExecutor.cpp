@@ -2,6 +2,7 @@
 
 #include "Plot/ActionExecutor.h"
 #include "Plot/PlotState.h"
+#include "DA2DialogViewerLog.h"
 
 void FActionExecutor::ExecuteAction(const FPlotReference& Action, FPlotState& PlotState)
 {
@@ -24,7 +25,7 @@ void FActionExecutor::ExecuteAction(const FPlotReference& Action, FPlotState& Pl
 	// Set the flag
 	PlotState.SetFlag(Action.PlotName, Action.FlagIndex, ValueToSet);
 
-	UE_LOG(LogTemp, Log, TEXT("ActionExecutor: Set %s[%d] = %d"),
+	DA2_LOG(bActions, Verbose, TEXT("ActionExecutor: Set %s[%d] = %d"),
 		*Action.PlotName, Action.FlagIndex, ValueToSet);
 }
 
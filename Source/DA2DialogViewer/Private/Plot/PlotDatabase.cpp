@@ -2,6 +2,7 @@
 
 #include "Plot/PlotDatabase.h"
 #include "Data/DialogCSVReader.h"
+#include "DA2DialogViewerLog.h"
 
 FPlotDatabase::FPlotDatabase()
 {
@@ -18,7 +19,7 @@ bool FPlotDatabase::LoadPlotsCSV(const FString& CSVPath)
 	// Load plot name -> GUID mapping
 	if (!FDialogCSVReader::ReadPlotsCSV(CSVPath, PlotToGUID))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to load plots CSV: %s"), *CSVPath);
+		UE_LOG(LogDA2Dialog, Error, TEXT("Failed to load plots CSV: %s"), *CSVPath);
 		return false;
 	}
 
@@ -28,7 +29,7 @@ bool FPlotDatabase::LoadPlotsCSV(const FString& CSVPath)
 		GUIDToPlot.Add(Pair.Value, Pair.Key);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Loaded %d plots into database"), PlotToGUID.Num());
+	UE_LOG(LogDA2Dialog, Log, TEXT("Loaded %d plots into database"), PlotToGUID.Num());
 	return true;
 }
 
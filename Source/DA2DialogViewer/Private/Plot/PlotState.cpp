@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Plot/PlotState.h"
+#include "DA2DialogViewerLog.h"
 
 FPlotState::FPlotState()
 {
@@ -20,7 +21,7 @@ void FPlotState::SetFlag(const FString& PlotName, int32 FlagIndex, int32 Value)
 	FString Key = MakeKey(PlotName, FlagIndex);
 	FlagValues.Add(Key, Value);
 
-	UE_LOG(LogTemp, Verbose, TEXT("PlotState: Set %s[%d] = %d"), *PlotName, FlagIndex, Value);
+	DA2_LOG(bActions, Verbose, TEXT("PlotState: Set %s[%d] = %d"), *PlotName, FlagIndex, Value);
 }
 
 int32 FPlotState::GetFlag(const FString& PlotName, int32 FlagIndex) const
@@ -58,10 +59,10 @@ void FPlotState::Reset()
 
 void FPlotState::DebugPrint() const
 {
-	UE_LOG(LogTemp, Log, TEXT("=== Plot State (%d flags) ==="), FlagValues.Num());
+	UE_LOG(LogDA2Dialog, Log, TEXT("=== Plot State (%d flags) ==="), FlagValues.Num());
 	for (const TPair<FString, int32>& Pair : FlagValues)
 	{
-		UE_LOG(LogTemp, Log, TEXT("  %s = %d"), *Pair.Key, Pair.Value);
+		UE_LOG(LogDA2Dialog, Log, TEXT("  %s = %d"), *Pair.Key, Pair.Value);
 	}
 }
 
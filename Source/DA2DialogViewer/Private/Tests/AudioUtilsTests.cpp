@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Audio/AudioUtils.h"
+#include "Math/RandomStream.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAudioUtilsFileIDTest, "DA2Dialog.AudioUtils.FileID",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FAudioUtilsFileIDTest::RunTest(const FString& Parameters)
+{
+	// Real TLK IDs are mostly 6-8 digits; mix in short, negative and extreme ones so every key length is covered
+	const int32 NumIDs = 100000;
+	FRandomStream Random(NumIDs);
+	TArray<int32> TLKIDs;
+	TLKIDs.SetNumUninitialized(NumIDs);
+	for (int32 i = 0; i < NumIDs; ++i)
+	{
+		TLKIDs[i] = Random.RandRange(100000, 99999999);
+	}
+	const int32 EdgeCases[] = {0, 7, -1, MAX_int32, MIN_int32, 6000680};
+	for (int32 i = 0; i < UE_ARRAY_COUNT(EdgeCases); ++i)
+	{
+		TLKIDs[i * 3] = EdgeCases[i];
+	}
+
+	TArray<uint32> StringIDs, ScalarIDs, BulkIDs;
+	StringIDs.SetNumUninitialized(NumIDs);
+	ScalarIDs.SetNumUninitialized(NumIDs);
+	BulkIDs.SetNumUninitialized(NumIDs);
+
+	double StringMs = 0.0, ScalarMs = 0.0, BulkMs = 0.0;
+	for (const bool bIsMale : {true, false})
+	{
+		// Reference: build the "<TLKID>_<m|f>" key as a string and hash it
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumIDs; ++i)
+		{
+			StringIDs[i] = FAudioUtils::ComputeFNV32Hash(FString::Printf(TEXT("%d_%s"), TLKIDs[i], bIsMale ? TEXT("m") : TEXT("f")));
+		}
+		StringMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumIDs; ++i)
+		{
+			ScalarIDs[i] = FAudioUtils::ComputeAudioFileID(TLKIDs[i], bIsMale);
+		}
+		ScalarMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		StartTime = FPlatformTime::Seconds();
+		FAudioUtils::ComputeAudioFileIDs(TLKIDs, bIsMale, BulkIDs);
+		BulkMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		for (int32 i = 0; i < NumIDs; ++i)
+		{
+			if (StringIDs[i] != ScalarIDs[i] || StringIDs[i] != BulkIDs[i])
+			{
+				AddError(FString::Printf(TEXT("TLK %d (%s) hashed to %u (string), %u (scalar), %u (bulk)"),
+					TLKIDs[i], bIsMale ? TEXT("m") : TEXT("f"), StringIDs[i], ScalarIDs[i], BulkIDs[i]));
+				break;
+			}
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("%d IDs x 2 genders: string %.2f ms, scalar %.2f ms, bulk %.2f ms"), NumIDs, StringMs, ScalarMs, BulkMs));
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
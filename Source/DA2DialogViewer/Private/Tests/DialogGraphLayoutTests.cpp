@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/DialogTestConversations.h"
+#include "UI/DialogGraphLayout.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDialogGraphLayoutTest, "DA2Dialog.GraphLayout.Compute",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDialogGraphLayoutTest::RunTest(const FString& Parameters)
+{
+	const int32 NumNodes = 5000;
+	const TSharedPtr<FConversation> Graph = DialogTestConversations::MakeBranching(NumNodes);
+	const FDialogGraphLayoutSettings Settings;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const TSharedPtr<const FDialogGraphLayout> Layout = FDialogGraphLayout::Compute(Graph, Settings);
+	const double FullMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	if (!TestTrue(TEXT("Layout computed"), Layout.IsValid()))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Every node has a position"), Layout->NodePositions.Num(), NumNodes);
+	TestTrue(TEXT("Layout finishes within a second"), FullMs < 1000.0);
+
+	for (int32 LayerIndex = 0; LayerIndex < Layout->Layers.Num() && !HasAnyErrors(); ++LayerIndex)
+	{
+		const TArray<int32>& Layer = Layout->Layers[LayerIndex];
+		for (int32 i = 1; i < Layer.Num(); ++i)
+		{
+			const double Gap = Layout->NodePositions[Layer[i]].X - Layout->NodePositions[Layer[i - 1]].X;
+			if (Gap < Settings.NodeSpacing - 0.01)
+			{
+				AddError(FString::Printf(TEXT("Layer %d: nodes %d and %d overlap or are out of order"), LayerIndex, Layer[i - 1], Layer[i]));
+				break;
+			}
+		}
+	}
+
+	// Relayout with different spacing should reuse layering and ordering
+	FDialogGraphLayoutSettings WideSettings = Settings;
+	WideSettings.NodeSpacing *= 1.5f;
+
+	const double IncrementalStartTime = FPlatformTime::Seconds();
+	const TSharedPtr<const FDialogGraphLayout> Relayout = FDialogGraphLayout::Compute(Graph, WideSettings, Layout);
+	const double IncrementalMs = (FPlatformTime::Seconds() - IncrementalStartTime) * 1000.0;
+	TestTrue(TEXT("Relayout of an unchanged graph is incremental"), Relayout.IsValid() && Relayout->bWasIncremental);
+
+	AddInfo(FString::Printf(TEXT("Layout of %d nodes: full %.1f ms, incremental %.1f ms"), NumNodes, FullMs, IncrementalMs));
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DialogFlow/Conversation.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Synthetic conversations for the automation tests
+ */
+namespace DialogTestConversations
+{
+	// Mostly forward branching with some links back up the conversation, like real dialog graphs
+	inline TSharedPtr<FConversation> MakeBranching(int32 NumNodes)
+	{
+		FRandomStream Random(NumNodes);
+		TSharedPtr<FConversation> Graph = MakeShared<FConversation>();
+		Graph->ConversationName = FString::Printf(TEXT("test_branching_%d"), NumNodes);
+		Graph->Nodes.SetNum(NumNodes);
+		for (int32 i = 0; i < NumNodes; ++i)
+		{
+			FDialogNode& Node = Graph->Nodes[i];
+			Node.NodeIndex = i;
+
+			const int32 NumLinks = (i == NumNodes - 1) ? 0 : Random.RandRange(1, 3);
+			for (int32 LinkIndex = 0; LinkIndex < NumLinks; ++LinkIndex)
+			{
+				FDialogLink& Link = Node.Links.AddDefaulted_GetRef();
+				Link.TargetNodeIndex = FMath::Min(i + Random.RandRange(1, 50), NumNodes - 1);
+			}
+
+			if (i > 0 && Random.FRand() < 0.1f)
+			{
+				Node.Links.AddDefaulted_GetRef().TargetNodeIndex = Random.RandRange(0, i - 1);
+			}
+		}
+		Graph->EntryLinks.AddDefaulted_GetRef().TargetNodeIndex = 0;
+		return Graph;
+	}
+
+	// Node i links to node i + 1, the last node links back to node 0; speakers alternate NPC / player
+	// A second entry points into the middle of the chain, so it must come out as a reference root
+	inline TSharedPtr<FConversation> MakeCyclicChain(int32 ChainDepth)
+	{
+		TSharedPtr<FConversation> Chain = MakeShared<FConversation>();
+		Chain->ConversationName = FString::Printf(TEXT("test_chain_%d"), ChainDepth);
+		Chain->Nodes.SetNum(ChainDepth);
+		for (int32 i = 0; i < ChainDepth; ++i)
+		{
+			FDialogNode& Node = Chain->Nodes[i];
+			Node.NodeIndex = i;
+			Node.SpeakerID = (i % 2 == 0) ? 257 : 1;
+
+			FDialogLink& Link = Node.Links.AddDefaulted_GetRef();
+			Link.TargetNodeIndex = (i + 1) % ChainDepth;
+		}
+
+		Chain->EntryLinks.AddDefaulted_GetRef().TargetNodeIndex = 0;
+		Chain->EntryLinks.AddDefaulted_GetRef().TargetNodeIndex = ChainDepth / 2;
+		return Chain;
+	}
+}
+
+#endif
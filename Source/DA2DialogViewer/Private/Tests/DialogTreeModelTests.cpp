@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/DialogTestConversations.h"
+#include "UI/DialogTreeModel.h"
+#include "HAL/IConsoleManager.h"
+#include "DA2DialogViewerLog.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDialogTreeModelDeepChainTest, "DA2Dialog.TreeModel.DeepChain",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDialogTreeModelDeepChainTest::RunTest(const FString& Parameters)
+{
+	// Deep enough that a recursive walk would overflow the stack
+	const int32 ChainDepth = 100000;
+	const int32 MiddleNodeIndex = ChainDepth / 2;
+	const TSharedPtr<FConversation> Chain = DialogTestConversations::MakeCyclicChain(ChainDepth);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const TSharedPtr<const FDialogTreeModel> Model = FDialogTreeModel::Build(Chain);
+	const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	if (!TestTrue(TEXT("Model built"), Model.IsValid()))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Every node is reachable"), Model->FirstOccurrences.Num(), ChainDepth);
+	TestEqual(TEXT("Row bound is entries + links"), Model->MaxTreeItems, Chain->EntryLinks.Num() + ChainDepth);
+	TestEqual(TEXT("Start node appears as root and as the cycle's reference"), Model->GetNumOccurrences(0), 2);
+	TestEqual(TEXT("Middle node appears in the chain and as a reference root"), Model->GetNumOccurrences(MiddleNodeIndex), 2);
+
+	for (int32 i = 0; i < ChainDepth; ++i)
+	{
+		const FDialogOccurrence* Occurrence = Model->FindFirstOccurrence(i);
+		const int32 ExpectedParent = (i == 0) ? INDEX_NONE : i - 1;
+		if (!Occurrence || Occurrence->ParentNodeIndex != ExpectedParent || Occurrence->LinkIndex != 0)
+		{
+			AddError(FString::Printf(TEXT("Node %d: first occurrence should follow the chain in depth-first order"), i));
+			break;
+		}
+		if (Occurrence->bIsNPCTurn != (i % 2 == 0))
+		{
+			AddError(FString::Printf(TEXT("Node %d: turns should alternate down the chain"), i));
+			break;
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Model build for %d nodes: %.2f ms"), ChainDepth, BuildMs));
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDialogTreeModelBuildLoggingTest, "DA2Dialog.TreeModel.BuildLogging",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDialogTreeModelBuildLoggingTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* TreeBuildSwitch = IConsoleManager::Get().FindConsoleVariable(TEXT("DA2Dialog.Log.TreeBuild"));
+	if (!TestNotNull(TEXT("DA2Dialog.Log.TreeBuild is registered"), TreeBuildSwitch))
+	{
+		return false;
+	}
+
+	// Party conditions on every fourth node, and speaker 257 below them, put the build on its per-node logging path
+	auto AddPartyConditions = [](FConversation& Conversation)
+	{
+		for (int32 i = 0; i < Conversation.Nodes.Num(); ++i)
+		{
+			FDialogNode& Node = Conversation.Nodes[i];
+			Node.SpeakerID = 257;
+			if (i % 4 == 0)
+			{
+				Node.Condition.PlotName = TEXT("gen00pt_party");
+				Node.Condition.FlagIndex = i % 16;
+			}
+		}
+	};
+
+	const TSharedPtr<FConversation> Graphs[] = {
+		DialogTestConversations::MakeBranching(2000),
+		DialogTestConversations::MakeCyclicChain(20000),
+	};
+
+	const int32 Iterations = 5;
+	const bool bSavedSwitch = TreeBuildSwitch->GetBool();
+	const ELogVerbosity::Type SavedVerbosity = LogDA2Dialog.GetVerbosity();
+
+	auto TimeBuildsMs = [Iterations](const TSharedPtr<FConversation>& Conversation)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			FDialogTreeModel::Build(Conversation);
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+	};
+
+	for (const TSharedPtr<FConversation>& Graph : Graphs)
+	{
+		AddPartyConditions(*Graph);
+		TestTrue(FString::Printf(TEXT("%s builds"), *Graph->ConversationName), FDialogTreeModel::Build(Graph).IsValid());
+
+		// Worst case: switch on and the category opened up to VeryVerbose
+		LogDA2Dialog.SetVerbosity(ELogVerbosity::VeryVerbose);
+		TreeBuildSwitch->Set(true);
+		const double LoggingOnMs = TimeBuildsMs(Graph);
+
+		// Default: switch off
+		LogDA2Dialog.SetVerbosity(SavedVerbosity);
+		TreeBuildSwitch->Set(false);
+		const double LoggingOffMs = TimeBuildsMs(Graph);
+
+		AddInfo(FString::Printf(TEXT("%s (%d nodes, verbose logging %s): logging on %.3f ms, logging off %.3f ms per build (%.2fx)"),
+			*Graph->ConversationName, Graph->Nodes.Num(), DA2DIALOG_VERBOSE_LOGGING ? TEXT("compiled in") : TEXT("compiled out"),
+			LoggingOnMs, LoggingOffMs, LoggingOffMs > 0.0 ? LoggingOnMs / LoggingOffMs : 0.0));
+	}
+
+	TreeBuildSwitch->Set(bSavedSwitch);
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
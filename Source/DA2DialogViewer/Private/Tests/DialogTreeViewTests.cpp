@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/DialogTestConversations.h"
+#include "UI/SDialogTreeView.h"
+#include "UI/DialogTreeModel.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDialogTreeViewNavigationTest, "DA2Dialog.TreeView.Navigation",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDialogTreeViewNavigationTest::RunTest(const FString& Parameters)
+{
+	// Every wheel click and reference jump looks a node up like this; the first pass also materializes each path
+	const TSharedPtr<FConversation> Conversation = DialogTestConversations::MakeBranching(2000);
+	const TSharedPtr<const FDialogTreeModel> Model = FDialogTreeModel::Build(Conversation);
+	if (!TestTrue(TEXT("Model built"), Model.IsValid()))
+	{
+		return false;
+	}
+
+	TArray<int32> NodeIndices;
+	Model->FirstOccurrences.GenerateKeyArray(NodeIndices);
+
+	TSharedRef<SDialogTreeView> TreeView = SNew(SDialogTreeView, nullptr);
+	TreeView->LoadModel(Model);
+
+	auto TimeLookups = [this, &TreeView, &NodeIndices](double& OutMaxUs)
+	{
+		OutMaxUs = 0.0;
+		double TotalUs = 0.0;
+		for (const int32 NodeIndex : NodeIndices)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			TreeView->NavigateToNode(NodeIndex);
+			const double ElapsedUs = (FPlatformTime::Seconds() - StartTime) * 1000000.0;
+
+			TotalUs += ElapsedUs;
+			OutMaxUs = FMath::Max(OutMaxUs, ElapsedUs);
+
+			const FDialogNode* Selected = TreeView->GetSelectedNode();
+			if (!TestTrue(FString::Printf(TEXT("Node %d is selected after navigating to it"), NodeIndex), Selected && Selected->NodeIndex == NodeIndex))
+			{
+				break;
+			}
+		}
+		return NodeIndices.Num() > 0 ? TotalUs / NodeIndices.Num() : 0.0;
+	};
+
+	double FreshMaxUs = 0.0;
+	double WarmMaxUs = 0.0;
+	const double FreshAvgUs = TimeLookups(FreshMaxUs);
+	const double WarmAvgUs = TimeLookups(WarmMaxUs);
+
+	AddInfo(FString::Printf(TEXT("Navigation (%d reachable nodes): fresh tree avg %.2f us / max %.2f us, warm tree avg %.2f us / max %.2f us"),
+		NodeIndices.Num(), FreshAvgUs, FreshMaxUs, WarmAvgUs, WarmMaxUs));
+
+	return !HasAnyErrors();
+}
+
+#endif
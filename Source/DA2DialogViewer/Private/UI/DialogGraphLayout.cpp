@@ -0,0 +1,384 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/DialogGraphLayout.h"
+#include "DialogFlow/Conversation.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
+
+TSharedPtr<const FDialogGraphLayout> FDialogGraphLayout::Compute(TSharedPtr<FConversation> InConversation, const FDialogGraphLayoutSettings& Settings,
+	TSharedPtr<const FDialogGraphLayout> Previous, const std::atomic<bool>* bCancelled)
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_GraphLayout);
+
+	if (!InConversation.IsValid())
+		return nullptr;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumNodes = InConversation->Nodes.Num();
+
+	TSharedPtr<FDialogGraphLayout> Layout = MakeShared<FDialogGraphLayout>();
+	Layout->Conversation = InConversation;
+
+	FAdjacency Links;
+	Layout->StructureHash = BuildAdjacency(*InConversation, Links);
+
+	FAdjacency Up;
+	FAdjacency Down;
+
+	// Same structure: layering and ordering still hold, only the coordinates need redoing
+	if (Previous.IsValid() && Previous->StructureHash == Layout->StructureHash && Previous->NodeLayers.Num() == NumNodes)
+	{
+		Layout->NodeLayers = Previous->NodeLayers;
+		Layout->Layers = Previous->Layers;
+		Layout->bWasIncremental = true;
+		Layout->BuildLayerAdjacency(Links, Up, Down);
+	}
+	else
+	{
+		if (!Layout->AssignLayers(Links, bCancelled))
+			return nullptr;
+
+		Layout->BuildLayerAdjacency(Links, Up, Down);
+
+		if (!Layout->MinimizeCrossings(Up, Down, Settings.CrossingSweeps, bCancelled))
+			return nullptr;
+	}
+
+	Layout->AssignCoordinates(Up, Down, Settings);
+
+	if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+		return nullptr;
+
+	UE_LOG(LogDA2Dialog, Log, TEXT("Graph layout: %d nodes in %d layers (%s) in %.1f ms"),
+		NumNodes, Layout->Layers.Num(), Layout->bWasIncremental ? TEXT("incremental") : TEXT("full"),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return Layout;
+}
+
+uint32 FDialogGraphLayout::BuildAdjacency(const FConversation& InConversation, FAdjacency& OutLinks)
+{
+	const int32 NumNodes = InConversation.Nodes.Num();
+	uint32 Hash = GetTypeHash(NumNodes);
+
+	OutLinks.Starts.SetNumUninitialized(NumNodes + 1);
+	OutLinks.Targets.Reset();
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		OutLinks.Starts[Node] = OutLinks.Targets.Num();
+		for (const FDialogLink& Link : InConversation.Nodes[Node].Links)
+		{
+			const FDialogNode* Target = InConversation.FindNode(Link.TargetNodeIndex);
+			if (!Target)
+				continue;
+
+			const int32 TargetIndex = static_cast<int32>(Target - InConversation.Nodes.GetData());
+			OutLinks.Targets.Add(TargetIndex);
+			Hash = HashCombine(Hash, GetTypeHash(TargetIndex));
+		}
+		Hash = HashCombine(Hash, GetTypeHash(OutLinks.Targets.Num()));
+	}
+	OutLinks.Starts[NumNodes] = OutLinks.Targets.Num();
+
+	// Entry links decide the layering too
+	for (const FDialogEntryLink& EntryLink : InConversation.EntryLinks)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(EntryLink.TargetNodeIndex));
+	}
+
+	return Hash;
+}
+
+void FDialogGraphLayout::BuildLayerAdjacency(const FAdjacency& Links, FAdjacency& OutUp, FAdjacency& OutDown) const
+{
+	const int32 NumNodes = NodeLayers.Num();
+
+	// Every link between neighbouring layers counts, whichever way it points
+	auto ForEachLayerPair = [this, &Links, NumNodes](auto&& Visit)
+	{
+		for (int32 From = 0; From < NumNodes; ++From)
+		{
+			for (const int32 To : Links.Get(From))
+			{
+				if (NodeLayers[To] == NodeLayers[From] + 1)
+				{
+					Visit(From, To);
+				}
+				else if (NodeLayers[From] == NodeLayers[To] + 1)
+				{
+					Visit(To, From);
+				}
+			}
+		}
+	};
+
+	// Count (shifted by one so the prefix sum turns counts into start offsets), then fill
+	OutUp.Starts.SetNumZeroed(NumNodes + 1);
+	OutDown.Starts.SetNumZeroed(NumNodes + 1);
+	ForEachLayerPair([&OutUp, &OutDown](int32 Upper, int32 Lower)
+	{
+		++OutDown.Starts[Upper + 1];
+		++OutUp.Starts[Lower + 1];
+	});
+
+	for (int32 Node = 1; Node <= NumNodes; ++Node)
+	{
+		OutUp.Starts[Node] += OutUp.Starts[Node - 1];
+		OutDown.Starts[Node] += OutDown.Starts[Node - 1];
+	}
+
+	OutUp.Targets.SetNumUninitialized(OutUp.Starts.Last());
+	OutDown.Targets.SetNumUninitialized(OutDown.Starts.Last());
+
+	TArray<int32> UpCursors(OutUp.Starts.GetData(), NumNodes);
+	TArray<int32> DownCursors(OutDown.Starts.GetData(), NumNodes);
+	ForEachLayerPair([&](int32 Upper, int32 Lower)
+	{
+		OutDown.Targets[DownCursors[Upper]++] = Lower;
+		OutUp.Targets[UpCursors[Lower]++] = Upper;
+	});
+}
+
+bool FDialogGraphLayout::AssignLayers(const FAdjacency& Links, const std::atomic<bool>* bCancelled)
+{
+	const int32 NumNodes = Conversation->Nodes.Num();
+	NodeLayers.Init(INDEX_NONE, NumNodes);
+
+	// Breadth-first: a node's layer is its shortest distance from an entry, so forward links span exactly one layer
+	// The queue doubles as the discovery order, which is the starting order within each layer
+	TArray<int32> Queue;
+	Queue.Reserve(NumNodes);
+	int32 QueueHead = 0;
+
+	auto Seed = [this, &Queue](int32 Node)
+	{
+		if (NodeLayers[Node] == INDEX_NONE)
+		{
+			NodeLayers[Node] = 0;
+			Queue.Add(Node);
+		}
+	};
+
+	auto Drain = [this, &Links, &Queue, &QueueHead, bCancelled]()
+	{
+		while (QueueHead < Queue.Num())
+		{
+			if ((QueueHead & 1023) == 0 && bCancelled && bCancelled->load(std::memory_order_relaxed))
+				return false;
+
+			const int32 Node = Queue[QueueHead++];
+			for (const int32 Target : Links.Get(Node))
+			{
+				if (NodeLayers[Target] == INDEX_NONE)
+				{
+					NodeLayers[Target] = NodeLayers[Node] + 1;
+					Queue.Add(Target);
+				}
+			}
+		}
+		return true;
+	};
+
+	for (const FDialogEntryLink& EntryLink : Conversation->EntryLinks)
+	{
+		if (const FDialogNode* EntryNode = Conversation->FindNode(EntryLink.TargetNodeIndex))
+		{
+			Seed(static_cast<int32>(EntryNode - Conversation->Nodes.GetData()));
+		}
+	}
+
+	if (!Drain())
+		return false;
+
+	// Nodes no entry reaches (cut content) start their own walks at the top
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		if (NodeLayers[Node] == INDEX_NONE)
+		{
+			Seed(Node);
+			if (!Drain())
+				return false;
+		}
+	}
+
+	int32 MaxLayer = 0;
+	for (const int32 Layer : NodeLayers)
+	{
+		MaxLayer = FMath::Max(MaxLayer, Layer);
+	}
+
+	Layers.Reset();
+	Layers.SetNum(NumNodes > 0 ? MaxLayer + 1 : 0);
+	for (const int32 Node : Queue)
+	{
+		Layers[NodeLayers[Node]].Add(Node);
+	}
+
+	return true;
+}
+
+bool FDialogGraphLayout::MinimizeCrossings(const FAdjacency& Up, const FAdjacency& Down, int32 NumSweeps, const std::atomic<bool>* bCancelled)
+{
+	const int32 NumNodes = NodeLayers.Num();
+
+	TArray<int32> PositionInLayer;
+	PositionInLayer.SetNumUninitialized(NumNodes);
+	for (const TArray<int32>& Layer : Layers)
+	{
+		for (int32 i = 0; i < Layer.Num(); ++i)
+		{
+			PositionInLayer[Layer[i]] = i;
+		}
+	}
+
+	TArray<float> Barycenters;
+	Barycenters.SetNumUninitialized(NumNodes);
+
+	// Sort one layer by the mean position of each node's neighbours in the fixed adjacent layer
+	// Nodes without neighbours there keep their current position
+	auto SortLayer = [&PositionInLayer, &Barycenters](TArray<int32>& Layer, const FAdjacency& Neighbours)
+	{
+		for (const int32 Node : Layer)
+		{
+			const TConstArrayView<int32> NodeNeighbours = Neighbours.Get(Node);
+			if (NodeNeighbours.Num() == 0)
+			{
+				Barycenters[Node] = static_cast<float>(PositionInLayer[Node]);
+				continue;
+			}
+
+			int32 Sum = 0;
+			for (const int32 Neighbour : NodeNeighbours)
+			{
+				Sum += PositionInLayer[Neighbour];
+			}
+			Barycenters[Node] = static_cast<float>(Sum) / NodeNeighbours.Num();
+		}
+
+		Layer.StableSort([&Barycenters](int32 A, int32 B) { return Barycenters[A] < Barycenters[B]; });
+
+		for (int32 i = 0; i < Layer.Num(); ++i)
+		{
+			PositionInLayer[Layer[i]] = i;
+		}
+	};
+
+	for (int32 Sweep = 0; Sweep < NumSweeps; ++Sweep)
+	{
+		if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+			return false;
+
+		for (int32 LayerIndex = 1; LayerIndex < Layers.Num(); ++LayerIndex)
+		{
+			SortLayer(Layers[LayerIndex], Up);
+		}
+
+		for (int32 LayerIndex = Layers.Num() - 2; LayerIndex >= 0; --LayerIndex)
+		{
+			SortLayer(Layers[LayerIndex], Down);
+		}
+	}
+
+	return true;
+}
+
+void FDialogGraphLayout::AssignCoordinates(const FAdjacency& Up, const FAdjacency& Down, const FDialogGraphLayoutSettings& Settings)
+{
+	const int32 NumNodes = NodeLayers.Num();
+	const double Spacing = Settings.NodeSpacing;
+
+	// Start packed left to right in layer order
+	TArray<double> X;
+	X.SetNumUninitialized(NumNodes);
+	for (const TArray<int32>& Layer : Layers)
+	{
+		for (int32 i = 0; i < Layer.Num(); ++i)
+		{
+			X[Layer[i]] = i * Spacing;
+		}
+	}
+
+	TArray<double> Desired;
+	TArray<double> PackedLeft;
+	TArray<double> PackedRight;
+
+	// Pull every node in a layer toward the mean x of its neighbours in the adjacent layer
+	// Packing toward the desired positions from both ends and averaging keeps the order and the minimum separation
+	auto AlignLayer = [&](const TArray<int32>& Layer, const FAdjacency& Neighbours)
+	{
+		const int32 Num = Layer.Num();
+		if (Num == 0)
+			return;
+
+		Desired.SetNumUninitialized(Num);
+		PackedLeft.SetNumUninitialized(Num);
+		PackedRight.SetNumUninitialized(Num);
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const TConstArrayView<int32> NodeNeighbours = Neighbours.Get(Layer[i]);
+			if (NodeNeighbours.Num() == 0)
+			{
+				Desired[i] = X[Layer[i]];
+				continue;
+			}
+
+			double Sum = 0.0;
+			for (const int32 Neighbour : NodeNeighbours)
+			{
+				Sum += X[Neighbour];
+			}
+			Desired[i] = Sum / NodeNeighbours.Num();
+		}
+
+		PackedLeft[0] = Desired[0];
+		for (int32 i = 1; i < Num; ++i)
+		{
+			PackedLeft[i] = FMath::Max(Desired[i], PackedLeft[i - 1] + Spacing);
+		}
+
+		PackedRight[Num - 1] = Desired[Num - 1];
+		for (int32 i = Num - 2; i >= 0; --i)
+		{
+			PackedRight[i] = FMath::Min(Desired[i], PackedRight[i + 1] - Spacing);
+		}
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			X[Layer[i]] = 0.5 * (PackedLeft[i] + PackedRight[i]);
+		}
+	};
+
+	for (int32 Pass = 0; Pass < Settings.AlignmentPasses; ++Pass)
+	{
+		if (Pass % 2 == 0)
+		{
+			for (int32 LayerIndex = 1; LayerIndex < Layers.Num(); ++LayerIndex)
+			{
+				AlignLayer(Layers[LayerIndex], Up);
+			}
+		}
+		else
+		{
+			for (int32 LayerIndex = Layers.Num() - 2; LayerIndex >= 0; --LayerIndex)
+			{
+				AlignLayer(Layers[LayerIndex], Down);
+			}
+		}
+	}
+
+	// Shift everything right of a small margin
+	double MinX = 0.0;
+	for (const double NodeX : X)
+	{
+		MinX = FMath::Min(MinX, NodeX);
+	}
+
+	const double Margin = 50.0;
+	NodePositions.SetNumUninitialized(NumNodes);
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		NodePositions[Node] = FVector2D(X[Node] - MinX + Margin, NodeLayers[Node] * Settings.LayerSpacing + Margin);
+	}
+}
@@ -0,0 +1,203 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/DialogGraphSpatialGrid.h"
+
+void FDialogGraphSpatialGrid::Build(TConstArrayView<FBox2D> ItemBounds, double MinCellSize)
+{
+	Reset();
+
+	if (ItemBounds.Num() == 0)
+		return;
+
+	FBox2D Bounds(ForceInit);
+	for (const FBox2D& ItemBox : ItemBounds)
+	{
+		Bounds += ItemBox;
+	}
+
+	SetupCells(Bounds, ItemBounds.Num(), MinCellSize);
+	FillCells(ItemBounds.Num(), [this, ItemBounds](int32 ItemIndex, auto&& Visit)
+	{
+		FIntPoint Min, Max;
+		if (!GetCellRange(ItemBounds[ItemIndex], Min, Max))
+			return;
+
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			for (int32 X = Min.X; X <= Max.X; ++X)
+			{
+				Visit(Y * NumCellsX + X);
+			}
+		}
+	});
+}
+
+void FDialogGraphSpatialGrid::BuildSegments(TConstArrayView<FSegment> Segments, double MinCellSize)
+{
+	Reset();
+
+	if (Segments.Num() == 0)
+		return;
+
+	FBox2D Bounds(ForceInit);
+	for (const FSegment& Segment : Segments)
+	{
+		Bounds += Segment.Start;
+		Bounds += Segment.End;
+	}
+
+	SetupCells(Bounds, Segments.Num(), MinCellSize);
+	FillCells(Segments.Num(), [this, Segments](int32 ItemIndex, auto&& Visit)
+	{
+		ForEachSegmentCell(Segments[ItemIndex], Visit);
+	});
+}
+
+void FDialogGraphSpatialGrid::SetupCells(const FBox2D& Bounds, int32 NumItems, double MinCellSize)
+{
+	// Keep roughly four cells per item at most, however spread out the layout is
+	const FVector2D Extent = Bounds.GetSize();
+	const double SparseCellSize = FMath::Sqrt((Extent.X + 1.0) * (Extent.Y + 1.0) / (4.0 * NumItems));
+	CellSize = FMath::Max3(MinCellSize, SparseCellSize, 1.0);
+	Origin = Bounds.Min;
+	NumCellsX = FMath::FloorToInt(Extent.X / CellSize) + 1;
+	NumCellsY = FMath::FloorToInt(Extent.Y / CellSize) + 1;
+}
+
+template <typename ForEachItemCellType>
+void FDialogGraphSpatialGrid::FillCells(int32 NumItems, ForEachItemCellType&& ForEachItemCell)
+{
+	// Count items per cell (shifted by one so the prefix sum below turns counts into start offsets)
+	CellStarts.SetNumZeroed(NumCellsX * NumCellsY + 1);
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+	{
+		ForEachItemCell(ItemIndex, [this](int32 Cell) { ++CellStarts[Cell + 1]; });
+	}
+
+	for (int32 Cell = 1; Cell < CellStarts.Num(); ++Cell)
+	{
+		CellStarts[Cell] += CellStarts[Cell - 1];
+	}
+
+	// Fill
+	CellItems.SetNumUninitialized(CellStarts.Last());
+	TArray<int32> CellCursors(CellStarts.GetData(), CellStarts.Num() - 1);
+	for (int32 ItemIndex = 0; ItemIndex < NumItems; ++ItemIndex)
+	{
+		ForEachItemCell(ItemIndex, [this, &CellCursors, ItemIndex](int32 Cell) { CellItems[CellCursors[Cell]++] = ItemIndex; });
+	}
+
+	ItemQueryStamps.SetNumZeroed(NumItems);
+	QueryStamp = 0;
+}
+
+template <typename VisitType>
+void FDialogGraphSpatialGrid::ForEachSegmentCell(const FSegment& Segment, VisitType&& Visit) const
+{
+	// Grid traversal (Amanatides & Woo): step into whichever neighbouring cell the line crosses into first
+	const FVector2D Start = (Segment.Start - Origin) / CellSize;
+	const FVector2D End = (Segment.End - Origin) / CellSize;
+	const FVector2D Delta = End - Start;
+
+	int32 X = FMath::Clamp(FMath::FloorToInt(Start.X), 0, NumCellsX - 1);
+	int32 Y = FMath::Clamp(FMath::FloorToInt(Start.Y), 0, NumCellsY - 1);
+	const int32 EndX = FMath::Clamp(FMath::FloorToInt(End.X), 0, NumCellsX - 1);
+	const int32 EndY = FMath::Clamp(FMath::FloorToInt(End.Y), 0, NumCellsY - 1);
+
+	const int32 StepX = EndX > X ? 1 : -1;
+	const int32 StepY = EndY > Y ? 1 : -1;
+
+	// Line parameter (0 at the start, 1 at the end) at the next cell boundary on each axis, and between boundaries
+	const double DeltaX = FMath::Abs(Delta.X) > UE_DOUBLE_SMALL_NUMBER ? FMath::Abs(1.0 / Delta.X) : UE_DOUBLE_BIG_NUMBER;
+	const double DeltaY = FMath::Abs(Delta.Y) > UE_DOUBLE_SMALL_NUMBER ? FMath::Abs(1.0 / Delta.Y) : UE_DOUBLE_BIG_NUMBER;
+	double NextX = DeltaX * (StepX > 0 ? (X + 1 - Start.X) : (Start.X - X));
+	double NextY = DeltaY * (StepY > 0 ? (Y + 1 - Start.Y) : (Start.Y - Y));
+
+	// A walk from one cell to another crosses exactly this many boundaries; once an axis reaches its end cell only the other one moves,
+	// which also keeps rounding at cell corners from stepping off the end
+	const int32 NumSteps = FMath::Abs(EndX - X) + FMath::Abs(EndY - Y);
+	Visit(Y * NumCellsX + X);
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		if (Y == EndY || (X != EndX && NextX < NextY))
+		{
+			X += StepX;
+			NextX += DeltaX;
+		}
+		else
+		{
+			Y += StepY;
+			NextY += DeltaY;
+		}
+		Visit(Y * NumCellsX + X);
+	}
+}
+
+void FDialogGraphSpatialGrid::Reset()
+{
+	Origin = FVector2D::ZeroVector;
+	CellSize = 1.0;
+	NumCellsX = 0;
+	NumCellsY = 0;
+	CellStarts.Reset();
+	CellItems.Reset();
+	ItemQueryStamps.Reset();
+	QueryStamp = 0;
+}
+
+void FDialogGraphSpatialGrid::Query(const FBox2D& Area, TArray<int32>& OutItems) const
+{
+	FIntPoint Min, Max;
+	if (!GetCellRange(Area, Min, Max))
+		return;
+
+	// Stamps are only ever compared for equality, so on wrap-around clear them and start over
+	if (++QueryStamp == 0)
+	{
+		FMemory::Memzero(ItemQueryStamps.GetData(), ItemQueryStamps.Num() * sizeof(uint32));
+		QueryStamp = 1;
+	}
+
+	for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+	{
+		for (int32 X = Min.X; X <= Max.X; ++X)
+		{
+			const int32 Cell = Y * NumCellsX + X;
+			for (int32 i = CellStarts[Cell]; i < CellStarts[Cell + 1]; ++i)
+			{
+				const int32 ItemIndex = CellItems[i];
+				if (ItemQueryStamps[ItemIndex] != QueryStamp)
+				{
+					ItemQueryStamps[ItemIndex] = QueryStamp;
+					OutItems.Add(ItemIndex);
+				}
+			}
+		}
+	}
+}
+
+TConstArrayView<int32> FDialogGraphSpatialGrid::GetCellItems(const FVector2D& Point) const
+{
+	FIntPoint Min, Max;
+	if (!GetCellRange(FBox2D(Point, Point), Min, Max))
+		return TConstArrayView<int32>();
+
+	const int32 Cell = Min.Y * NumCellsX + Min.X;
+	return TConstArrayView<int32>(CellItems.GetData() + CellStarts[Cell], CellStarts[Cell + 1] - CellStarts[Cell]);
+}
+
+bool FDialogGraphSpatialGrid::GetCellRange(const FBox2D& Area, FIntPoint& OutMin, FIntPoint& OutMax) const
+{
+	if (NumCellsX == 0 || NumCellsY == 0)
+		return false;
+
+	const FVector2D MinCell = (Area.Min - Origin) / CellSize;
+	const FVector2D MaxCell = (Area.Max - Origin) / CellSize;
+
+	if (MaxCell.X < 0.0 || MaxCell.Y < 0.0 || MinCell.X >= NumCellsX || MinCell.Y >= NumCellsY)
+		return false;
+
+	OutMin = FIntPoint(FMath::Max(FMath::FloorToInt(MinCell.X), 0), FMath::Max(FMath::FloorToInt(MinCell.Y), 0));
+	OutMax = FIntPoint(FMath::Min(FMath::FloorToInt(MaxCell.X), NumCellsX - 1), FMath::Min(FMath::FloorToInt(MaxCell.Y), NumCellsY - 1));
+	return true;
+}
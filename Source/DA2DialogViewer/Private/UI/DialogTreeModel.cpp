@@ -0,0 +1,495 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/DialogTreeModel.h"
+#include "UI/SDialogTreeView.h"
+#include "DialogFlow/Conversation.h"
+#include "Data/DialogDataManager.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Unique.h"
+
+// Hardcoded player speaker IDs (identified via flip-flop analysis of 704 DA2 conversations)
+// These IDs are used >95% of the time for player lines (Hawke)
+// Source: analyze_player_speakers_flipflop.py analysis
+const TSet<int32> FDialogTreeModel::KnownPlayerSpeakerIDs = {
+	2, 10, 14, 18, 26, 34, 66, 74, 78, 110, 138, 258, 266, 274, 290, 322
+};
+
+TSharedPtr<const FDialogTreeModel> FDialogTreeModel::Build(TSharedPtr<FConversation> InConversation, TSharedPtr<const FDialogDataManager> InDataManager,
+	EPlayerGender Gender, const std::atomic<bool>* bCancelled)
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_BuildTreeModel);
+
+	if (!InConversation.IsValid())
+		return nullptr;
+
+	TSharedPtr<FDialogTreeModel> Model = MakeShared<FDialogTreeModel>();
+	Model->Conversation = InConversation;
+	Model->OwnerSpeakerID = DetectConversationOwner(*InConversation);
+	Model->FirstOccurrences.Reserve(InConversation->Nodes.Num());
+
+	Model->MaxTreeItems = InConversation->EntryLinks.Num();
+	for (int32 EntryIndex = 0; EntryIndex < InConversation->EntryLinks.Num(); ++EntryIndex)
+	{
+		if (!Model->AnalyzeOccurrences(InConversation->EntryLinks[EntryIndex].TargetNodeIndex, EntryIndex, InDataManager.Get(), Gender, bCancelled))
+		{
+			return nullptr;
+		}
+	}
+
+	if (InDataManager.IsValid())
+	{
+		Model->ResolveAudioAvailability(*InDataManager);
+	}
+
+	// Log unique speaker IDs for player lines (only once per ID, only when speaker logging is on)
+	if (DA2DialogLog::bSpeaker.load(std::memory_order_relaxed))
+	{
+		TSet<int32> PlayerSpeakerIDs;
+		for (const auto& Pair : Model->AllOccurrences)
+		{
+			if (Pair.Value.SpeakerLabel == ESpeakerLabel::Player)
+			{
+				const FDialogNode* Node = InConversation->FindNode(Pair.Key);
+				bool bAlreadyLogged = false;
+				PlayerSpeakerIDs.Add(Node->SpeakerID, &bAlreadyLogged);
+				if (!bAlreadyLogged)
+				{
+					UE_LOG(LogDA2Dialog, Log, TEXT("Found PLAYER with Speaker ID: %d"), Node->SpeakerID);
+				}
+			}
+		}
+	}
+
+	return Model;
+}
+
+bool FDialogTreeModel::HasAudio(int32 TLKID, EPlayerGender Gender) const
+{
+	const int32 Index = Algo::BinarySearch(AudioTLKIDs, TLKID);
+	return Index != INDEX_NONE && AudioAvailable[static_cast<uint8>(Gender)][Index];
+}
+
+bool FDialogTreeModel::FindAudioFileID(int32 TLKID, EPlayerGender Gender, uint32& OutFileID) const
+{
+	const int32 Index = Algo::BinarySearch(AudioTLKIDs, TLKID);
+	const uint8 GenderIndex = static_cast<uint8>(Gender);
+	if (Index == INDEX_NONE || !AudioAvailable[GenderIndex][Index])
+	{
+		return false;
+	}
+
+	OutFileID = AudioFileIDs[GenderIndex][Index];
+	return true;
+}
+
+void FDialogTreeModel::GetAudioFileIDs(TArray<uint32>& OutFileIDs) const
+{
+	OutFileIDs.Reset();
+	for (int32 GenderIndex = 0; GenderIndex < 2; ++GenderIndex)
+	{
+		for (TConstSetBitIterator<> It(AudioAvailable[GenderIndex]); It; ++It)
+		{
+			OutFileIDs.Add(AudioFileIDs[GenderIndex][It.GetIndex()]);
+		}
+	}
+
+	OutFileIDs.Sort();
+	OutFileIDs.SetNum(Algo::Unique(OutFileIDs));
+}
+
+bool FDialogTreeModel::HasNodeAudio(int32 NodeIndex, EPlayerGender Gender) const
+{
+	const FDialogNode* Node = Conversation.IsValid() ? Conversation->FindNode(NodeIndex) : nullptr;
+	return Node && HasAudio(Node->TLKStringID, Gender);
+}
+
+bool FDialogTreeModel::HasLinkAudio(int32 NodeIndex, int32 LinkIndex, EPlayerGender Gender) const
+{
+	const FDialogNode* Node = Conversation.IsValid() ? Conversation->FindNode(NodeIndex) : nullptr;
+	return Node && Node->Links.IsValidIndex(LinkIndex) && HasAudio(Node->Links[LinkIndex].TLKStringID, Gender);
+}
+
+void FDialogTreeModel::ResolveAudioAvailability(const FDialogDataManager& InDataManager)
+{
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_ResolveAudioAvailability);
+
+	// Only reachable nodes become rows, and only first occurrences expand to show their links
+	AudioTLKIDs.Reset();
+	for (const auto& Pair : FirstOccurrences)
+	{
+		const FDialogNode* Node = Conversation->FindNode(Pair.Key);
+		if (!Node)
+			continue;
+
+		if (Node->TLKStringID > 0)
+		{
+			AudioTLKIDs.Add(Node->TLKStringID);
+		}
+		for (const FDialogLink& Link : Node->Links)
+		{
+			if (Link.TLKStringID > 0)
+			{
+				AudioTLKIDs.Add(Link.TLKStringID);
+			}
+		}
+	}
+
+	// Lines are shared between nodes and links, resolve each one once
+	AudioTLKIDs.Sort();
+	AudioTLKIDs.SetNum(Algo::Unique(AudioTLKIDs));
+
+	const uint8 Male = static_cast<uint8>(EPlayerGender::Male);
+	const uint8 Female = static_cast<uint8>(EPlayerGender::Female);
+	bAudioAvailabilityKnown = InDataManager.ResolveAudioAvailability(AudioTLKIDs, EPlayerGender::Male, AudioAvailable[Male], &AudioFileIDs[Male])
+		&& InDataManager.ResolveAudioAvailability(AudioTLKIDs, EPlayerGender::Female, AudioAvailable[Female], &AudioFileIDs[Female]);
+
+	if (!bAudioAvailabilityKnown)
+	{
+		AudioTLKIDs.Reset();
+		AudioAvailable[0].Reset();
+		AudioAvailable[1].Reset();
+		AudioFileIDs[0].Reset();
+		AudioFileIDs[1].Reset();
+	}
+}
+
+const FDialogOccurrence* FDialogTreeModel::FindOccurrence(int32 NodeIndex, int32 ParentNodeIndex, int32 LinkIndex) const
+{
+	for (auto It = AllOccurrences.CreateConstKeyIterator(NodeIndex); It; ++It)
+	{
+		const FDialogOccurrence& Occurrence = It.Value();
+		if (Occurrence.ParentNodeIndex == ParentNodeIndex && Occurrence.LinkIndex == LinkIndex)
+		{
+			return &Occurrence;
+		}
+	}
+
+	return nullptr;
+}
+
+bool FDialogTreeModel::AnalyzeOccurrences(int32 EntryNodeIndex, int32 EntryIndex, const FDialogDataManager* InDataManager, EPlayerGender Gender,
+	const std::atomic<bool>* bCancelled)
+{
+	// One frame per first occurrence on the current path: the node, its turn and the next link to follow
+	struct FStackFrame
+	{
+		const FDialogNode* Node;
+		bool bIsNPCTurn;
+		int32 NextLinkIndex;
+	};
+
+	TArray<FStackFrame> Stack;
+
+	// Record one arrival at a node, pushing it if this is the first time it is seen
+	auto VisitNode = [this, &Stack, InDataManager, Gender](int32 NodeIndex, const FDialogNode* ParentNode, bool bParentIsNPCTurn, int32 LinkIndex)
+	{
+		const FDialogNode* Node = Conversation->FindNode(NodeIndex);
+		if (!Node)
+			return;
+
+		// Already seen means a reference (this is also what breaks cycles)
+		const bool bIsReference = FirstOccurrences.Contains(NodeIndex);
+
+		FDialogOccurrence Occurrence;
+		Occurrence.ParentNodeIndex = ParentNode ? ParentNode->NodeIndex : INDEX_NONE;
+		Occurrence.LinkIndex = LinkIndex;
+
+		// Flip-flop state: entries always start with NPC, children flip from their parent
+		Occurrence.bIsNPCTurn = ParentNode ? !bParentIsNPCTurn : true;
+
+		// Missing, placeholder (-1) and empty lines come back as an empty view and are shown as [[CONTINUE]] / [[END DIALOG]]
+		// Without a data manager rows show just the TLK ID, which is neither text nor a placeholder
+		const FStringView SpokenLine = InDataManager ? InDataManager->GetTLKStringView(Node->TLKStringID, Gender) : FStringView();
+		const bool bIsPlaceholder = InDataManager && SpokenLine.IsEmpty();
+		Occurrence.bHasSpokenText = !FDialogTreeItem::IsValidlyEmpty(SpokenLine);
+
+		ClassifyOccurrence(Occurrence, *Node, ParentNode, bIsReference, bIsPlaceholder);
+		AllOccurrences.Add(NodeIndex, Occurrence);
+
+		if (bIsReference)
+			return;
+
+		FirstOccurrences.Add(NodeIndex, Occurrence);
+
+		// Only first occurrences are expandable, so only their links can become rows
+		MaxTreeItems += Node->Links.Num();
+
+		Stack.Add({Node, Occurrence.bIsNPCTurn, 0});
+	};
+
+	VisitNode(EntryNodeIndex, nullptr, false, EntryIndex);
+
+	constexpr int32 StepsPerCancelCheck = 1024;
+	int32 StepsSinceCancelCheck = 0;
+
+	while (Stack.Num() > 0)
+	{
+		if (++StepsSinceCancelCheck == StepsPerCancelCheck)
+		{
+			StepsSinceCancelCheck = 0;
+			if (bCancelled && bCancelled->load(std::memory_order_relaxed))
+				return false;
+		}
+
+		// Read everything out of the frame first, VisitNode may grow the stack
+		FStackFrame& Top = Stack.Last();
+		if (Top.NextLinkIndex >= Top.Node->Links.Num())
+		{
+			Stack.Pop();
+			continue;
+		}
+
+		const FDialogNode* ParentNode = Top.Node;
+		const bool bParentIsNPCTurn = Top.bIsNPCTurn;
+		const int32 LinkIndex = Top.NextLinkIndex++;
+		VisitNode(ParentNode->Links[LinkIndex].TargetNodeIndex, ParentNode, bParentIsNPCTurn, LinkIndex);
+	}
+
+	return !(bCancelled && bCancelled->load(std::memory_order_relaxed));
+}
+
+void FDialogTreeModel::ClassifyOccurrence(FDialogOccurrence& Occurrence, const FDialogNode& Node, const FDialogNode* ParentNode,
+	bool bIsReference, bool bIsPlaceholder)
+{
+	auto HasPartyCondition = [](const FDialogNode& InNode)
+	{
+		return !InNode.Condition.PlotName.IsEmpty() && InNode.Condition.PlotName.Contains(TEXT("party"), ESearchCase::IgnoreCase);
+	};
+
+	// PRIORITY 1: Check if THIS node has a party condition - party conditions supersede everything
+	// This identifies which companion is speaking based on their party flag
+	if (HasPartyCondition(Node))
+	{
+		Occurrence.Companion = ResolveCompanionFromPartyFlag(Node.Condition.FlagIndex);
+
+		DA2_LOG(bTreeBuild, Verbose, TEXT("Speaker %d resolved to %s based on own party condition (plot: %s, flag: %d)"),
+		       Node.SpeakerID, GetCompanionName(Occurrence.Companion), *Node.Condition.PlotName, Node.Condition.FlagIndex);
+	}
+	// PRIORITY 2: For Speaker 257, check parent's party condition (hysteresis logic)
+	// This handles cases where Speaker 257's response follows a party-gated choice
+	// If the parent has a non-party condition, Speaker 257 remains OWNER
+	else if (Node.SpeakerID == 257 && ParentNode && HasPartyCondition(*ParentNode))
+	{
+		Occurrence.Companion = ResolveCompanionFromPartyFlag(ParentNode->Condition.FlagIndex);
+
+		DA2_LOG(bTreeBuild, Verbose, TEXT("Speaker 257 resolved to %s based on parent party condition (plot: %s, flag: %d)"),
+		       GetCompanionName(Occurrence.Companion), *ParentNode->Condition.PlotName, ParentNode->Condition.FlagIndex);
+	}
+
+	// Ambient = has valid spoken text but no children (links)
+	Occurrence.bIsAmbient = Occurrence.bHasSpokenText && Node.Links.Num() == 0;
+
+	const bool bIsHenchman = IsCompanionSpeaker(Occurrence.Companion);
+
+	// Speaker type - drives the row color
+	if (bIsReference)
+	{
+		// PRIORITY 1 (HIGHEST): Reference nodes
+		Occurrence.SpeakerType = ESpeakerType::Reference;
+	}
+	else if (Occurrence.bIsAmbient)
+	{
+		// PRIORITY 2: Ambient lines (spoken text with no children) ALWAYS use the conversation owner
+		Occurrence.SpeakerType = ESpeakerType::Owner;
+	}
+	else if (KnownPlayerSpeakerIDs.Contains(Node.SpeakerID))
+	{
+		// PRIORITY 3: Player detection via hardcoded speaker IDs
+		Occurrence.SpeakerType = ESpeakerType::Player;
+	}
+	else if (bIsPlaceholder)
+	{
+		// PRIORITY 4: Empty/Continue/End Dialog lines are always OWNER (red) even if they have party conditions
+		Occurrence.SpeakerType = ESpeakerType::Owner;
+	}
+	else if (bIsHenchman)
+	{
+		// PRIORITY 5: NPC turn with actual dialogue - henchman (party member)
+		Occurrence.SpeakerType = ESpeakerType::Henchman;
+	}
+	else if (Node.SpeakerID == 257)
+	{
+		// Speaker 257 defaults to OWNER
+		Occurrence.SpeakerType = ESpeakerType::Owner;
+	}
+	else
+	{
+		// Other named NPC (NOT FULLY IMPLEMENTED)
+		Occurrence.SpeakerType = ESpeakerType::OtherNPC;
+	}
+
+	// Speaker label - what the speaker column shows
+	if (Occurrence.bIsAmbient)
+	{
+		// PRIORITY 1 (HIGHEST): Ambient lines are always NPC lines, this supersedes even player detection
+		DA2_LOG(bSpeaker, Verbose, TEXT("Ambient line detected: Node %d, Speaker %d -> treating as OWNER"), Node.NodeIndex, Node.SpeakerID);
+		Occurrence.SpeakerLabel = ESpeakerLabel::Owner;
+	}
+	else if (!Occurrence.bIsNPCTurn)
+	{
+		// PRIORITY 2: Player detection via flip-flop - if flip-flop says player, it's PLAYER (blue)
+		Occurrence.SpeakerLabel = ESpeakerLabel::Player;
+	}
+	else if (bIsPlaceholder)
+	{
+		// PRIORITY 3: NPC line with no actual dialogue
+		Occurrence.SpeakerLabel = ESpeakerLabel::Owner;
+	}
+	else if (Occurrence.Companion != EDialogCompanion::None)
+	{
+		// PRIORITY 4: Party henchman, by name
+		// WORKAROUND: Composite party flags (e.g. "[Party: Solo Player]") are NOT individual companions speaking,
+		// they're just party-related conditions, so for now we assume composite party flags with NPC turn = OWNER
+		Occurrence.SpeakerLabel = bIsHenchman ? ESpeakerLabel::Companion : ESpeakerLabel::Owner;
+	}
+	else if (Node.SpeakerID == 257)
+	{
+		// Speaker 257 defaults to OWNER
+		Occurrence.SpeakerLabel = ESpeakerLabel::Owner;
+	}
+	else
+	{
+		// Other named NPC
+		// NOTE: Incomplete logic - some other speaker IDs may also mean OWNER or other named NPCs
+		DA2_LOG(bSpeaker, VeryVerbose, TEXT("TODO: Identify named NPC with Speaker ID: %d"), Node.SpeakerID);
+		Occurrence.SpeakerLabel = ESpeakerLabel::OtherNPC;
+	}
+}
+
+EDialogCompanion FDialogTreeModel::ResolveCompanionFromPartyFlag(int32 FlagIndex)
+{
+	// ============================================================================
+	// PARTY FLAG REFERENCE MAP (plt_gen00pt_party)
+	// ============================================================================
+	// Based on bytecode analysis of gen00pt_party.txt and conversation XML usage
+	//
+	// INDIVIDUAL COMPANION FLAGS (256-271, 276-277):
+	//   256/257 = Carver      (odd=257 is primary, reversed from others)
+	//   258/259 = Bethany
+	//   260/261 = Varric
+	//   262/263 = Aveline
+	//   264/265 = Isabela
+	//   266/267 = Merrill
+	//   268/269 = Anders
+	//   270/271 = Fenris
+	//   276/277 = Sebastian
+	//
+	// SPECIAL COMPOSITE FLAGS (272-275):
+	//   272 = Any female companions in party OR player is female
+	//         Checks: Bethany || Merrill || Isabela || GetCreatureGender(Hero) == 2
+	//
+	//   273 = Party contains mage/s (NPC dialog context)
+	//         Checks: Bethany || Merrill || Anders
+	//         Used by NPCs talking TO the player about mages (e.g., Grace in mag101)
+	//
+	//   274 = Party contains mage/s (companion banter context)
+	//         Checks: Bethany || Merrill || Anders
+	//         Used in companion-to-companion banter (follower_banter.xml)
+	//         Functionally identical to 273, different context
+	//
+	//   275 = Player is alone (no active companions)
+	//         Checks: GetParty().size == 1
+	//         Used for solo-only dialog options and combat barks
+	// ============================================================================
+
+	// Special composite flags (272-275)
+	if (FlagIndex == 272)
+	{
+		return EDialogCompanion::PartyFemale;
+	}
+	else if (FlagIndex == 273 || FlagIndex == 274)
+	{
+		return EDialogCompanion::PartyMage;
+	}
+	else if (FlagIndex == 275)
+	{
+		return EDialogCompanion::PartySolo;
+	}
+
+	// Individual companion flags (256-271, 276-277)
+	// Carver is unique: uses ODD flag 257 as primary (reversed from others)
+	if (FlagIndex == 257 || FlagIndex == 256)
+	{
+		return EDialogCompanion::Carver;
+	}
+
+	// For all other companions, use even flags (256-278 range, even = in party)
+	// Note: Normalize to base even flag
+	int32 BaseFlag = (FlagIndex % 2 == 0) ? FlagIndex : (FlagIndex - 1);
+
+	switch (BaseFlag)
+	{
+	case 258: return EDialogCompanion::Bethany;
+	case 260: return EDialogCompanion::Varric;
+	case 262: return EDialogCompanion::Aveline;
+	case 264: return EDialogCompanion::Isabela;
+	case 266: return EDialogCompanion::Merrill;
+	case 268: return EDialogCompanion::Anders;
+	case 270: return EDialogCompanion::Fenris;
+	case 276: return EDialogCompanion::Sebastian;
+	default:
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Unknown party flag: %d"), FlagIndex);
+		return EDialogCompanion::Unknown;
+	}
+}
+
+const TCHAR* FDialogTreeModel::GetCompanionName(EDialogCompanion Companion)
+{
+	switch (Companion)
+	{
+	case EDialogCompanion::Carver: return TEXT("Carver");
+	case EDialogCompanion::Bethany: return TEXT("Bethany");
+	case EDialogCompanion::Varric: return TEXT("Varric");
+	case EDialogCompanion::Aveline: return TEXT("Aveline");
+	case EDialogCompanion::Isabela: return TEXT("Isabela");
+	case EDialogCompanion::Merrill: return TEXT("Merrill");
+	case EDialogCompanion::Anders: return TEXT("Anders");
+	case EDialogCompanion::Fenris: return TEXT("Fenris");
+	case EDialogCompanion::Sebastian: return TEXT("Sebastian");
+	case EDialogCompanion::Unknown: return TEXT("Unknown Flag");
+	case EDialogCompanion::PartyFemale: return TEXT("[Party: Female/s or Female Player]");
+	case EDialogCompanion::PartyMage: return TEXT("[Party: Contains Mage/s]");
+	case EDialogCompanion::PartySolo: return TEXT("[Party: Solo Player]");
+	default: return TEXT("");
+	}
+}
+
+int32 FDialogTreeModel::DetectConversationOwner(const FConversation& InConversation)
+{
+	// Count speaker IDs, excluding known player IDs
+	TMap<int32, int32> NPCSpeakerCounts;
+
+	for (const FDialogNode& Node : InConversation.Nodes)
+	{
+		// Skip player speakers (hardcoded list from flip-flop analysis)
+		if (KnownPlayerSpeakerIDs.Contains(Node.SpeakerID))
+			continue;
+
+		// Count this NPC speaker
+		int32& Count = NPCSpeakerCounts.FindOrAdd(Node.SpeakerID, 0);
+		Count++;
+	}
+
+	// Find most frequent NPC speaker
+	int32 MostFrequentSpeaker = -1;
+	int32 MaxCount = 0;
+
+	for (const auto& Pair : NPCSpeakerCounts)
+	{
+		if (Pair.Value > MaxCount)
+		{
+			MaxCount = Pair.Value;
+			MostFrequentSpeaker = Pair.Key;
+		}
+	}
+
+	if (MostFrequentSpeaker != -1)
+	{
+		UE_LOG(LogDA2Dialog, Log, TEXT("Detected conversation owner: Speaker %d (%d lines)"),
+			MostFrequentSpeaker, MaxCount);
+	}
+
+	return MostFrequentSpeaker;
+}
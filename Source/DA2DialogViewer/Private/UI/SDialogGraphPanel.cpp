@@ -4,29 +4,69 @@
 #include "UI/SDialogWheel.h"
 #include "DialogFlow/Conversation.h"
 #include "Rendering/DrawElements.h"
+#include "Rendering/SlateRenderer.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Async/Async.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
+#include <atomic>
+
+/**
+ * A graph layout in flight on a worker thread
+ */
+struct FGraphLayoutRequest
+{
+	// Set when the layout is no longer wanted
+	std::atomic<bool> bCancelled{false};
+};
 
 void SDialogGraphPanel::Construct(const FArguments& InArgs)
 {
 	OnNodeSelectedCallback = InArgs._OnNodeSelected;
 	SelectedNode = nullptr;
+
+	LayoutSettings.NodeSpacing = HorizontalSpacing;
+	LayoutSettings.LayerSpacing = VerticalSpacing;
+}
+
+SDialogGraphPanel::~SDialogGraphPanel()
+{
+	CancelPendingLayout();
 }
 
 void SDialogGraphPanel::LoadConversation(TSharedPtr<FConversation> InConversation)
 {
 	CurrentConversation = InConversation;
 	SelectedNode = nullptr;
+	PanOffset = FVector2D::ZeroVector;
+	ZoomAmount = 1.0f;
 
-	if (CurrentConversation.IsValid())
-	{
-		CalculateNodePositions();
-	}
+	// Nothing is drawn until the new layout arrives
+	NodePositions.Empty();
+	RebuildSpatialIndex();
+
+	CalculateNodePositions();
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SDialogGraphPanel::SetLayoutSpacing(float NodeSpacing, float LayerSpacing)
+{
+	LayoutSettings.NodeSpacing = NodeSpacing;
+	LayoutSettings.LayerSpacing = LayerSpacing;
+
+	// The current positions stay on screen until the relayout arrives
+	CalculateNodePositions();
 }
 
 void SDialogGraphPanel::Clear()
 {
+	CancelPendingLayout();
 	CurrentConversation.Reset();
+	CurrentLayout.Reset();
 	NodePositions.Empty();
 	SelectedNode = nullptr;
+	RebuildSpatialIndex();
+	Invalidate(EInvalidateWidgetReason::Paint);
 }
 
 void SDialogGraphPanel::NavigateToNode(int32 NodeIndex)
@@ -41,6 +81,17 @@ void SDialogGraphPanel::NavigateToNode(int32 NodeIndex)
 	{
 		SelectedNode = Node;
 
+		// Center the node if it is not fully in view
+		const FVector2D ViewSize = GetPaintSpaceGeometry().GetLocalSize();
+		const FVector2D NodeTopLeft = GraphToLocal(GetNodePosition(NodeIndex));
+		const FVector2D NodeBottomRight = NodeTopLeft + FVector2D(NodeWidth, NodeHeight) * ZoomAmount;
+		if (NodeTopLeft.X < 0.0 || NodeTopLeft.Y < 0.0 || NodeBottomRight.X > ViewSize.X || NodeBottomRight.Y > ViewSize.Y)
+		{
+			PanOffset = ViewSize / 2 - (GetNodePosition(NodeIndex) + FVector2D(NodeWidth, NodeHeight) / 2) * ZoomAmount;
+		}
+
+		Invalidate(EInvalidateWidgetReason::Paint);
+
 		// Update dialog wheel with new node
 		if (DialogWheel.IsValid())
 		{
@@ -58,6 +109,8 @@ int32 SDialogGraphPanel::OnPaint(const FPaintArgs& Args, const FGeometry& Allott
                                  const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
                                  int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
 {
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_GraphPaint);
+
 	const int32 BackgroundLayer = LayerId;
 	const int32 ConnectionLayer = LayerId + 1;
 	const int32 NodeLayer = LayerId + 2;
@@ -77,28 +130,94 @@ int32 SDialogGraphPanel::OnPaint(const FPaintArgs& Args, const FGeometry& Allott
 		return NodeLayer;
 	}
 
-	// Draw connections first (under nodes)
-	for (const FDialogNode& Node : CurrentConversation->Nodes)
+	if (PendingLayout.IsValid() && NodePositions.Num() == 0)
 	{
-		FVector2D StartPos = GetNodePosition(Node.NodeIndex);
-		StartPos += FVector2D(NodeWidth / 2, NodeHeight / 2); // Center of node
+		FSlateDrawElement::MakeText(
+			OutDrawElements,
+			NodeLayer,
+			AllottedGeometry.ToPaintGeometry(),
+			FText::FromString(FString::Printf(TEXT("Laying out %d nodes..."), CurrentConversation->Nodes.Num())),
+			FCoreStyle::GetDefaultFontStyle("Regular", 14),
+			ESlateDrawEffect::None,
+			FLinearColor::White
+		);
+		return NodeLayer;
+	}
 
-		for (const FDialogLink& Link : Node.Links)
-		{
-			FVector2D EndPos = GetNodePosition(Link.TargetNodeIndex);
-			EndPos += FVector2D(NodeWidth / 2, NodeHeight / 2);
+	// Only what overlaps the visible part of the graph is drawn
+	const FVector2D LocalSize = AllottedGeometry.GetLocalSize();
+	const FBox2D VisibleArea(LocalToGraph(FVector2D::ZeroVector), LocalToGraph(LocalSize));
+	const FVector2D NodeCenterOffset(NodeWidth / 2, NodeHeight / 2);
+	const EGraphNodeLOD LOD = GetNodeLOD(AllottedGeometry);
+
+	// Draw connections first (under nodes), one draw element per color; the quads are only rebuilt when the view,
+	// selection or layout changed since the last paint
+	FDialogGraphEdgeBatchKey Key;
+	Key.RenderTransform = AllottedGeometry.GetAccumulatedRenderTransform();
+	Key.LocalSize = LocalSize;
+	Key.PanOffset = PanOffset;
+	Key.ZoomAmount = ZoomAmount;
+	Key.SelectedNode = SelectedNode;
+	if (bEdgeBatchesStale || !(Key == EdgeBatchKey))
+	{
+		BuildEdgeBatches(AllottedGeometry, VisibleArea, LOD);
+		EdgeBatchKey = Key;
+		bEdgeBatchesStale = false;
+	}
 
-			FLinearColor ConnectionColor = GetResponseTypeColor(Link);
-			DrawConnection(StartPos, EndPos, AllottedGeometry, OutDrawElements, ConnectionLayer, ConnectionColor);
+	if (!EdgeBrushHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		EdgeBrushHandle = FSlateApplication::Get().GetRenderer()->GetResourceHandle(*FAppStyle::Get().GetBrush("WhiteBrush"));
+	}
+
+	for (const FDialogGraphEdgeBatch& Batch : EdgeBatches)
+	{
+		if (Batch.Indices.Num() > 0)
+		{
+			FSlateDrawElement::MakeCustomVerts(OutDrawElements, ConnectionLayer, EdgeBrushHandle, Batch.Vertices, Batch.Indices, nullptr, 0, 0);
 		}
 	}
+	INC_DWORD_STAT_BY(STAT_DA2Dialog_NumGraphLinksDrawn, NumBatchedLinks);
+
+	// Points claim a screen cell each, so a zoomed-out view draws at most one element per cell however many nodes land there
+	const double PointCellSize = PointSize / FMath::Max(AllottedGeometry.Scale, UE_SMALL_NUMBER);
+	const int32 NumPointCellsX = FMath::CeilToInt(LocalSize.X / PointCellSize) + 1;
+	const int32 NumPointCellsY = FMath::CeilToInt(LocalSize.Y / PointCellSize) + 1;
+	if (LOD == EGraphNodeLOD::Point)
+	{
+		PointCells.Init(false, NumPointCellsX * NumPointCellsY);
+	}
 
 	// Draw nodes
-	for (const FDialogNode& Node : CurrentConversation->Nodes)
+	int32 NumNodesDrawn = 0;
+	VisibleNodes.Reset();
+	NodeGrid.Query(VisibleArea, VisibleNodes);
+	for (const int32 ArrayIndex : VisibleNodes)
 	{
-		bool bIsSelected = (SelectedNode && SelectedNode->NodeIndex == Node.NodeIndex);
-		DrawNode(Node, AllottedGeometry, OutDrawElements, NodeLayer, bIsSelected);
+		const bool bIsSelected = (SelectedNode == &CurrentConversation->Nodes[ArrayIndex]);
+
+		if (LOD == EGraphNodeLOD::Point && !bIsSelected)
+		{
+			const FVector2D Center = GraphToLocal(NodePositions[ArrayIndex] + NodeCenterOffset);
+			const int32 CellX = FMath::FloorToInt(Center.X / PointCellSize);
+			const int32 CellY = FMath::FloorToInt(Center.Y / PointCellSize);
+			if (CellX < 0 || CellY < 0 || CellX >= NumPointCellsX || CellY >= NumPointCellsY)
+			{
+				continue;
+			}
+
+			FBitReference Cell = PointCells[CellY * NumPointCellsX + CellX];
+			if (Cell)
+			{
+				continue;
+			}
+			Cell = true;
+		}
+
+		DrawNode(ArrayIndex, AllottedGeometry, OutDrawElements, NodeLayer, bIsSelected, LOD);
+		++NumNodesDrawn;
 	}
+	INC_DWORD_STAT_BY(STAT_DA2Dialog_NumGraphNodesDrawn, NumNodesDrawn);
 
 	return NodeLayer;
 }
@@ -116,72 +235,238 @@ FReply SDialogGraphPanel::OnMouseButtonDown(const FGeometry& MyGeometry, const F
 			return FReply::Handled();
 		}
 	}
+	else if (MouseEvent.GetEffectingButton() == EKeys::RightMouseButton)
+	{
+		bIsPanning = true;
+		return FReply::Handled().CaptureMouse(SharedThis(this));
+	}
+
+	return FReply::Unhandled();
+}
+
+FReply SDialogGraphPanel::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (MouseEvent.GetEffectingButton() == EKeys::RightMouseButton && bIsPanning)
+	{
+		bIsPanning = false;
+		return FReply::Handled().ReleaseMouseCapture();
+	}
+
+	return FReply::Unhandled();
+}
+
+FReply SDialogGraphPanel::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (bIsPanning && HasMouseCapture())
+	{
+		// Cursor delta is in screen space
+		PanOffset += MouseEvent.GetCursorDelta() / MyGeometry.Scale;
+		Invalidate(EInvalidateWidgetReason::Paint);
+		return FReply::Handled();
+	}
 
 	return FReply::Unhandled();
 }
 
+FReply SDialogGraphPanel::OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	// Zoom around the cursor: the graph point under it stays put
+	const FVector2D LocalPosition = MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition());
+	const FVector2D GraphPosition = LocalToGraph(LocalPosition);
+
+	ZoomAmount = FMath::Clamp(ZoomAmount * FMath::Pow(1.1f, MouseEvent.GetWheelDelta()), MinZoom, MaxZoom);
+	PanOffset = LocalPosition - GraphPosition * ZoomAmount;
+
+	Invalidate(EInvalidateWidgetReason::Paint);
+	return FReply::Handled();
+}
+
+FCursorReply SDialogGraphPanel::OnCursorQuery(const FGeometry& MyGeometry, const FPointerEvent& CursorEvent) const
+{
+	return bIsPanning ? FCursorReply::Cursor(EMouseCursor::GrabHandClosed) : FCursorReply::Unhandled();
+}
+
 void SDialogGraphPanel::CalculateNodePositions()
 {
-	NodePositions.Empty();
+	CancelPendingLayout();
 
 	if (!CurrentConversation.IsValid() || CurrentConversation->Nodes.Num() == 0)
 	{
+		CurrentLayout.Reset();
+		NodePositions.Empty();
+		RebuildSpatialIndex();
 		return;
 	}
 
-	// Simple layout: arrange nodes in a grid based on depth-first traversal
-	// For now, just lay them out in rows
+	TSharedPtr<FGraphLayoutRequest> Request = MakeShared<FGraphLayoutRequest>();
+	PendingLayout = Request;
 
-	int32 NodesPerRow = 5;
-	float StartX = 50.0f;
-	float StartY = 50.0f;
+	// Layered layout (layering, crossing minimization, coordinates) runs off the game thread
+	// The previous layout lets an unchanged graph skip straight to coordinate assignment
+	TSharedPtr<FConversation> Conversation = CurrentConversation;
+	TSharedPtr<const FDialogGraphLayout> Previous = CurrentLayout;
+	const FDialogGraphLayoutSettings Settings = LayoutSettings;
+	TWeakPtr<SDialogGraphPanel> WeakThis = SharedThis(this);
 
-	for (int32 i = 0; i < CurrentConversation->Nodes.Num(); ++i)
+	Async(EAsyncExecution::ThreadPool, [Conversation, Previous, Settings, Request, WeakThis]()
 	{
-		int32 Row = i / NodesPerRow;
-		int32 Col = i % NodesPerRow;
+		TSharedPtr<const FDialogGraphLayout> Layout = FDialogGraphLayout::Compute(Conversation, Settings, Previous, &Request->bCancelled);
 
-		FVector2D Position(
-			StartX + Col * HorizontalSpacing,
-			StartY + Row * VerticalSpacing
-		);
+		AsyncTask(ENamedThreads::GameThread, [Request, Layout, WeakThis]()
+		{
+			if (TSharedPtr<SDialogGraphPanel> This = WeakThis.Pin())
+			{
+				This->OnLayoutComputed(Request, Layout);
+			}
+		});
+	});
+}
 
-		NodePositions.Add(i, Position);
+void SDialogGraphPanel::OnLayoutComputed(TSharedPtr<FGraphLayoutRequest> Request, TSharedPtr<const FDialogGraphLayout> Layout)
+{
+	// Stale: a newer layout was requested or this one was cancelled
+	if (Request != PendingLayout || Request->bCancelled)
+	{
+		return;
+	}
+
+	PendingLayout.Reset();
+
+	if (!Layout.IsValid() || Layout->Conversation != CurrentConversation)
+	{
+		return;
+	}
+
+	CurrentLayout = Layout;
+	NodePositions = Layout->NodePositions;
+	RebuildSpatialIndex();
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SDialogGraphPanel::CancelPendingLayout()
+{
+	if (PendingLayout.IsValid())
+	{
+		PendingLayout->bCancelled = true;
+		PendingLayout.Reset();
 	}
 }
 
+void SDialogGraphPanel::RebuildSpatialIndex()
+{
+	Edges.Reset();
+	EdgeBucketColors.Reset();
+	NodeGrid.Reset();
+	EdgeGrid.Reset();
+	NodeLabels.Reset();
+	bEdgeBatchesStale = true;
+
+	if (!CurrentConversation.IsValid() || NodePositions.Num() != CurrentConversation->Nodes.Num())
+	{
+		return;
+	}
+
+	const FVector2D NodeSize(NodeWidth, NodeHeight);
+	const FVector2D NodeCenterOffset = NodeSize / 2;
+
+	TArray<FBox2D> NodeBounds;
+	NodeBounds.Reserve(NodePositions.Num());
+	for (const FVector2D& Position : NodePositions)
+	{
+		NodeBounds.Add(FBox2D(Position, Position + NodeSize));
+	}
+
+	TArray<FDialogGraphSpatialGrid::FSegment> EdgeSegments;
+	for (int32 FromNode = 0; FromNode < CurrentConversation->Nodes.Num(); ++FromNode)
+	{
+		const FDialogNode& Node = CurrentConversation->Nodes[FromNode];
+		for (int32 LinkIndex = 0; LinkIndex < Node.Links.Num(); ++LinkIndex)
+		{
+			const int32 ToNode = GetNodeArrayIndex(Node.Links[LinkIndex].TargetNodeIndex);
+			if (ToNode == INDEX_NONE)
+				continue;
+
+			const FLinearColor Color = GetResponseTypeColor(Node.Links[LinkIndex]);
+			int32 Bucket = EdgeBucketColors.Find(Color);
+			if (Bucket == INDEX_NONE)
+			{
+				Bucket = EdgeBucketColors.Add(Color);
+			}
+
+			Edges.Add({FromNode, ToNode, LinkIndex, Bucket});
+
+			EdgeSegments.Add({NodePositions[FromNode] + NodeCenterOffset, NodePositions[ToNode] + NodeCenterOffset});
+		}
+	}
+
+	NodeGrid.Build(NodeBounds, GridCellSize);
+	EdgeGrid.BuildSegments(EdgeSegments, GridCellSize);
+
+	NodeLabels.SetNum(NodePositions.Num());
+}
+
 FVector2D SDialogGraphPanel::GetNodePosition(int32 NodeIndex) const
 {
-	const FVector2D* Position = NodePositions.Find(NodeIndex);
-	return Position ? *Position : FVector2D::ZeroVector;
+	const int32 ArrayIndex = GetNodeArrayIndex(NodeIndex);
+	return NodePositions.IsValidIndex(ArrayIndex) ? NodePositions[ArrayIndex] : FVector2D::ZeroVector;
+}
+
+int32 SDialogGraphPanel::GetNodeArrayIndex(int32 NodeIndex) const
+{
+	const FDialogNode* Node = CurrentConversation.IsValid() ? CurrentConversation->FindNode(NodeIndex) : nullptr;
+	return Node ? static_cast<int32>(Node - CurrentConversation->Nodes.GetData()) : INDEX_NONE;
 }
 
-const FDialogNode* SDialogGraphPanel::FindNodeAtPosition(const FGeometry& Geometry, const FVector2D& ScreenPosition) const
+const FDialogNode* SDialogGraphPanel::FindNodeAtPosition(const FGeometry& Geometry, const FVector2D& LocalPosition) const
 {
 	if (!CurrentConversation.IsValid())
 	{
 		return nullptr;
 	}
 
-	for (const FDialogNode& Node : CurrentConversation->Nodes)
+	// Only nodes registered in the cell under the cursor can contain it
+	const FVector2D GraphPosition = LocalToGraph(LocalPosition);
+	for (const int32 ArrayIndex : NodeGrid.GetCellItems(GraphPosition))
 	{
-		FVector2D NodePos = GetNodePosition(Node.NodeIndex);
-		FVector2D NodeSize(NodeWidth, NodeHeight);
-
-		if (ScreenPosition.X >= NodePos.X && ScreenPosition.X <= NodePos.X + NodeSize.X &&
-			ScreenPosition.Y >= NodePos.Y && ScreenPosition.Y <= NodePos.Y + NodeSize.Y)
+		const FVector2D& NodePos = NodePositions[ArrayIndex];
+		if (GraphPosition.X >= NodePos.X && GraphPosition.X <= NodePos.X + NodeWidth &&
+			GraphPosition.Y >= NodePos.Y && GraphPosition.Y <= NodePos.Y + NodeHeight)
 		{
-			return &Node;
+			return &CurrentConversation->Nodes[ArrayIndex];
 		}
 	}
 
 	return nullptr;
 }
 
-void SDialogGraphPanel::DrawNode(const FDialogNode& Node, const FGeometry& AllottedGeometry,
-                                 FSlateWindowElementList& OutDrawElements, int32 LayerId, bool bIsSelected) const
+EGraphNodeLOD SDialogGraphPanel::GetNodeLOD(const FGeometry& AllottedGeometry) const
 {
-	FVector2D Position = GetNodePosition(Node.NodeIndex);
+	const float ScreenNodeWidth = NodeWidth * ZoomAmount * AllottedGeometry.Scale;
+
+	if (ScreenNodeWidth >= DetailLODMinWidth)
+	{
+		return EGraphNodeLOD::Detail;
+	}
+
+	return ScreenNodeWidth >= BoxLODMinWidth ? EGraphNodeLOD::Box : EGraphNodeLOD::Point;
+}
+
+const FString& SDialogGraphPanel::GetNodeLabel(int32 ArrayIndex) const
+{
+	FString& Label = NodeLabels[ArrayIndex];
+	if (Label.IsEmpty())
+	{
+		const FDialogNode& Node = CurrentConversation->Nodes[ArrayIndex];
+		Label = FString::Printf(TEXT("Node %d\nSpeaker: %d\nTLK: %d"), Node.NodeIndex, Node.SpeakerID, Node.TLKStringID);
+	}
+	return Label;
+}
+
+void SDialogGraphPanel::DrawNode(int32 ArrayIndex, const FGeometry& AllottedGeometry, FSlateWindowElementList& OutDrawElements,
+                                 int32 LayerId, bool bIsSelected, EGraphNodeLOD LOD) const
+{
+	const FDialogNode& Node = CurrentConversation->Nodes[ArrayIndex];
+	const FVector2D& Position = NodePositions[ArrayIndex];
 	FVector2D Size(NodeWidth, NodeHeight);
 
 	// Node background color
@@ -191,59 +476,118 @@ void SDialogGraphPanel::DrawNode(const FDialogNode& Node, const FGeometry& Allot
 		BackgroundColor = FLinearColor::Yellow;
 	}
 
+	if (LOD == EGraphNodeLOD::Point)
+	{
+		// Fixed on-screen size, centered on the node (selected node drawn larger so it can still be found)
+		const float PointScreenSize = bIsSelected ? PointSize * 3 : PointSize;
+		const FVector2D PointLocalSize = FVector2D(PointScreenSize, PointScreenSize) / FMath::Max(AllottedGeometry.Scale, UE_SMALL_NUMBER);
+		const FVector2D Center = GraphToLocal(Position + Size / 2);
+
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(FVector2f(PointLocalSize), FSlateLayoutTransform(FVector2f(Center - PointLocalSize / 2))),
+			FAppStyle::Get().GetBrush("WhiteBrush"),
+			ESlateDrawEffect::None,
+			BackgroundColor
+		);
+		return;
+	}
+
 	// Draw node box
 	FSlateDrawElement::MakeBox(
 		OutDrawElements,
 		LayerId,
-		AllottedGeometry.ToPaintGeometry(FVector2f(Size), FSlateLayoutTransform(FVector2f(Position))),
+		AllottedGeometry.ToPaintGeometry(FVector2f(Size), FSlateLayoutTransform(ZoomAmount, FVector2f(GraphToLocal(Position)))),
 		FAppStyle::Get().GetBrush("WhiteBrush"),
 		ESlateDrawEffect::None,
 		BackgroundColor
 	);
 
+	// Outline and label only once they are big enough to read
+	if (LOD != EGraphNodeLOD::Detail)
+	{
+		return;
+	}
+
 	// Draw node border
 	FSlateDrawElement::MakeBox(
 		OutDrawElements,
 		LayerId + 1,
-		AllottedGeometry.ToPaintGeometry(FVector2f(Size - FVector2D(4, 4)), FSlateLayoutTransform(FVector2f(Position + FVector2D(2, 2)))),
+		AllottedGeometry.ToPaintGeometry(FVector2f(Size - FVector2D(4, 4)), FSlateLayoutTransform(ZoomAmount, FVector2f(GraphToLocal(Position + FVector2D(2, 2))))),
 		FAppStyle::Get().GetBrush("WhiteBrush"),
 		ESlateDrawEffect::None,
 		FLinearColor(0.1f, 0.1f, 0.1f, 1.0f)
 	);
 
 	// Draw node text
-	FString NodeText = FString::Printf(TEXT("Node %d\nSpeaker: %d\nTLK: %d"),
-	                                   Node.NodeIndex, Node.SpeakerID, Node.TLKStringID);
-
 	FSlateDrawElement::MakeText(
 		OutDrawElements,
 		LayerId + 2,
-		AllottedGeometry.ToPaintGeometry(FVector2f(Size - FVector2D(10, 10)), FSlateLayoutTransform(FVector2f(Position + FVector2D(5, 5)))),
-		NodeText,
+		AllottedGeometry.ToPaintGeometry(FVector2f(Size - FVector2D(10, 10)), FSlateLayoutTransform(ZoomAmount, FVector2f(GraphToLocal(Position + FVector2D(5, 5))))),
+		GetNodeLabel(ArrayIndex),
 		FCoreStyle::GetDefaultFontStyle("Regular", 8),
 		ESlateDrawEffect::None,
 		FLinearColor::White
 	);
 }
 
-void SDialogGraphPanel::DrawConnection(const FVector2D& StartPos, const FVector2D& EndPos,
-                                       const FGeometry& AllottedGeometry, FSlateWindowElementList& OutDrawElements,
-                                       int32 LayerId, const FLinearColor& Color) const
+void SDialogGraphPanel::BuildEdgeBatches(const FGeometry& AllottedGeometry, const FBox2D& VisibleArea, EGraphNodeLOD LOD) const
 {
-	TArray<FVector2D> LinePoints;
-	LinePoints.Add(StartPos);
-	LinePoints.Add(EndPos);
+	// One batch per color bucket, and the selected node's links last so they draw on top
+	EdgeBatches.SetNum(EdgeBucketColors.Num() + 1);
+	for (int32 BucketIndex = 0; BucketIndex < EdgeBatches.Num(); ++BucketIndex)
+	{
+		FDialogGraphEdgeBatch& Batch = EdgeBatches[BucketIndex];
+		Batch.Color = EdgeBucketColors.IsValidIndex(BucketIndex) ? EdgeBucketColors[BucketIndex].ToFColor(false) : FColor::Yellow;
+		Batch.Vertices.Reset();
+		Batch.Indices.Reset();
+	}
+	NumBatchedLinks = 0;
 
-	FSlateDrawElement::MakeLines(
-		OutDrawElements,
-		LayerId,
-		AllottedGeometry.ToPaintGeometry(),
-		LinePoints,
-		ESlateDrawEffect::None,
-		Color,
-		true,
-		2.0f
-	);
+	if (!CurrentConversation.IsValid())
+	{
+		return;
+	}
+
+	const FSlateRenderTransform& RenderTransform = AllottedGeometry.GetAccumulatedRenderTransform();
+	const FVector2D NodeCenterOffset(NodeWidth / 2, NodeHeight / 2);
+	const bool bDetailed = LOD == EGraphNodeLOD::Detail;
+
+	// Widths in local units: detailed links scale with zoom, zoomed-out links are a single pixel
+	const double OnePixel = 1.0 / FMath::Max(AllottedGeometry.Scale, UE_SMALL_NUMBER);
+	const double Thickness = bDetailed ? FMath::Max(2.0 * ZoomAmount, 1.0) : OnePixel;
+	const double SelectedThickness = FMath::Max(Thickness * 2, 2 * OnePixel);
+
+	VisibleEdges.Reset();
+	EdgeGrid.Query(VisibleArea, VisibleEdges);
+	for (const int32 EdgeIndex : VisibleEdges)
+	{
+		const FDialogGraphEdge& Edge = Edges[EdgeIndex];
+		const FVector2D StartPos = GraphToLocal(NodePositions[Edge.FromNode] + NodeCenterOffset);
+		const FVector2D EndPos = GraphToLocal(NodePositions[Edge.ToNode] + NodeCenterOffset);
+
+		// Links under a pixel long are skipped when zoomed out
+		const FVector2D Delta = EndPos - StartPos;
+		if (!bDetailed && Delta.SizeSquared() < OnePixel * OnePixel)
+		{
+			continue;
+		}
+
+		const bool bSelectedLink = SelectedNode == &CurrentConversation->Nodes[Edge.FromNode];
+		FDialogGraphEdgeBatch& Batch = bSelectedLink ? EdgeBatches.Last() : EdgeBatches[Edge.Bucket];
+
+		// Quad around the segment
+		const FVector2D Normal = FVector2D(-Delta.Y, Delta.X).GetSafeNormal() * ((bSelectedLink ? SelectedThickness : Thickness) / 2);
+		const SlateIndex FirstVertex = Batch.Vertices.Num();
+		Batch.Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(StartPos + Normal), FVector2f::ZeroVector, Batch.Color));
+		Batch.Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(StartPos - Normal), FVector2f::ZeroVector, Batch.Color));
+		Batch.Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(EndPos + Normal), FVector2f::ZeroVector, Batch.Color));
+		Batch.Vertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(EndPos - Normal), FVector2f::ZeroVector, Batch.Color));
+		Batch.Indices.Append({FirstVertex, FirstVertex + 1, FirstVertex + 2, FirstVertex + 2, FirstVertex + 1, FirstVertex + 3});
+
+		++NumBatchedLinks;
+	}
 }
 
 FLinearColor SDialogGraphPanel::GetResponseTypeColor(const FDialogLink& Link) const
@@ -2,12 +2,14 @@
 
 #include "UI/SDialogTreeView.h"
 #include "UI/SDialogWheel.h"
+#include "UI/SDialogWaveformStrip.h"
 #include "DialogFlow/Conversation.h"
 #include "Data/DialogDataManager.h"
 #include "Audio/AudioMapper.h"
 #include "Audio/AudioUtils.h"
 #include "Audio/DialogAudioPlayer.h"
 #include "Audio/DialogAudioManager.h"
+#include "Audio/DialogWaveformCache.h"
 #include "Widgets/Views/STableRow.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Layout/SBox.h"
@@ -16,22 +18,16 @@
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Images/SImage.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "Framework/Application/SlateApplication.h"
 #include "HAL/FileManager.h"
-
-// Static member initialization
-TSet<int32> FDialogTreeItem::EncounteredPlayerSpeakerIDs;
-
-// Hardcoded player speaker IDs (identified via flip-flop analysis of 704 DA2 conversations)
-// These IDs are used >95% of the time for player lines (Hawke)
-// Source: analyze_player_speakers_flipflop.py analysis
-TSet<int32> FDialogTreeItem::KnownPlayerSpeakerIDs = {
-	2, 10, 14, 18, 26, 34, 66, 74, 78, 110, 138, 258, 266, 274, 290, 322
-};
+#include "Algo/Reverse.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
 
 /**
  * Tree row widget for a single dialog line
  */
-class SDialogTreeRow : public STableRow<TSharedPtr<FDialogTreeItem>>
+class SDialogTreeRow : public STableRow<FDialogTreeItem*>
 {
 public:
 	SLATE_BEGIN_ARGS(SDialogTreeRow)
@@ -40,28 +36,26 @@ public:
 
 		SLATE_ARGUMENT(FString, OwnerTag)
 		SLATE_ARGUMENT(TSharedPtr<FDialogAudioManager>, AudioManager)
+		SLATE_ARGUMENT(TSharedPtr<const FDialogDataManager>, DataManager)
 	SLATE_END_ARGS()
 
-	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, TSharedPtr<FDialogTreeItem> InItem)
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, FDialogTreeItem* InItem)
 	{
 		Item = InItem;
 		OwnerTag = InArgs._OwnerTag;
 		AudioManager = InArgs._AudioManager;
-
-		// Check if this line has audio available
-		// Hide play button for reference nodes (gray stubs) - they're just links to the real occurrence
-		// Only show play button on first occurrence with valid spoken line
-		bool bHasAudio = !Item->bIsReference && !FDialogTreeItem::IsValidlyEmpty(Item->SpokenText);
+		DataManager = InArgs._DataManager;
+		WaveformCache = DataManager.IsValid() ? DataManager->GetWaveformCache() : nullptr;
 
 		// Build row content
-		STableRow<TSharedPtr<FDialogTreeItem>>::Construct(
-			STableRow<TSharedPtr<FDialogTreeItem>>::FArguments()
+		STableRow<FDialogTreeItem*>::Construct(
+			STableRow<FDialogTreeItem*>::FArguments()
 			.Padding(2.0f)
 			.Content()
 			[
 				SNew(SHorizontalBox)
 
-				// Play button (only show if line might have audio)
+				// Play button (only show if the line has an audio file for the current gender)
 				+ SHorizontalBox::Slot()
 				.AutoWidth()
 				.Padding(2.0f)
@@ -70,7 +64,7 @@ public:
 					SNew(SButton)
 					.ButtonStyle(FCoreStyle::Get(), "NoBorder")
 					.OnClicked(this, &SDialogTreeRow::OnPlayAudioClicked)
-					.Visibility(bHasAudio ? EVisibility::Visible : EVisibility::Hidden)
+					.Visibility(this, &SDialogTreeRow::GetPlayButtonVisibility)
 					.ToolTipText(FText::FromString(TEXT("Play dialog audio")))
 					.ContentPadding(FMargin(2.0f))
 					[
@@ -81,6 +75,34 @@ public:
 					]
 				]
 
+				// Waveform and length of the line (filled in once its summary has been computed)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(2.0f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(SDialogWaveformStrip)
+					.Summary(this, &SDialogTreeRow::GetWaveformSummary)
+					.DesiredSize(FVector2D(64.0f, 14.0f))
+					.Visibility(this, &SDialogTreeRow::GetPlayButtonVisibility)
+				]
+
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(2.0f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(SBox)
+					.WidthOverride(36.0f)
+					[
+						SNew(STextBlock)
+						.Text(this, &SDialogTreeRow::GetDurationText)
+						.ToolTipText(this, &SDialogTreeRow::GetLoudnessToolTip)
+						.Font(FCoreStyle::GetDefaultFontStyle("Regular", 8))
+						.ColorAndOpacity(FLinearColor::Gray)
+					]
+				]
+
 				// Condition/Action indicator (CA, C, A, or empty)
 				+ SHorizontalBox::Slot()
 				.AutoWidth()
@@ -117,7 +139,7 @@ public:
 				.Padding(2.0f)
 				[
 					SNew(STextBlock)
-					.Text(FText::FromString(Item->ParaphraseText))
+					.Text(FText::FromString(Item->GetParaphraseDisplayText()))
 					.Font(FCoreStyle::GetDefaultFontStyle("Italic", 9))
 					.ColorAndOpacity(FLinearColor(0.7f, 0.7f, 1.0f, 1.0f))
 				]
@@ -128,7 +150,7 @@ public:
 				.Padding(2.0f)
 				[
 					SNew(STextBlock)
-					.Text(FText::FromString(Item->SpokenText))
+					.Text(FText::FromString(Item->GetSpokenDisplayText()))
 					.Font(FCoreStyle::GetDefaultFontStyle("Regular", 9))
 					.ColorAndOpacity(FLinearColor::White)
 					.AutoWrapText(true)
@@ -150,6 +172,75 @@ public:
 	}
 
 private:
+	EVisibility GetPlayButtonVisibility() const
+	{
+		// Hide play button for reference nodes (gray stubs) - they're just links to the real occurrence
+		// Gender can be toggled while the tree is shown, so pick the precomputed flag on every query
+		const EPlayerGender Gender = DataManager.IsValid() ? DataManager->GetPlayerGender() : EPlayerGender::Male;
+		const bool bHasAudio = !Item->bIsReference && Item->bHasAudio[static_cast<uint8>(Gender)];
+		return bHasAudio ? EVisibility::Visible : EVisibility::Hidden;
+	}
+
+	// Attributes are polled every frame, so the summary and its texts are only looked up again
+	// when the cache has gained summaries or the gender was toggled
+	void UpdateSummary() const
+	{
+		if (!WaveformCache.IsValid() || Item->bIsReference)
+		{
+			return;
+		}
+
+		const EPlayerGender Gender = DataManager.IsValid() ? DataManager->GetPlayerGender() : EPlayerGender::Male;
+		const uint32 Generation = WaveformCache->GetGeneration();
+		if (bSummaryResolved && Gender == SummaryGender && Generation == SummaryGeneration)
+		{
+			return;
+		}
+
+		bSummaryResolved = true;
+		SummaryGender = Gender;
+		SummaryGeneration = Generation;
+
+		const uint32 FileID = Item->AudioFileID[static_cast<uint8>(Gender)];
+		TSharedPtr<const FDialogWaveformSummary> Summary = FileID != 0 ? WaveformCache->Find(FileID) : nullptr;
+		if (Summary == CachedSummary)
+		{
+			return;
+		}
+
+		CachedSummary = MoveTemp(Summary);
+		if (!CachedSummary.IsValid())
+		{
+			DurationText = FText::GetEmpty();
+			LoudnessToolTip = FText::GetEmpty();
+			return;
+		}
+
+		const float RMSDecibels = 20.0f * FMath::LogX(10.0f, FMath::Max(CachedSummary->RMS, 1.0e-5f));
+		const float PeakDecibels = 20.0f * FMath::LogX(10.0f, FMath::Max(CachedSummary->Peak, 1.0e-5f));
+		DurationText = FText::FromString(FString::Printf(TEXT("%.1fs"), CachedSummary->Duration));
+		LoudnessToolTip = FText::FromString(FString::Printf(TEXT("RMS %.1f dBFS, peak %.1f dBFS%s"), RMSDecibels, PeakDecibels,
+			CachedSummary->IsClipped() ? *FString::Printf(TEXT(", %u clipped samples"), CachedSummary->NumClippedSamples) : TEXT("")));
+	}
+
+	TSharedPtr<const FDialogWaveformSummary> GetWaveformSummary() const
+	{
+		UpdateSummary();
+		return CachedSummary;
+	}
+
+	FText GetDurationText() const
+	{
+		UpdateSummary();
+		return DurationText;
+	}
+
+	FText GetLoudnessToolTip() const
+	{
+		UpdateSummary();
+		return LoudnessToolTip;
+	}
+
 	FSlateColor GetSpeakerColor() const
 	{
 		// Use GetSpeakerType() as single source of truth
@@ -184,7 +275,7 @@ private:
 
 	FReply OnPlayAudioClicked()
 	{
-		if (!AudioManager.IsValid() || !Item.IsValid())
+		if (!AudioManager.IsValid() || !Item)
 		{
 			return FReply::Handled();
 		}
@@ -194,16 +285,26 @@ private:
 
 		if (!bSuccess)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("No audio found for dialog node %d (Spoken TLK: %d)"),
+			UE_LOG(LogDA2Dialog, Warning, TEXT("No audio found for dialog node %d (Spoken TLK: %d)"),
 				Item->NodeIndex, Item->TLKStringID);
 		}
 
 		return FReply::Handled();
 	}
 
-	TSharedPtr<FDialogTreeItem> Item;
+	FDialogTreeItem* Item;
 	FString OwnerTag;
 	TSharedPtr<FDialogAudioManager> AudioManager;
+	TSharedPtr<const FDialogDataManager> DataManager;
+	TSharedPtr<FDialogWaveformCache> WaveformCache;
+
+	// Summary for the gender and cache generation it was resolved at, and its texts
+	mutable TSharedPtr<const FDialogWaveformSummary> CachedSummary;
+	mutable FText DurationText;
+	mutable FText LoudnessToolTip;
+	mutable EPlayerGender SummaryGender = EPlayerGender::Male;
+	mutable uint32 SummaryGeneration = 0;
+	mutable bool bSummaryResolved = false;
 };
 
 void SDialogTreeView::Construct(const FArguments& InArgs, TSharedPtr<FDialogDataManager> InDataManager)
@@ -223,7 +324,7 @@ void SDialogTreeView::Construct(const FArguments& InArgs, TSharedPtr<FDialogData
 		+ SVerticalBox::Slot()
 		.FillHeight(1.0f)
 		[
-			SAssignNew(TreeView, STreeView<TSharedPtr<FDialogTreeItem>>)
+			SAssignNew(TreeView, STreeView<FDialogTreeItem*>)
 			.TreeItemsSource(&RootItems)
 			.OnGenerateRow(this, &SDialogTreeView::OnGenerateRow)
 			.OnGetChildren(this, &SDialogTreeView::OnGetChildren)
@@ -301,33 +402,75 @@ void SDialogTreeView::Construct(const FArguments& InArgs, TSharedPtr<FDialogData
 
 void SDialogTreeView::LoadConversation(TSharedPtr<FConversation> InConversation)
 {
-	CurrentConversation = InConversation;
+	LoadModel(FDialogTreeModel::Build(InConversation, DataManager, DataManager.IsValid() ? DataManager->GetPlayerGender() : EPlayerGender::Male));
+}
+
+void SDialogTreeView::LoadModel(TSharedPtr<const FDialogTreeModel> InModel)
+{
+	TreeModel = InModel;
+	CurrentConversation = TreeModel.IsValid() ? TreeModel->Conversation : nullptr;
 	Clear();
 
 	if (CurrentConversation.IsValid())
 	{
-		// Detect conversation owner using heuristic
-		DetectedOwnerSpeakerID = DetectConversationOwner();
-
 		BuildTreeFromConversation();
 		TreeView->RequestTreeRefresh();
+
+		// Summarize the conversation's audio in the background; rows pick the waveforms up as they land
+		const TSharedPtr<FDialogWaveformCache> WaveformCache = DataManager.IsValid() ? DataManager->GetWaveformCache() : nullptr;
+		if (WaveformCache.IsValid() && TreeModel->bAudioAvailabilityKnown)
+		{
+			TArray<uint32> FileIDs;
+			TreeModel->GetAudioFileIDs(FileIDs);
+			WaveformCache->Request(FileIDs);
+		}
 	}
 }
 
 void SDialogTreeView::Clear()
 {
-	RootItems.Empty();
-	SelectedItem.Reset();
+	// The expansion queue indexes into the pool too
+	CancelExpansionPass();
 
+	// Drop every pointer the tree view holds into the pool before the pool is reset
 	if (TreeView.IsValid())
 	{
-		TreeView->RequestTreeRefresh();
+		TreeView->ClearSelection();
+		TreeView->ClearExpandedItems();
+	}
+
+	RootItems.Reset();
+	ItemPool.Reset();
+	FirstOccurrenceItems.Reset();
+	OccurrenceItems.Reset();
+	SelectedItem = nullptr;
+	SET_MEMORY_STAT(STAT_DA2Dialog_TreeItemMemory, ItemPool.GetAllocatedSize());
+
+	// A rebuild reuses the pool's buffer, so new items land at the old addresses and the view would keep
+	// the old rows (which baked their text in Construct); throw every row widget away instead
+	if (TreeView.IsValid())
+	{
+		TreeView->RebuildList();
+	}
+}
+
+void SDialogTreeView::RefreshText()
+{
+	// Text is resolved for the current gender as rows are generated, so mark it stale and regenerate the rows
+	for (FDialogTreeItem& Item : ItemPool)
+	{
+		Item.bTextResolved = false;
+	}
+
+	if (TreeView.IsValid())
+	{
+		TreeView->RebuildList();
 	}
 }
 
 const FDialogNode* SDialogTreeView::GetSelectedNode() const
 {
-	if (SelectedItem.IsValid() && CurrentConversation.IsValid())
+	if (SelectedItem && CurrentConversation.IsValid())
 	{
 		return CurrentConversation->FindNode(SelectedItem->NodeIndex);
 	}
@@ -336,41 +479,36 @@ const FDialogNode* SDialogTreeView::GetSelectedNode() const
 
 void SDialogTreeView::NavigateToNode(int32 NodeIndex)
 {
-	TSharedPtr<FDialogTreeItem> Item = FindTreeItem(NodeIndex);
-	if (Item.IsValid() && TreeView.IsValid())
-	{
-		TreeView->SetSelection(Item);
-		TreeView->RequestScrollIntoView(Item);
-	}
+	RevealItem(FindTreeItem(NodeIndex));
 }
 
 void SDialogTreeView::NavigateToPlayerChoice(int32 PlayerNodeIndex)
 {
 	// Find the player LINE (the choice that was clicked in the wheel)
-	TSharedPtr<FDialogTreeItem> PlayerItem = FindTreeItem(PlayerNodeIndex);
-	if (!PlayerItem.IsValid())
+	FDialogTreeItem* PlayerItem = FindTreeItem(PlayerNodeIndex);
+	if (!PlayerItem)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("NavigateToPlayerChoice: Could not find player node %d"), PlayerNodeIndex);
+		UE_LOG(LogDA2Dialog, Warning, TEXT("NavigateToPlayerChoice: Could not find player node %d"), PlayerNodeIndex);
 		return;
 	}
 
 	// Check if player line has valid spoken text
+	ResolveItemText(PlayerItem);
 	bool bHasValidSpokenText = !FDialogTreeItem::IsValidlyEmpty(PlayerItem->SpokenText);
 
+	// Only ask the audio manager for lines the tree model knows have a file, so wheel picks don't log failed lookups
+	const uint8 Gender = static_cast<uint8>(DataManager.IsValid() ? DataManager->GetPlayerGender() : EPlayerGender::Male);
+
 	if (bHasValidSpokenText)
 	{
 		// Case 1: Player line has spoken text
 		// Navigate to player line and play player audio
-		UE_LOG(LogTemp, Log, TEXT("Player choice has spoken text, navigating to player line %d"), PlayerNodeIndex);
+		UE_LOG(LogDA2Dialog, Log, TEXT("Player choice has spoken text, navigating to player line %d"), PlayerNodeIndex);
 
-		if (TreeView.IsValid())
-		{
-			TreeView->SetSelection(PlayerItem);
-			TreeView->RequestScrollIntoView(PlayerItem);
-		}
+		RevealItem(PlayerItem);
 
 		// Play player audio
-		if (AudioManager.IsValid())
+		if (AudioManager.IsValid() && PlayerItem->bHasAudio[Gender])
 		{
 			AudioManager->PlayDialogAudio(PlayerItem->TLKStringID, -1);
 		}
@@ -379,99 +517,163 @@ void SDialogTreeView::NavigateToPlayerChoice(int32 PlayerNodeIndex)
 	{
 		// Case 2: Player line has NO spoken text (silent choice like "Let brother answer")
 		// Navigate to first LINK (child) and play that audio
-		UE_LOG(LogTemp, Log, TEXT("Player choice has NO spoken text, navigating to first child of node %d"), PlayerNodeIndex);
+		UE_LOG(LogDA2Dialog, Log, TEXT("Player choice has NO spoken text, navigating to first child of node %d"), PlayerNodeIndex);
 
-		if (PlayerItem->Children.Num() > 0)
+		MaterializeChildren(PlayerItem);
+		if (PlayerItem->NumChildren > 0)
 		{
-			TSharedPtr<FDialogTreeItem> FirstChild = PlayerItem->Children[0];
+			FDialogTreeItem* FirstChild = &ItemPool[PlayerItem->FirstChildIndex];
 
-			if (TreeView.IsValid())
-			{
-				TreeView->SetSelection(FirstChild);
-				TreeView->RequestScrollIntoView(FirstChild);
-			}
+			RevealItem(FirstChild);
 
 			// Play first child's audio
-			if (AudioManager.IsValid())
+			if (AudioManager.IsValid() && FirstChild->bHasAudio[Gender])
 			{
 				AudioManager->PlayDialogAudio(FirstChild->TLKStringID, -1);
 			}
 		}
 		else
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Player choice has no spoken text and no children!"));
+			UE_LOG(LogDA2Dialog, Warning, TEXT("Player choice has no spoken text and no children!"));
 		}
 	}
 }
 
 void SDialogTreeView::ExpandAll()
 {
-	if (!TreeView.IsValid())
-		return;
+	StartExpansionPass(RootItems, true);
+}
 
-	for (TSharedPtr<FDialogTreeItem>& RootItem : RootItems)
+void SDialogTreeView::CollapseAll()
+{
+	StartExpansionPass(RootItems, false);
+}
+
+void SDialogTreeView::ExpandBranch(FDialogTreeItem* Item)
+{
+	if (Item)
 	{
-		ExpandBranch(RootItem);
+		StartExpansionPass(MakeArrayView(&Item, 1), true);
 	}
 }
 
-void SDialogTreeView::CollapseAll()
+void SDialogTreeView::CollapseBranch(FDialogTreeItem* Item)
 {
-	if (!TreeView.IsValid())
-		return;
-
-	for (TSharedPtr<FDialogTreeItem>& RootItem : RootItems)
+	if (Item)
 	{
-		CollapseBranch(RootItem);
+		StartExpansionPass(MakeArrayView(&Item, 1), false);
 	}
 }
 
-void SDialogTreeView::ExpandBranch(TSharedPtr<FDialogTreeItem> Item)
+void SDialogTreeView::StartExpansionPass(TConstArrayView<FDialogTreeItem*> StartItems, bool bExpand)
 {
-	if (!Item.IsValid() || !TreeView.IsValid())
+	if (!TreeView.IsValid())
 		return;
 
-	TreeView->SetItemExpansion(Item, true);
+	CancelExpansionPass();
 
-	for (TSharedPtr<FDialogTreeItem>& Child : Item->Children)
+	bExpansionPassExpands = bExpand;
+	for (const FDialogTreeItem* Item : StartItems)
 	{
-		ExpandBranch(Child);
+		ExpansionQueue.Add(GetItemIndex(Item));
+	}
+
+	// Small branches finish right away, anything left over continues on the next frames
+	if (ProcessExpansionPass(FSlateApplication::Get().GetCurrentTime(), 0.0f) == EActiveTimerReturnType::Continue)
+	{
+		ExpansionTimerHandle = RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SDialogTreeView::ProcessExpansionPass));
 	}
 }
 
-void SDialogTreeView::CollapseBranch(TSharedPtr<FDialogTreeItem> Item)
+void SDialogTreeView::CancelExpansionPass()
 {
-	if (!Item.IsValid() || !TreeView.IsValid())
-		return;
+	if (TSharedPtr<FActiveTimerHandle> TimerHandle = ExpansionTimerHandle.Pin())
+	{
+		UnRegisterActiveTimer(TimerHandle.ToSharedRef());
+	}
+	ExpansionTimerHandle.Reset();
+
+	ExpansionQueue.Reset();
+	ExpansionQueueHead = 0;
+}
+
+EActiveTimerReturnType SDialogTreeView::ProcessExpansionPass(double InCurrentTime, float InDeltaTime)
+{
+	// Keep the editor interactive while expanding huge conversations
+	constexpr double FrameBudgetSeconds = 0.004;
+	constexpr int32 ItemsPerTimeCheck = 64;
 
-	TreeView->SetItemExpansion(Item, false);
+	const double Deadline = FPlatformTime::Seconds() + FrameBudgetSeconds;
 
-	for (TSharedPtr<FDialogTreeItem>& Child : Item->Children)
+	int32 ItemsSinceTimeCheck = 0;
+	while (ExpansionQueueHead < ExpansionQueue.Num())
 	{
-		CollapseBranch(Child);
+		FDialogTreeItem* Item = &ItemPool[ExpansionQueue[ExpansionQueueHead++]];
+
+		// Collapsing never needs rows that were not built yet
+		if (bExpansionPassExpands)
+		{
+			MaterializeChildren(Item);
+		}
+
+		// Leaves and references have nothing to expand
+		if (Item->NumChildren > 0)
+		{
+			// SetItemExpansion only flags the view for refresh, the rebuild happens once when the view ticks
+			TreeView->SetItemExpansion(Item, bExpansionPassExpands);
+
+			for (int32 ChildIndex = Item->FirstChildIndex; ChildIndex < Item->FirstChildIndex + Item->NumChildren; ++ChildIndex)
+			{
+				ExpansionQueue.Add(ChildIndex);
+			}
+		}
+
+		if (++ItemsSinceTimeCheck == ItemsPerTimeCheck)
+		{
+			ItemsSinceTimeCheck = 0;
+			if (FPlatformTime::Seconds() >= Deadline)
+			{
+				return EActiveTimerReturnType::Continue;
+			}
+		}
 	}
+
+	ExpansionQueue.Reset();
+	ExpansionQueueHead = 0;
+	ExpansionTimerHandle.Reset();
+	return EActiveTimerReturnType::Stop;
 }
 
-TSharedRef<ITableRow> SDialogTreeView::OnGenerateRow(TSharedPtr<FDialogTreeItem> Item, const TSharedRef<STableViewBase>& OwnerTable)
+TSharedRef<ITableRow> SDialogTreeView::OnGenerateRow(FDialogTreeItem* Item, const TSharedRef<STableViewBase>& OwnerTable)
 {
+	// Text is only looked up once a row actually becomes visible
+	ResolveItemText(Item);
+
 	return SNew(SDialogTreeRow, OwnerTable, Item)
 		.OwnerTag(CurrentConversation.IsValid() ? CurrentConversation->OwnerTag : TEXT(""))
-		.AudioManager(AudioManager);
+		.AudioManager(AudioManager)
+		.DataManager(DataManager);
 }
 
-void SDialogTreeView::OnGetChildren(TSharedPtr<FDialogTreeItem> Item, TArray<TSharedPtr<FDialogTreeItem>>& OutChildren)
+void SDialogTreeView::OnGetChildren(FDialogTreeItem* Item, TArray<FDialogTreeItem*>& OutChildren)
 {
-	if (Item.IsValid())
+	if (Item)
 	{
-		OutChildren = Item->Children;
+		MaterializeChildren(Item);
+
+		OutChildren.Reset(Item->NumChildren);
+		for (int32 ChildIndex = Item->FirstChildIndex; ChildIndex < Item->FirstChildIndex + Item->NumChildren; ++ChildIndex)
+		{
+			OutChildren.Add(&ItemPool[ChildIndex]);
+		}
 	}
 }
 
-void SDialogTreeView::OnSelectionChanged(TSharedPtr<FDialogTreeItem> Item, ESelectInfo::Type SelectInfo)
+void SDialogTreeView::OnSelectionChanged(FDialogTreeItem* Item, ESelectInfo::Type SelectInfo)
 {
 	SelectedItem = Item;
 
-	if (Item.IsValid() && CurrentConversation.IsValid())
+	if (Item && CurrentConversation.IsValid())
 	{
 		const FDialogNode* Node = CurrentConversation->FindNode(Item->NodeIndex);
 		if (Node)
@@ -482,6 +684,21 @@ void SDialogTreeView::OnSelectionChanged(TSharedPtr<FDialogTreeItem> Item, ESele
 				DialogWheel->SetCurrentNode(Node);
 			}
 
+			// Warm the audio cache with this line and the lines it leads to, ahead of the wheel options queued above
+			if (AudioManager.IsValid())
+			{
+				TArray<int32, TInlineAllocator<16>> TLKIDs;
+				TLKIDs.Add(Node->TLKStringID);
+				for (const FDialogLink& Link : Node->Links)
+				{
+					if (const FDialogNode* TargetNode = CurrentConversation->FindNode(Link.TargetNodeIndex))
+					{
+						TLKIDs.Add(TargetNode->TLKStringID);
+					}
+				}
+				AudioManager->PrefetchDialogAudio(TLKIDs);
+			}
+
 			// Update condition metadata display
 			if (ConditionTextBlock.IsValid())
 			{
@@ -490,14 +707,14 @@ void SDialogTreeView::OnSelectionChanged(TSharedPtr<FDialogTreeItem> Item, ESele
 					// VALIDATION: Check for explicit true (operation byte == 1)
 					if (Node->Condition.ComparisonType == 1)
 					{
-						UE_LOG(LogTemp, Warning, TEXT("FOUND Op=1 (explicit TRUE check): Plot=%s, Flag=%d, Node=%d"),
+						UE_LOG(LogDA2Dialog, Warning, TEXT("FOUND Op=1 (explicit TRUE check): Plot=%s, Flag=%d, Node=%d"),
 						       *Node->Condition.PlotName, Node->Condition.FlagIndex, Item->NodeIndex);
 					}
 
 					// VALIDATION: Check for unexpected operation bytes (not 0, not 1, not 255)
 					if (Node->Condition.ComparisonType != 0 && Node->Condition.ComparisonType != 1 && Node->Condition.ComparisonType != 255)
 					{
-						UE_LOG(LogTemp, Error, TEXT("UNEXPECTED Op=%d (not 0/1/255): Plot=%s, Flag=%d, Node=%d"),
+						UE_LOG(LogDA2Dialog, Error, TEXT("UNEXPECTED Op=%d (not 0/1/255): Plot=%s, Flag=%d, Node=%d"),
 						       Node->Condition.ComparisonType, *Node->Condition.PlotName, Node->Condition.FlagIndex, Item->NodeIndex);
 						checkf(false, TEXT("Unexpected operation byte %d in condition (expected 0, 1, or 255)"), Node->Condition.ComparisonType);
 					}
@@ -542,14 +759,14 @@ void SDialogTreeView::OnSelectionChanged(TSharedPtr<FDialogTreeItem> Item, ESele
 					// VALIDATION: Check for explicit true (operation byte == 1)
 					if (Node->Action.ComparisonType == 1)
 					{
-						UE_LOG(LogTemp, Warning, TEXT("FOUND Op=1 (explicit TRUE check) in ACTION: Plot=%s, Flag=%d, Node=%d"),
+						UE_LOG(LogDA2Dialog, Warning, TEXT("FOUND Op=1 (explicit TRUE check) in ACTION: Plot=%s, Flag=%d, Node=%d"),
 						       *Node->Action.PlotName, Node->Action.FlagIndex, Item->NodeIndex);
 					}
 
 					// VALIDATION: Check for unexpected operation bytes (not 0, not 1, not 255)
 					if (Node->Action.ComparisonType != 0 && Node->Action.ComparisonType != 1 && Node->Action.ComparisonType != 255)
 					{
-						UE_LOG(LogTemp, Error, TEXT("UNEXPECTED Op=%d (not 0/1/255) in ACTION: Plot=%s, Flag=%d, Node=%d"),
+						UE_LOG(LogDA2Dialog, Error, TEXT("UNEXPECTED Op=%d (not 0/1/255) in ACTION: Plot=%s, Flag=%d, Node=%d"),
 						       Node->Action.ComparisonType, *Node->Action.PlotName, Node->Action.FlagIndex, Item->NodeIndex);
 						checkf(false, TEXT("Unexpected operation byte %d in action (expected 0, 1, or 255)"), Node->Action.ComparisonType);
 					}
@@ -628,7 +845,7 @@ TSharedPtr<SWidget> SDialogTreeView::OnContextMenuOpening()
 	}
 	MenuBuilder.EndSection();
 
-	if (SelectedItem.IsValid())
+	if (SelectedItem)
 	{
 		MenuBuilder.BeginSection("BranchOperations", FText::FromString(TEXT("Branch Operations")));
 		{
@@ -645,6 +862,34 @@ TSharedPtr<SWidget> SDialogTreeView::OnContextMenuOpening()
 				FSlateIcon(),
 				FUIAction(FExecuteAction::CreateSP(this, &SDialogTreeView::CollapseBranch, SelectedItem))
 			);
+
+			MenuBuilder.AddMenuEntry(
+				FText::FromString(TEXT("Auto-Play Path")),
+				FText::FromString(TEXT("Play every voiced line from the entry line through this one and on down its first replies, without gaps")),
+				FSlateIcon(),
+				FUIAction(FExecuteAction::CreateSP(this, &SDialogTreeView::AutoPlayPath, SelectedItem))
+			);
+
+			if (AudioManager.IsValid() && AudioManager->IsAutoPlaying())
+			{
+				MenuBuilder.AddMenuEntry(
+					FText::FromString(TEXT("Stop Auto-Play")),
+					FText::FromString(TEXT("Stop the auto-play sequence")),
+					FSlateIcon(),
+					FUIAction(FExecuteAction::CreateSP(AudioManager.ToSharedRef(), &FDialogAudioManager::StopAutoPlay))
+				);
+			}
+
+			const int32 NumOccurrences = TreeModel.IsValid() ? TreeModel->GetNumOccurrences(SelectedItem->NodeIndex) : 0;
+			if (NumOccurrences > 1)
+			{
+				MenuBuilder.AddMenuEntry(
+					FText::FromString(FString::Printf(TEXT("Jump to Next Occurrence (%d total)"), NumOccurrences)),
+					FText::FromString(TEXT("Select the next place this line appears in the tree")),
+					FSlateIcon(),
+					FUIAction(FExecuteAction::CreateSP(this, &SDialogTreeView::JumpToNextOccurrence, SelectedItem))
+				);
+			}
 		}
 		MenuBuilder.EndSection();
 	}
@@ -654,331 +899,388 @@ TSharedPtr<SWidget> SDialogTreeView::OnContextMenuOpening()
 
 void SDialogTreeView::BuildTreeFromConversation()
 {
-	if (!CurrentConversation.IsValid())
-		return;
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_BuildTree);
 
-	RootItems.Empty();
-	TMap<int32, TSharedPtr<FDialogTreeItem>> FirstOccurrences;
+	if (!CurrentConversation.IsValid() || !TreeModel.IsValid())
+		return;
 
-	// Build tree starting from entry links
-	for (const FDialogEntryLink& Entry : CurrentConversation->EntryLinks)
+	// One reset and one reservation for the whole tree
+	RootItems.Reset();
+	ItemPool.Reset();
+	ItemPool.Reserve(TreeModel->MaxTreeItems);
+	FirstOccurrenceItems.Reset();
+	FirstOccurrenceItems.Reserve(TreeModel->FirstOccurrences.Num());
+	OccurrenceItems.Reset();
+	SET_DWORD_STAT(STAT_DA2Dialog_NumTreeItems, 0);
+	SET_MEMORY_STAT(STAT_DA2Dialog_TreeItemMemory, ItemPool.GetAllocatedSize());
+
+	// The model already knows where every node first appears, so only the entry lines
+	// are created up front and everything below materializes on expansion
+	// Entry links are invisible, their target lines are the roots
+	for (int32 EntryIndex = 0; EntryIndex < CurrentConversation->EntryLinks.Num(); ++EntryIndex)
 	{
-		TSharedPtr<FDialogTreeItem> RootItem = MakeShared<FDialogTreeItem>();
-		BuildTreeRecursive(Entry.TargetNodeIndex, RootItem, FirstOccurrences);
-
-		if (RootItem->Children.Num() > 0)
+		FDialogTreeItem* RootItem = CreateTreeItem(CurrentConversation->EntryLinks[EntryIndex].TargetNodeIndex, nullptr, EntryIndex);
+		if (RootItem)
 		{
-			// Entry links are invisible, just add their children as roots
-			for (TSharedPtr<FDialogTreeItem>& Child : RootItem->Children)
-			{
-				Child->Parent.Reset();
-				RootItems.Add(Child);
-			}
+			RootItems.Add(RootItem);
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("DialogTreeView: Built tree with %d root items"), RootItems.Num());
+	UE_LOG(LogDA2Dialog, Log, TEXT("DialogTreeView: Built tree with %d root items (%d reachable nodes)"), RootItems.Num(), TreeModel->FirstOccurrences.Num());
 }
 
-void SDialogTreeView::BuildTreeRecursive(int32 NodeIndex, TSharedPtr<FDialogTreeItem> ParentItem, TMap<int32, TSharedPtr<FDialogTreeItem>>& FirstOccurrences)
+FDialogTreeItem* SDialogTreeView::CreateTreeItem(int32 NodeIndex, FDialogTreeItem* ParentItem, int32 LinkIndex)
 {
-	if (!CurrentConversation.IsValid())
-		return;
-
 	const FDialogNode* Node = CurrentConversation->FindNode(NodeIndex);
 	if (!Node)
-		return;
+		return nullptr;
+
+	// Growing past the reservation would move every item and invalidate the pointers the tree view holds
+	check(ItemPool.Num() < ItemPool.Max());
+
+	FDialogTreeItem& Item = ItemPool.AddDefaulted_GetRef();
+	Item.NodeIndex = NodeIndex;
+	Item.LinkIndex = LinkIndex;
+	Item.ParentIndex = ParentItem ? GetItemIndex(ParentItem) : INDEX_NONE;
+	Item.SpeakerID = Node->SpeakerID;
+	Item.TLKStringID = Node->TLKStringID;
+	Item.bHasCondition = !Node->Condition.PlotName.IsEmpty();
+	Item.bHasAction = !Node->Action.PlotName.IsEmpty();
+	Item.NumLinks = Node->Links.Num();
+
+	// Flip-flop state: roots always start with NPC, children flip from their parent
+	Item.bIsNPCTurn = ParentItem ? !ParentItem->bIsNPCTurn : true;
+
+	const FDialogNode* ParentNode = ParentItem ? CurrentConversation->FindNode(ParentItem->NodeIndex) : nullptr;
+	const int32 ParentNodeIndex = ParentItem ? ParentItem->NodeIndex : INDEX_NONE;
 
-	TSharedPtr<FDialogTreeItem> Item = MakeShared<FDialogTreeItem>();
-	Item->NodeIndex = NodeIndex;
-	Item->Parent = ParentItem;
-	Item->SpeakerID = Node->SpeakerID;
-	Item->TLKStringID = Node->TLKStringID;
-	Item->bHasCondition = !Node->Condition.PlotName.IsEmpty();
-	Item->bHasAction = !Node->Action.PlotName.IsEmpty();
-	Item->NumLinks = Node->Links.Num();
-
-	// Set flip-flop state based on parent
-	if (ParentItem.IsValid())
+	// Speaker classification (party resolution, type, label) was worked out once when the model was analyzed
+	if (const FDialogOccurrence* Occurrence = TreeModel->FindOccurrence(NodeIndex, ParentNodeIndex, LinkIndex))
 	{
-		// Flip the state from parent
-		Item->bIsNPCTurn = !ParentItem->bIsNPCTurn;
+		Item.bHasSpokenText = Occurrence->bHasSpokenText;
+		Item.bIsAmbient = Occurrence->bIsAmbient;
+		Item.SpeakerType = Occurrence->SpeakerType;
+		Item.SpeakerLabel = Occurrence->SpeakerLabel;
+		Item.Companion = Occurrence->Companion;
+	}
+
+	// Audio availability was resolved against the audio file index when the model was built, so rows never touch the disk
+	if (TreeModel->bAudioAvailabilityKnown)
+	{
+		Item.bHasAudio[static_cast<uint8>(EPlayerGender::Male)] = TreeModel->HasAudio(Node->TLKStringID, EPlayerGender::Male);
+		Item.bHasAudio[static_cast<uint8>(EPlayerGender::Female)] = TreeModel->HasAudio(Node->TLKStringID, EPlayerGender::Female);
+		TreeModel->FindAudioFileID(Node->TLKStringID, EPlayerGender::Male, Item.AudioFileID[static_cast<uint8>(EPlayerGender::Male)]);
+		TreeModel->FindAudioFileID(Node->TLKStringID, EPlayerGender::Female, Item.AudioFileID[static_cast<uint8>(EPlayerGender::Female)]);
 	}
 	else
 	{
-		// Root always starts with NPC
-		Item->bIsNPCTurn = true;
+		Item.bHasAudio[0] = Item.bHasAudio[1] = Item.bHasSpokenText;
 	}
 
-	// PRIORITY 1: Check if THIS node has a party condition - party conditions supersede everything
-	// This identifies which companion is speaking based on their party flag
-	if (!Node->Condition.PlotName.IsEmpty() && Node->Condition.PlotName.Contains(TEXT("party"), ESearchCase::IgnoreCase))
+	// Only the first depth-first occurrence of a node is expanded, every other occurrence is a reference
+	const FDialogOccurrence* FirstOccurrence = TreeModel->FindFirstOccurrence(NodeIndex);
+	Item.bIsReference = !FirstOccurrence || FirstOccurrence->ParentNodeIndex != ParentNodeIndex || FirstOccurrence->LinkIndex != LinkIndex;
+
+	if (Item.bIsReference)
 	{
-		// This node's condition checks for a party member - resolve to that companion
-		Item->ResolvedSpeakerName = ResolveCompanionFromPartyFlag(Node->Condition.FlagIndex);
+		Item.ReferencedNodeIndex = NodeIndex;
 
-		UE_LOG(LogTemp, Log, TEXT("Speaker %d resolved to %s based on own party condition (plot: %s, flag: %d)"),
-		       Node->SpeakerID, *Item->ResolvedSpeakerName, *Node->Condition.PlotName, Node->Condition.FlagIndex);
+		// References don't have children to avoid infinite loops
+		Item.bChildrenBuilt = true;
 	}
-	// PRIORITY 2: For Speaker 257, check parent's party condition (hysteresis logic)
-	// This handles cases where Speaker 257's response follows a party-gated choice
-	else if (Node->SpeakerID == 257 && ParentItem.IsValid())
+	else if (ParentNode && ParentNode->Links.IsValidIndex(LinkIndex))
 	{
-		// Get parent node to check for party conditions
-		const FDialogNode* ParentNode = CurrentConversation->FindNode(ParentItem->NodeIndex);
-		if (ParentNode && !ParentNode->Condition.PlotName.IsEmpty())
-		{
-			// Check if parent has party condition
-			if (ParentNode->Condition.PlotName.Contains(TEXT("party"), ESearchCase::IgnoreCase))
-			{
-				// Resolve companion from party flag
-				Item->ResolvedSpeakerName = ResolveCompanionFromPartyFlag(ParentNode->Condition.FlagIndex);
-
-				UE_LOG(LogTemp, Log, TEXT("Speaker 257 resolved to %s based on parent party condition (plot: %s, flag: %d)"),
-				       *Item->ResolvedSpeakerName, *ParentNode->Condition.PlotName, ParentNode->Condition.FlagIndex);
-			}
-			// else: Parent has non-party condition, Speaker 257 remains OWNER (leave ResolvedSpeakerName empty)
-		}
-		// else: Parent has no condition, Speaker 257 is OWNER (leave ResolvedSpeakerName empty)
+		// Store the paraphrase TLK ID (from the link that leads here) for audio lookup
+		Item.ParaphraseTLKID = ParentNode->Links[LinkIndex].TLKStringID;
 	}
 
-	// Check if this is a reference to an existing node
-	if (FirstOccurrences.Contains(NodeIndex))
+	// Index the row so navigation never has to search the tree
+	const int32 ItemIndex = ItemPool.Num() - 1;
+	OccurrenceItems.Add(NodeIndex, ItemIndex);
+	if (!Item.bIsReference)
 	{
-		// This is a reference node - mark it and set reference data
-		Item->bIsReference = true;
-		Item->ReferencedNodeIndex = NodeIndex;
+		FirstOccurrenceItems.Add(NodeIndex, ItemIndex);
+	}
 
-		// Copy basic data from the original node for display
-		TSharedPtr<FDialogTreeItem> OriginalItem = FirstOccurrences[NodeIndex];
-		if (OriginalItem.IsValid())
-		{
-			Item->SpokenText = FString::Printf(TEXT("→ %s"), *OriginalItem->SpokenText);
-			// Also copy the paraphrase text so linked lines show their paraphrases
-			Item->ParaphraseText = OriginalItem->ParaphraseText;
-		}
-		else
-		{
-			Item->SpokenText = FString::Printf(TEXT("→ See Node %d"), NodeIndex);
-		}
+	INC_DWORD_STAT(STAT_DA2Dialog_NumTreeItems);
+
+	return &Item;
+}
+
+void SDialogTreeView::MaterializeChildren(FDialogTreeItem* Item)
+{
+	if (!Item || Item->bChildrenBuilt || !CurrentConversation.IsValid())
+		return;
+
+	Item->bChildrenBuilt = true;
 
-		// References don't continue recursing to avoid infinite loops
-		if (ParentItem.IsValid())
+	const FDialogNode* Node = CurrentConversation->FindNode(Item->NodeIndex);
+	if (!Node)
+		return;
+
+	// Children are appended back to back, so they form one contiguous range of the pool
+	Item->FirstChildIndex = ItemPool.Num();
+	for (int32 LinkIndex = 0; LinkIndex < Node->Links.Num(); ++LinkIndex)
+	{
+		if (CreateTreeItem(Node->Links[LinkIndex].TargetNodeIndex, Item, LinkIndex))
 		{
-			ParentItem->Children.Add(Item);
+			++Item->NumChildren;
 		}
-		return;
 	}
+}
 
-	// This is the first occurrence - mark it
-	FirstOccurrences.Add(NodeIndex, Item);
-	Item->bIsReference = false;
+void SDialogTreeView::ResolveItemText(FDialogTreeItem* Item)
+{
+	if (!Item || Item->bTextResolved || !CurrentConversation.IsValid())
+		return;
 
-	// Set display text from TLK strings
-	if (DataManager.IsValid())
-	{
-		// Get the spoken line text (lineTalk)
-		FString SpokenLine = DataManager->GetTLKString(Node->TLKStringID);
+	Item->bTextResolved = true;
 
-		// Check if this is actually "not found" vs legitimately empty
-		// Look for the specific format: [TLK xxxxx - Not Found]
-		bool bIsNotFound = SpokenLine.StartsWith(TEXT("[TLK ")) && SpokenLine.EndsWith(TEXT(" - Not Found]"));
+	const FDialogNode* Node = CurrentConversation->FindNode(Item->NodeIndex);
+	if (!Node)
+		return;
 
-		// Handle empty/special case lines
-		if (SpokenLine.IsEmpty() || SpokenLine == TEXT("-1") || bIsNotFound)
-		{
-			if (Node->Links.Num() == 0)
-			{
-				// Empty line with no children = end conversation
-				Item->SpokenText = TEXT("[[END DIALOG]]");
-			}
-			else
-			{
-				// Empty line with children = continue/connector node
-				Item->SpokenText = TEXT("[[CONTINUE]]");
-			}
-		}
-		else
+	// References show the original occurrence's text (the row adds the link arrow)
+	Item->SpokenText = GetSpokenTextView(*Node);
+
+	if (Item->bIsReference)
+	{
+		// Also show the original's paraphrase (from the link that leads to the first occurrence)
+		const FDialogOccurrence* FirstOccurrence = TreeModel->FindFirstOccurrence(Item->NodeIndex);
+		const FDialogNode* OriginalParent = FirstOccurrence ? CurrentConversation->FindNode(FirstOccurrence->ParentNodeIndex) : nullptr;
+		if (OriginalParent && OriginalParent->Links.IsValidIndex(FirstOccurrence->LinkIndex))
 		{
-			// Add TLK ID prefix for easier sleuthing
-			Item->SpokenText = FString::Printf(TEXT("[TLK %d] %s"), Node->TLKStringID, *SpokenLine);
+			Item->ParaphraseTLKID = OriginalParent->Links[FirstOccurrence->LinkIndex].TLKStringID;
+			Item->ParaphraseText = GetParaphraseTextView(Item->ParaphraseTLKID);
 		}
-
-		Item->ParaphraseText = TEXT("");
 	}
-	else
+	else if (Item->ParaphraseTLKID != -1)
 	{
-		// Fallback if no data manager
-		Item->ParaphraseText = TEXT("");
-		Item->SpokenText = FString::Printf(TEXT("TLK %d"), Node->TLKStringID);
+		Item->ParaphraseText = GetParaphraseTextView(Item->ParaphraseTLKID);
+
+		// SANITY CHECK: Paraphrase text should ONLY exist on player turns
+		if (!Item->ParaphraseText.IsEmpty() && Item->bIsNPCTurn)
+		{
+			UE_LOG(LogDA2Dialog, Error, TEXT("ERROR: Found paraphrase text on NPC turn! Node %d has paraphrase: %s"),
+			       Item->NodeIndex, *Item->GetParaphraseDisplayText());
+			checkf(false, TEXT("Paraphrase text should only exist on player turns (found on NPC node %d)"),
+			       Item->NodeIndex);
+		}
 	}
+}
 
-	// Add to parent's children
-	if (ParentItem.IsValid())
+FStringView SDialogTreeView::GetSpokenTextView(const FDialogNode& Node) const
+{
+	// Fallback if no data manager (row shows just the TLK ID)
+	if (!DataManager.IsValid())
 	{
-		ParentItem->Children.Add(Item);
+		return FStringView();
 	}
 
-	// Recursively build children
-	for (const FDialogLink& Link : Node->Links)
+	// Get the spoken line text (lineTalk)
+	// Missing, placeholder (-1) and empty lines all come back as an empty view
+	FStringView SpokenLine = DataManager->GetTLKStringView(Node.TLKStringID);
+
+	// Handle empty/special case lines
+	if (SpokenLine.IsEmpty())
 	{
-		BuildTreeRecursive(Link.TargetNodeIndex, Item, FirstOccurrences);
+		// Empty line with no children = end conversation
+		// Empty line with children = continue/connector node
+		return Node.Links.Num() == 0 ? FDialogTreeItem::EndDialogText : FDialogTreeItem::ContinueText;
+	}
 
-		// After building the child, set its paraphrase text from the link
-		if (!Item->Children.IsEmpty() && DataManager.IsValid())
-		{
-			TSharedPtr<FDialogTreeItem> LastChild = Item->Children.Last();
-			if (LastChild.IsValid() && !LastChild->bIsReference)
-			{
-				// Store the paraphrase TLK ID for audio lookup
-				LastChild->ParaphraseTLKID = Link.TLKStringID;
+	return SpokenLine;
+}
 
-				// Get paraphrase from link's TLK (not node's TLK)
-				FString ParaphraseText = DataManager->GetTLKString(Link.TLKStringID);
+FStringView SDialogTreeView::GetParaphraseTextView(int32 ParaphraseTLKID) const
+{
+	if (!DataManager.IsValid())
+	{
+		return FStringView();
+	}
 
-				// Only set paraphrase if it's actually valid text (not empty, not placeholder, not "Not Found")
-				// If it's validly empty, leave ParaphraseText blank
-				if (!FDialogTreeItem::IsValidlyEmpty(ParaphraseText))
-				{
-					// SANITY CHECK: Paraphrase text should ONLY exist on player turns
-					if (LastChild->bIsNPCTurn)
-					{
-						UE_LOG(LogTemp, Error, TEXT("ERROR: Found paraphrase text on NPC turn! Node %d has paraphrase: %s"),
-						       LastChild->NodeIndex, *ParaphraseText);
-						checkf(false, TEXT("Paraphrase text should only exist on player turns (found on NPC node %d)"),
-						       LastChild->NodeIndex);
-					}
+	// Get paraphrase from link's TLK (not node's TLK)
+	FStringView ParaphraseText = DataManager->GetTLKStringView(ParaphraseTLKID);
 
-					// Add TLK ID prefix for easier sleuthing
-					LastChild->ParaphraseText = FString::Printf(TEXT("[TLK %d] %s"), Link.TLKStringID, *ParaphraseText);
-				}
-				// else: ParaphraseText remains empty which is what we want for the UI
-			}
-		}
+	// Only show paraphrase if it's actually valid text (not empty, not placeholder, not "Not Found")
+	if (FDialogTreeItem::IsValidlyEmpty(ParaphraseText))
+	{
+		return FStringView();
 	}
+
+	return ParaphraseText;
 }
 
-TSharedPtr<FDialogTreeItem> SDialogTreeView::FindTreeItem(int32 NodeIndex)
+FDialogTreeItem* SDialogTreeView::FindTreeItem(int32 NodeIndex)
 {
-	for (TSharedPtr<FDialogTreeItem>& RootItem : RootItems)
-	{
-		TSharedPtr<FDialogTreeItem> Found = FindTreeItemRecursive(NodeIndex, RootItem);
-		if (Found.IsValid())
-			return Found;
-	}
-	return nullptr;
+	// In depth-first order the first row showing a node is always its first occurrence
+	return FindFirstOccurrence(NodeIndex);
 }
 
-TSharedPtr<FDialogTreeItem> SDialogTreeView::FindTreeItemRecursive(int32 NodeIndex, TSharedPtr<FDialogTreeItem> Item)
+FDialogTreeItem* SDialogTreeView::FindFirstOccurrence(int32 NodeIndex)
 {
-	if (!Item.IsValid())
+	if (!TreeModel.IsValid())
 		return nullptr;
 
-	if (Item->NodeIndex == NodeIndex)
-		return Item;
-
-	for (TSharedPtr<FDialogTreeItem>& Child : Item->Children)
+	// Already materialized - constant time
+	if (const int32* ItemIndex = FirstOccurrenceItems.Find(NodeIndex))
 	{
-		TSharedPtr<FDialogTreeItem> Found = FindTreeItemRecursive(NodeIndex, Child);
-		if (Found.IsValid())
-			return Found;
+		return &ItemPool[*ItemIndex];
 	}
 
-	return nullptr;
-}
+	// Walk the first-occurrence chain up to the nearest materialized ancestor
+	// (every entry line is materialized at build time, so the chain always ends in one if the node is reachable)
+	TArray<int32, TInlineAllocator<32>> PendingNodes;
+	int32 CurrentNodeIndex = NodeIndex;
+	while (!FirstOccurrenceItems.Contains(CurrentNodeIndex))
+	{
+		const FDialogOccurrence* Occurrence = TreeModel->FindFirstOccurrence(CurrentNodeIndex);
+		if (!Occurrence || Occurrence->ParentNodeIndex == INDEX_NONE)
+			return nullptr;
 
-TSharedPtr<FDialogTreeItem> SDialogTreeView::FindFirstOccurrence(int32 NodeIndex)
-{
-	for (TSharedPtr<FDialogTreeItem>& RootItem : RootItems)
+		PendingNodes.Add(CurrentNodeIndex);
+		CurrentNodeIndex = Occurrence->ParentNodeIndex;
+	}
+
+	// Materialize back down along the chain, each step registers the next first occurrence
+	for (int32 Step = PendingNodes.Num() - 1; Step >= 0; --Step)
 	{
-		TSharedPtr<FDialogTreeItem> Found = FindFirstOccurrenceRecursive(NodeIndex, RootItem);
-		if (Found.IsValid())
-			return Found;
+		MaterializeChildren(&ItemPool[FirstOccurrenceItems.FindChecked(CurrentNodeIndex)]);
+
+		CurrentNodeIndex = PendingNodes[Step];
+		if (!FirstOccurrenceItems.Contains(CurrentNodeIndex))
+			return nullptr;
 	}
-	return nullptr;
+
+	return &ItemPool[FirstOccurrenceItems.FindChecked(NodeIndex)];
 }
 
-TSharedPtr<FDialogTreeItem> SDialogTreeView::FindFirstOccurrenceRecursive(int32 NodeIndex, TSharedPtr<FDialogTreeItem> Item)
+FDialogTreeItem* SDialogTreeView::FindOccurrenceItem(int32 NodeIndex, const FDialogOccurrence& Occurrence)
 {
-	if (!Item.IsValid())
-		return nullptr;
+	// Occurrences below the entry lines only exist once their parent's first occurrence has been expanded
+	int32 ParentItemIndex = INDEX_NONE;
+	if (Occurrence.ParentNodeIndex != INDEX_NONE)
+	{
+		FDialogTreeItem* ParentItem = FindFirstOccurrence(Occurrence.ParentNodeIndex);
+		if (!ParentItem)
+			return nullptr;
 
-	// Only return if this is the first occurrence (not a reference)
-	if (Item->NodeIndex == NodeIndex && !Item->bIsReference)
-		return Item;
+		MaterializeChildren(ParentItem);
+		ParentItemIndex = GetItemIndex(ParentItem);
+	}
 
-	for (TSharedPtr<FDialogTreeItem>& Child : Item->Children)
+	for (auto It = OccurrenceItems.CreateConstKeyIterator(NodeIndex); It; ++It)
 	{
-		TSharedPtr<FDialogTreeItem> Found = FindFirstOccurrenceRecursive(NodeIndex, Child);
-		if (Found.IsValid())
-			return Found;
+		FDialogTreeItem& Candidate = ItemPool[It.Value()];
+		if (Candidate.ParentIndex == ParentItemIndex && Candidate.LinkIndex == Occurrence.LinkIndex)
+		{
+			return &Candidate;
+		}
 	}
 
 	return nullptr;
 }
 
-void SDialogTreeView::OnMouseDoubleClick(TSharedPtr<FDialogTreeItem> Item)
+void SDialogTreeView::AutoPlayPath(FDialogTreeItem* Item)
 {
-	// Only handle double-click for reference nodes
-	if (!Item.IsValid() || !Item->bIsReference)
+	if (!Item || !AudioManager.IsValid())
+	{
 		return;
+	}
 
-	// Find the first occurrence of the referenced node
-	TSharedPtr<FDialogTreeItem> FirstOccurrence = FindFirstOccurrence(Item->ReferencedNodeIndex);
+	// Cap the walk down first children, a long chain of auto-continues shouldn't queue the rest of the conversation
+	constexpr int32 MaxPathLines = 256;
 
-	if (FirstOccurrence.IsValid() && TreeView.IsValid())
+	// Ancestors, entry line first
+	TArray<FDialogTreeItem*> Path;
+	for (FDialogTreeItem* Ancestor = Item; Ancestor; Ancestor = Ancestor->ParentIndex != INDEX_NONE ? &ItemPool[Ancestor->ParentIndex] : nullptr)
 	{
-		// Navigate to the first occurrence
-		TreeView->SetSelection(FirstOccurrence);
-		TreeView->RequestScrollIntoView(FirstOccurrence);
+		Path.Add(Ancestor);
+	}
+	Algo::Reverse(Path);
+
+	// Then on down the first reply; references loop back to lines already on the path, so the walk ends at one
+	for (FDialogTreeItem* Current = Item; Path.Num() < MaxPathLines && !Current->bIsReference;)
+	{
+		MaterializeChildren(Current);
+		if (Current->NumChildren == 0)
+		{
+			break;
+		}
 
-		UE_LOG(LogTemp, Log, TEXT("Jumped from reference to first occurrence of node %d"), Item->ReferencedNodeIndex);
+		Current = &ItemPool[Current->FirstChildIndex];
+		Path.Add(Current);
 	}
-	else
+
+	// Silent lines (auto-continues, lines without a recording) are skipped using the precomputed availability
+	const uint8 Gender = static_cast<uint8>(DataManager.IsValid() ? DataManager->GetPlayerGender() : EPlayerGender::Male);
+	TArray<int32> TLKIDs;
+	for (const FDialogTreeItem* PathItem : Path)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Could not find first occurrence of node %d"), Item->ReferencedNodeIndex);
+		if (PathItem->bHasAudio[Gender])
+		{
+			TLKIDs.Add(PathItem->TLKStringID);
+		}
 	}
+
+	AudioManager->StartAutoPlay(TLKIDs);
 }
 
-int32 SDialogTreeView::DetectConversationOwner() const
+void SDialogTreeView::JumpToNextOccurrence(FDialogTreeItem* Item)
 {
-	if (!CurrentConversation.IsValid())
-		return -1;
+	if (!Item || !TreeModel.IsValid())
+		return;
 
-	// Count speaker IDs, excluding known player IDs
-	TMap<int32, int32> NPCSpeakerCounts;
+	TArray<FDialogOccurrence> Occurrences;
+	TreeModel->FindAllOccurrences(Item->NodeIndex, Occurrences);
+	if (Occurrences.Num() < 2)
+		return;
 
-	for (const FDialogNode& Node : CurrentConversation->Nodes)
+	const int32 ParentNodeIndex = Item->ParentIndex != INDEX_NONE ? ItemPool[Item->ParentIndex].NodeIndex : INDEX_NONE;
+	const int32 CurrentOccurrence = Occurrences.IndexOfByPredicate([ParentNodeIndex, Item](const FDialogOccurrence& Occurrence)
 	{
-		// Skip player speakers (hardcoded list from flip-flop analysis)
-		if (FDialogTreeItem::KnownPlayerSpeakerIDs.Contains(Node.SpeakerID))
-			continue;
+		return Occurrence.ParentNodeIndex == ParentNodeIndex && Occurrence.LinkIndex == Item->LinkIndex;
+	});
 
-		// Count this NPC speaker
-		int32& Count = NPCSpeakerCounts.FindOrAdd(Node.SpeakerID, 0);
-		Count++;
-	}
+	const FDialogOccurrence& NextOccurrence = Occurrences[(CurrentOccurrence + 1) % Occurrences.Num()];
+	RevealItem(FindOccurrenceItem(Item->NodeIndex, NextOccurrence));
+}
 
-	// Find most frequent NPC speaker
-	int32 MostFrequentSpeaker = -1;
-	int32 MaxCount = 0;
+void SDialogTreeView::RevealItem(FDialogTreeItem* Item)
+{
+	if (!Item || !TreeView.IsValid())
+		return;
 
-	for (const auto& Pair : NPCSpeakerCounts)
+	// Expand every ancestor so the row is actually in the list
+	for (int32 AncestorIndex = Item->ParentIndex; AncestorIndex != INDEX_NONE; AncestorIndex = ItemPool[AncestorIndex].ParentIndex)
 	{
-		if (Pair.Value > MaxCount)
-		{
-			MaxCount = Pair.Value;
-			MostFrequentSpeaker = Pair.Key;
-		}
+		TreeView->SetItemExpansion(&ItemPool[AncestorIndex], true);
 	}
 
-	if (MostFrequentSpeaker != -1)
+	TreeView->SetSelection(Item);
+	TreeView->RequestScrollIntoView(Item);
+}
+
+void SDialogTreeView::OnMouseDoubleClick(FDialogTreeItem* Item)
+{
+	// Only handle double-click for reference nodes
+	if (!Item || !Item->bIsReference)
+		return;
+
+	// Find the first occurrence of the referenced node
+	FDialogTreeItem* FirstOccurrence = FindFirstOccurrence(Item->ReferencedNodeIndex);
+
+	if (FirstOccurrence && TreeView.IsValid())
 	{
-		UE_LOG(LogTemp, Log, TEXT("Detected conversation owner: Speaker %d (%d lines)"),
-			MostFrequentSpeaker, MaxCount);
-	}
+		// Navigate to the first occurrence
+		RevealItem(FirstOccurrence);
 
-	return MostFrequentSpeaker;
+		UE_LOG(LogDA2Dialog, Log, TEXT("Jumped from reference to first occurrence of node %d"), Item->ReferencedNodeIndex);
+	}
+	else
+	{
+		UE_LOG(LogDA2Dialog, Warning, TEXT("Could not find first occurrence of node %d"), Item->ReferencedNodeIndex);
+	}
 }
 
 FSlateColor SDialogTreeView::GetSpeakerColor(int32 SpeakerID) const
@@ -990,80 +1292,3 @@ FSlateColor SDialogTreeView::GetSpeakerColor(int32 SpeakerID) const
 	else
 		return FLinearColor::Gray;
 }
-
-FString SDialogTreeView::ResolveCompanionFromPartyFlag(int32 FlagIndex)
-{
-	// ============================================================================
-	// PARTY FLAG REFERENCE MAP (plt_gen00pt_party)
-	// ============================================================================
-	// Based on bytecode analysis of gen00pt_party.txt and conversation XML usage
-	//
-	// INDIVIDUAL COMPANION FLAGS (256-271, 276-277):
-	//   256/257 = Carver      (odd=257 is primary, reversed from others)
-	//   258/259 = Bethany
-	//   260/261 = Varric
-	//   262/263 = Aveline
-	//   264/265 = Isabela
-	//   266/267 = Merrill
-	//   268/269 = Anders
-	//   270/271 = Fenris
-	//   276/277 = Sebastian
-	//
-	// SPECIAL COMPOSITE FLAGS (272-275):
-	//   272 = Any female companions in party OR player is female
-	//         Checks: Bethany || Merrill || Isabela || GetCreatureGender(Hero) == 2
-	//
-	//   273 = Party contains mage/s (NPC dialog context)
-	//         Checks: Bethany || Merrill || Anders
-	//         Used by NPCs talking TO the player about mages (e.g., Grace in mag101)
-	//
-	//   274 = Party contains mage/s (companion banter context)
-	//         Checks: Bethany || Merrill || Anders
-	//         Used in companion-to-companion banter (follower_banter.xml)
-	//         Functionally identical to 273, different context
-	//
-	//   275 = Player is alone (no active companions)
-	//         Checks: GetParty().size == 1
-	//         Used for solo-only dialog options and combat barks
-	// ============================================================================
-
-	// Special composite flags (272-275)
-	if (FlagIndex == 272)
-	{
-		return TEXT("[Party: Female/s or Female Player]");
-	}
-	else if (FlagIndex == 273 || FlagIndex == 274)
-	{
-		return TEXT("[Party: Contains Mage/s]");
-	}
-	else if (FlagIndex == 275)
-	{
-		return TEXT("[Party: Solo Player]");
-	}
-
-	// Individual companion flags (256-271, 276-277)
-	// Carver is unique: uses ODD flag 257 as primary (reversed from others)
-	if (FlagIndex == 257 || FlagIndex == 256)
-	{
-		return TEXT("Carver");
-	}
-
-	// For all other companions, use even flags (256-278 range, even = in party)
-	// Note: Normalize to base even flag
-	int32 BaseFlag = (FlagIndex % 2 == 0) ? FlagIndex : (FlagIndex - 1);
-
-	switch (BaseFlag)
-	{
-	case 258: return TEXT("Bethany");
-	case 260: return TEXT("Varric");
-	case 262: return TEXT("Aveline");
-	case 264: return TEXT("Isabela");
-	case 266: return TEXT("Merrill");
-	case 268: return TEXT("Anders");
-	case 270: return TEXT("Fenris");
-	case 276: return TEXT("Sebastian");
-	default:
-		UE_LOG(LogTemp, Warning, TEXT("Unknown party flag: %d"), FlagIndex);
-		return FString::Printf(TEXT("Unknown Flag %d"), FlagIndex);
-	}
-}
@@ -3,17 +3,77 @@
 #include "UI/SDialogViewerWindow.h"
 #include "UI/SDialogTreeView.h"
 #include "UI/SDialogWheel.h"
+#include "UI/DialogTreeModel.h"
 #include "Data/DialogDataManager.h"
+#include "Data/DialogSearchIndex.h"
 #include "Widgets/Layout/SBorder.h"
 #include "Widgets/Layout/SSplitter.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SComboBox.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Views/SListView.h"
+#include "Widgets/Views/STableRow.h"
 #include "Widgets/Text/STextBlock.h"
+#include "Widgets/Images/SThrobber.h"
+#include "Slate/SInvalidationPanel.h"
 #include "EditorStyleSet.h"
 #include "DesktopPlatformModule.h"
 #include "IDesktopPlatform.h"
 #include "Misc/Paths.h"
+#include "Async/Async.h"
+#include "DA2DialogViewerLog.h"
+#include <atomic>
+
+/**
+ * Loading stage reported by the worker for the status bar
+ */
+enum class EConversationLoadStage : uint8
+{
+	Reading, // Parsing XML and scanning UTC files for the owner
+	BuildingTree // Analyzing the conversation graph
+};
+
+/**
+ * State shared between the window and one background conversation load
+ */
+struct FConversationLoadRequest
+{
+	// File being loaded
+	FString ConversationPath;
+
+	// Player gender when the load was started (the worker never reads the live setting)
+	EPlayerGender Gender = EPlayerGender::Male;
+
+	// Node to show once loaded (INDEX_NONE for the first entry node)
+	int32 NodeIndex = INDEX_NONE;
+
+	// Set by the game thread when a newer load replaces this one (or the window closes)
+	std::atomic<bool> bCancelled{false};
+
+	// Current stage, written by the worker
+	std::atomic<EConversationLoadStage> Stage{EConversationLoadStage::Reading};
+};
+
+/**
+ * State shared between the window and the background search index open/build
+ */
+struct FSearchIndexLoadRequest
+{
+	// Set when the window closes
+	std::atomic<bool> bCancelled{false};
+};
+
+SDialogViewerWindow::~SDialogViewerWindow()
+{
+	// Let the workers bail out early, their completion callbacks only hold a weak pointer to us
+	CancelPendingLoad();
+
+	if (PendingSearchIndex.IsValid())
+	{
+		PendingSearchIndex->bCancelled = true;
+	}
+}
 
 void SDialogViewerWindow::Construct(const FArguments& InArgs, TSharedPtr<FDialogDataManager> InDataManager)
 {
@@ -60,6 +120,16 @@ void SDialogViewerWindow::Construct(const FArguments& InArgs, TSharedPtr<FDialog
 					.OnClicked(this, &SDialogViewerWindow::OnLoadConversationClicked)
 				]
 
+				// Loading indicator
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(2.0f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(SThrobber)
+					.Visibility(this, &SDialogViewerWindow::GetLoadingVisibility)
+				]
+
 				// Reset plot state button
 				+ SHorizontalBox::Slot()
 				.AutoWidth()
@@ -70,6 +140,22 @@ void SDialogViewerWindow::Construct(const FArguments& InArgs, TSharedPtr<FDialog
 					.OnClicked(this, &SDialogViewerWindow::OnResetPlotStateClicked)
 				]
 
+				// Search across all conversations
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(2.0f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(SBox)
+					.WidthOverride(300.0f)
+					[
+						SAssignNew(SearchBox, SSearchBox)
+						.HintText(this, &SDialogViewerWindow::GetSearchHintText)
+						.OnTextChanged(this, &SDialogViewerWindow::OnSearchTextChanged)
+						.OnTextCommitted(this, &SDialogViewerWindow::OnSearchTextCommitted)
+					]
+				]
+
 				// Spacer
 				+ SHorizontalBox::Slot()
 				.FillWidth(1.0f)
@@ -95,6 +181,23 @@ void SDialogViewerWindow::Construct(const FArguments& InArgs, TSharedPtr<FDialog
 				]
 			]
 
+			// Search results
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(4.0f)
+			[
+				SNew(SBox)
+				.MaxDesiredHeight(200.0f)
+				.Visibility(this, &SDialogViewerWindow::GetSearchResultsVisibility)
+				[
+					SAssignNew(SearchResultsList, SListView<TSharedPtr<FDialogSearchHit>>)
+					.ListItemsSource(&SearchResults)
+					.OnGenerateRow(this, &SDialogViewerWindow::OnGenerateSearchResultRow)
+					.OnMouseButtonClick(this, &SDialogViewerWindow::OnSearchResultClicked)
+					.SelectionMode(ESelectionMode::Single)
+				]
+			]
+
 			// Conversation name
 			+ SVerticalBox::Slot()
 			.AutoHeight()
@@ -137,7 +240,11 @@ void SDialogViewerWindow::Construct(const FArguments& InArgs, TSharedPtr<FDialog
 						.HAlign(HAlign_Center)
 						.VAlign(VAlign_Center)
 						[
-							DialogWheel.ToSharedRef()
+							// Hover repaints invalidate only the wheel, the rest of the window stays cached
+							SNew(SInvalidationPanel)
+							[
+								DialogWheel.ToSharedRef()
+							]
 						]
 					]
 				]
@@ -153,6 +260,8 @@ void SDialogViewerWindow::Construct(const FArguments& InArgs, TSharedPtr<FDialog
 			]
 		]
 	];
+
+	StartLoadSearchIndex();
 }
 
 FReply SDialogViewerWindow::OnLoadConversationClicked()
@@ -165,7 +274,7 @@ FReply SDialogViewerWindow::OnLoadConversationClicked()
 	}
 
 	TArray<FString> OutFiles;
-	FString DefaultPath = FPaths::Combine(DataManager->GetDataDirectory(), TEXT("DLG/cnv"));
+	FString DefaultPath = DataManager->GetConversationDirectory();
 
 	const void* ParentWindowHandle = FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr);
 
@@ -181,31 +290,223 @@ FReply SDialogViewerWindow::OnLoadConversationClicked()
 
 	if (bOpened && OutFiles.Num() > 0)
 	{
-		FString ConversationPath = OutFiles[0];
+		StartLoadConversation(OutFiles[0]);
+	}
+
+	return FReply::Handled();
+}
 
-		// Load conversation
-		if (DataManager->LoadConversation(ConversationPath))
+void SDialogViewerWindow::StartLoadConversation(const FString& ConversationPath, int32 NodeIndex)
+{
+	// A newer pick always wins, the old worker notices the flag and stops early
+	CancelPendingLoad();
+
+	TSharedPtr<FConversationLoadRequest> Request = MakeShared<FConversationLoadRequest>();
+	Request->ConversationPath = ConversationPath;
+	Request->NodeIndex = NodeIndex;
+	Request->Gender = DataManager->GetPlayerGender();
+	PendingLoad = Request;
+
+	TSharedPtr<FDialogDataManager> Manager = DataManager;
+	TWeakPtr<SDialogViewerWindow> WeakThis = SharedThis(this);
+
+	Async(EAsyncExecution::ThreadPool, [Manager, Request, WeakThis]()
+	{
+		TSharedPtr<const FDialogTreeModel> Model;
+
+		TSharedPtr<FConversation> Conversation = Manager->ReadConversation(Request->ConversationPath, &Request->bCancelled);
+		if (Conversation.IsValid())
 		{
-			// Update tree view
-			TreeView->LoadConversation(DataManager->GetCurrentConversation());
+			Request->Stage = EConversationLoadStage::BuildingTree;
+			Model = FDialogTreeModel::Build(Conversation, Manager, Request->Gender, &Request->bCancelled);
+		}
 
-			// Navigate to first entry node
-			TSharedPtr<FConversation> Conv = DataManager->GetCurrentConversation();
-			if (Conv.IsValid() && Conv->EntryLinks.Num() > 0)
+		AsyncTask(ENamedThreads::GameThread, [Request, Model, WeakThis]()
+		{
+			if (TSharedPtr<SDialogViewerWindow> This = WeakThis.Pin())
 			{
-				int32 FirstNodeIndex = Conv->EntryLinks[0].TargetNodeIndex;
-				TreeView->NavigateToNode(FirstNodeIndex);
+				This->OnConversationLoaded(Request, Model);
 			}
+		});
+	});
+}
 
-			CurrentStatus = FText::FromString(FString::Printf(TEXT("Loaded: %s"), *FPaths::GetBaseFilename(ConversationPath)));
-		}
-		else
+void SDialogViewerWindow::OnConversationLoaded(TSharedPtr<FConversationLoadRequest> Request, TSharedPtr<const FDialogTreeModel> Model)
+{
+	// Superseded by a newer load, drop the result
+	if (Request != PendingLoad || Request->bCancelled)
+	{
+		return;
+	}
+
+	PendingLoad.Reset();
+
+	if (!Model.IsValid())
+	{
+		CurrentStatus = FText::FromString(TEXT("Failed to load conversation"));
+		return;
+	}
+
+	// Swap everything over in one go so the UI never sees a half-loaded conversation
+	DataManager->SetCurrentConversation(Model->Conversation);
+	TreeView->LoadModel(Model);
+
+	// Navigate to the requested node (search hit), otherwise the first entry node
+	if (Request->NodeIndex != INDEX_NONE)
+	{
+		TreeView->NavigateToNode(Request->NodeIndex);
+	}
+	else if (Model->Conversation->EntryLinks.Num() > 0)
+	{
+		int32 FirstNodeIndex = Model->Conversation->EntryLinks[0].TargetNodeIndex;
+		TreeView->NavigateToNode(FirstNodeIndex);
+	}
+
+	CurrentStatus = FText::FromString(FString::Printf(TEXT("Loaded: %s"), *FPaths::GetBaseFilename(Request->ConversationPath)));
+}
+
+void SDialogViewerWindow::CancelPendingLoad()
+{
+	if (PendingLoad.IsValid())
+	{
+		PendingLoad->bCancelled = true;
+		PendingLoad.Reset();
+	}
+}
+
+EVisibility SDialogViewerWindow::GetLoadingVisibility() const
+{
+	return PendingLoad.IsValid() ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+void SDialogViewerWindow::StartLoadSearchIndex()
+{
+	if (!DataManager.IsValid() || DataManager->GetDataDirectory().IsEmpty())
+	{
+		return;
+	}
+
+	TSharedPtr<FSearchIndexLoadRequest> Request = MakeShared<FSearchIndexLoadRequest>();
+	PendingSearchIndex = Request;
+
+	TSharedPtr<FDialogDataManager> Manager = DataManager;
+	TWeakPtr<SDialogViewerWindow> WeakThis = SharedThis(this);
+
+	Async(EAsyncExecution::ThreadPool, [Manager, Request, WeakThis]()
+	{
+		TSharedPtr<const FDialogSearchIndex> Index = FDialogSearchIndex::LoadOrBuild(FDialogSearchIndex::GetDefaultIndexPath(), *Manager, &Request->bCancelled);
+
+		AsyncTask(ENamedThreads::GameThread, [Request, Index, WeakThis]()
+		{
+			TSharedPtr<SDialogViewerWindow> This = WeakThis.Pin();
+			if (!This.IsValid() || This->PendingSearchIndex != Request)
+			{
+				return;
+			}
+
+			This->PendingSearchIndex.Reset();
+			This->SearchIndex = Index;
+
+			// Anything typed while the index was loading found nothing, search it now
+			if (This->SearchBox.IsValid() && !This->SearchBox->GetText().IsEmpty())
+			{
+				This->OnSearchTextChanged(This->SearchBox->GetText());
+			}
+		});
+	});
+}
+
+void SDialogViewerWindow::OnSearchTextChanged(const FText& InText)
+{
+	SearchResults.Reset();
+
+	if (SearchIndex.IsValid() && !InText.IsEmpty())
+	{
+		TArray<FDialogSearchHit> Hits;
+		const double StartTime = FPlatformTime::Seconds();
+		SearchIndex->Search(InText.ToString(), MaxSearchResults, Hits);
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		SearchResults.Reserve(Hits.Num());
+		for (FDialogSearchHit& Hit : Hits)
 		{
-			CurrentStatus = FText::FromString(TEXT("Failed to load conversation"));
+			SearchResults.Add(MakeShared<FDialogSearchHit>(MoveTemp(Hit)));
 		}
+
+		CurrentStatus = FText::FromString(FString::Printf(TEXT("%s%d matches for \"%s\" (%.2f ms)"),
+			SearchResults.Num() >= MaxSearchResults ? TEXT("First ") : TEXT(""), SearchResults.Num(), *InText.ToString(), ElapsedMs));
 	}
 
-	return FReply::Handled();
+	if (SearchResultsList.IsValid())
+	{
+		SearchResultsList->RequestListRefresh();
+	}
+}
+
+void SDialogViewerWindow::OnSearchTextCommitted(const FText& InText, ETextCommit::Type CommitType)
+{
+	if (CommitType == ETextCommit::OnEnter && SearchResults.Num() > 0)
+	{
+		NavigateToSearchHit(*SearchResults[0]);
+	}
+}
+
+TSharedRef<ITableRow> SDialogViewerWindow::OnGenerateSearchResultRow(TSharedPtr<FDialogSearchHit> Hit, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	const FString LineText(DataManager->GetTLKStringView(Hit->TLKID));
+
+	return SNew(STableRow<TSharedPtr<FDialogSearchHit>>, OwnerTable)
+		.Padding(FMargin(4.0f, 1.0f))
+		[
+			SNew(SHorizontalBox)
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(0.0f, 0.0f, 8.0f, 0.0f)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(FString::Printf(TEXT("%s #%d"), *FPaths::GetBaseFilename(Hit->ConversationPath), Hit->NodeIndex)))
+				.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+			]
+
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(LineText))
+			]
+		];
+}
+
+void SDialogViewerWindow::OnSearchResultClicked(TSharedPtr<FDialogSearchHit> Hit)
+{
+	if (Hit.IsValid())
+	{
+		NavigateToSearchHit(*Hit);
+	}
+}
+
+void SDialogViewerWindow::NavigateToSearchHit(const FDialogSearchHit& Hit)
+{
+	// Same conversation, just jump
+	TSharedPtr<FConversation> Current = DataManager->GetCurrentConversation();
+	if (Current.IsValid() && Current->ConversationName == FPaths::GetBaseFilename(Hit.ConversationPath) && !PendingLoad.IsValid())
+	{
+		TreeView->NavigateToNode(Hit.NodeIndex);
+		return;
+	}
+
+	StartLoadConversation(FPaths::Combine(DataManager->GetConversationDirectory(), Hit.ConversationPath), Hit.NodeIndex);
+}
+
+EVisibility SDialogViewerWindow::GetSearchResultsVisibility() const
+{
+	return SearchResults.Num() > 0 ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+FText SDialogViewerWindow::GetSearchHintText() const
+{
+	return FText::FromString(PendingSearchIndex.IsValid() ? TEXT("Indexing dialog lines...") : TEXT("Search dialog lines"));
 }
 
 FReply SDialogViewerWindow::OnResetPlotStateClicked()
@@ -225,6 +526,16 @@ void SDialogViewerWindow::OnGenderChanged(int32 NewSelection, ESelectInfo::Type
 	{
 		DataManager->SetPlayerGender(NewSelection == 0 ? EPlayerGender::Male : EPlayerGender::Female);
 	}
+
+	if (DialogWheel.IsValid())
+	{
+		DialogWheel->RefreshText();
+	}
+
+	if (TreeView.IsValid())
+	{
+		TreeView->RefreshText();
+	}
 }
 
 void SDialogViewerWindow::UpdateStatusText()
@@ -234,6 +545,12 @@ void SDialogViewerWindow::UpdateStatusText()
 
 FText SDialogViewerWindow::GetStatusText() const
 {
+	if (PendingLoad.IsValid())
+	{
+		const TCHAR* StageText = PendingLoad->Stage == EConversationLoadStage::Reading ? TEXT("reading conversation") : TEXT("building tree");
+		return FText::FromString(FString::Printf(TEXT("Loading %s (%s)..."), *FPaths::GetBaseFilename(PendingLoad->ConversationPath), StageText));
+	}
+
 	return CurrentStatus;
 }
 
@@ -270,7 +587,18 @@ FReply SDialogViewerWindow::OnGenderButtonClicked()
 
 		// Log the change
 		FString NewGender = (DataManager->GetPlayerGender() == EPlayerGender::Male) ? TEXT("Male") : TEXT("Female");
-		UE_LOG(LogTemp, Log, TEXT("DialogViewer: Player gender changed to %s"), *NewGender);
+		UE_LOG(LogDA2Dialog, Log, TEXT("DialogViewer: Player gender changed to %s"), *NewGender);
+	}
+
+	// Option text is gender-dependent and cached by the wheel, row text by the tree
+	if (DialogWheel.IsValid())
+	{
+		DialogWheel->RefreshText();
+	}
+
+	if (TreeView.IsValid())
+	{
+		TreeView->RefreshText();
 	}
 
 	return FReply::Handled();
@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UI/SDialogWaveformStrip.h"
+#include "Audio/DialogWaveformCache.h"
+#include "Rendering/DrawElements.h"
+
+void SDialogWaveformStrip::Construct(const FArguments& InArgs)
+{
+	Summary = InArgs._Summary;
+	DesiredSize = InArgs._DesiredSize;
+}
+
+FVector2D SDialogWaveformStrip::ComputeDesiredSize(float) const
+{
+	return DesiredSize;
+}
+
+int32 SDialogWaveformStrip::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+                                    FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const TSharedPtr<const FDialogWaveformSummary> CurrentSummary = Summary.Get();
+	const FVector2f LocalSize = FVector2f(AllottedGeometry.GetLocalSize());
+	if (!CurrentSummary.IsValid() || LocalSize.X < 2.0f || LocalSize.Y < 2.0f)
+	{
+		return LayerId;
+	}
+
+	// Coarsest level that still has a bucket per pixel; strips wider than the finest level stretch it
+	const int32 Level = FDialogWaveformSummary::FindLevel(FMath::FloorToInt32(LocalSize.X));
+	const int32 Offset = FDialogWaveformSummary::GetLevelOffset(Level);
+	const int32 NumBuckets = FDialogWaveformSummary::GetLevelSize(Level);
+
+	const float HalfHeight = LocalSize.Y * 0.5f;
+	const float Scale = HalfHeight / 127.0f;
+	const float BucketWidth = LocalSize.X / NumBuckets;
+
+	// Zigzag through each bucket's max then min, so the whole strip is a single polyline
+	LinePoints.Reset(NumBuckets * 2);
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		const float X = (Bucket + 0.5f) * BucketWidth;
+		LinePoints.Add(FVector2f(X, HalfHeight - CurrentSummary->Maxs[Offset + Bucket] * Scale));
+		LinePoints.Add(FVector2f(X, HalfHeight - CurrentSummary->Mins[Offset + Bucket] * Scale));
+	}
+
+	const FLinearColor Color = CurrentSummary->IsClipped() ? FLinearColor(1.0f, 0.3f, 0.3f) : FLinearColor(0.5f, 1.0f, 0.5f, 0.8f);
+	FSlateDrawElement::MakeLines(
+		OutDrawElements,
+		LayerId,
+		AllottedGeometry.ToPaintGeometry(),
+		LinePoints,
+		ESlateDrawEffect::None,
+		InWidgetStyle.GetColorAndOpacityTint() * Color,
+		false,
+		1.0f
+	);
+
+	return LayerId;
+}
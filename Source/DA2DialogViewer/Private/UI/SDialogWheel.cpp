@@ -3,11 +3,14 @@
 #include "UI/SDialogWheel.h"
 #include "UI/SDialogTreeView.h"
 #include "Data/DialogDataManager.h"
+#include "Audio/DialogAudioManager.h"
 #include "Plot/ConditionEvaluator.h"
 #include "Plot/ActionExecutor.h"
 #include "Rendering/DrawElements.h"
 #include "Framework/Application/SlateApplication.h"
 #include "Fonts/FontMeasure.h"
+#include "DA2DialogViewerStats.h"
+#include "DA2DialogViewerLog.h"
 
 void SDialogWheel::Construct(const FArguments& InArgs, TSharedPtr<FDialogDataManager> InDataManager)
 {
@@ -18,6 +21,8 @@ void SDialogWheel::Construct(const FArguments& InArgs, TSharedPtr<FDialogDataMan
 
 void SDialogWheel::SetCurrentNode(const FDialogNode* InNode)
 {
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_WheelSetCurrentNode);
+
 	CurrentNode = InNode;
 	HoveredOptionIndex = -1;
 
@@ -140,8 +145,27 @@ void SDialogWheel::SetCurrentNode(const FDialogNode* InNode)
 		CurrentNode = nullptr; // Prevent any "Node X" text from showing
 	}
 
+	CacheOptionVisuals();
+
+	// Picking an option plays the player line it leads to, decode those in the background now
+	const TSharedPtr<FDialogAudioManager> AudioManager = TreeView.IsValid() ? TreeView->GetAudioManager() : nullptr;
+	if (AudioManager.IsValid() && CurrentNode && DataManager.IsValid())
+	{
+		const TSharedPtr<FConversation> Conversation = DataManager->GetCurrentConversation();
+		TArray<int32, TInlineAllocator<8>> TLKIDs;
+		for (const FDialogWheelOption& Option : Options)
+		{
+			if (const FDialogNode* TargetNode = Conversation.IsValid() ? Conversation->FindNode(Option.Link.TargetNodeIndex) : nullptr)
+			{
+				TLKIDs.Add(TargetNode->TLKStringID);
+			}
+		}
+		AudioManager->PrefetchDialogAudio(TLKIDs);
+	}
+
 	// Update visibility based on whether we have valid options
 	SetVisibility(Options.Num() > 0 ? EVisibility::Visible : EVisibility::Collapsed);
+	Invalidate(EInvalidateWidgetReason::Paint);
 }
 
 void SDialogWheel::Clear()
@@ -149,12 +173,101 @@ void SDialogWheel::Clear()
 	CurrentNode = nullptr;
 	Options.Empty();
 	HoveredOptionIndex = -1;
+	CenterText.Empty();
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SDialogWheel::RefreshText()
+{
+	CacheOptionVisuals();
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SDialogWheel::CacheOptionVisuals()
+{
+	CenterText = CurrentNode ? FString::Printf(TEXT("Node %d"), CurrentNode->NodeIndex) : FString();
+
+	if (Options.Num() == 0)
+	{
+		return;
+	}
+
+	const FSlateFontInfo TextFont = FCoreStyle::GetDefaultFontStyle("Regular", 9);
+	const FSlateFontInfo LabelFont = FCoreStyle::GetDefaultFontStyle("Bold", 10);
+	const TSharedPtr<FSlateFontMeasure> FontMeasure = FSlateApplication::IsInitialized()
+		? FSlateApplication::Get().GetRenderer()->GetFontMeasureService()
+		: TSharedPtr<FSlateFontMeasure>();
+
+	// Use larger hit area for text-based options (120x40 text box)
+	const FVector2D HitAreaHalfSize(120.0f / 2, 40.0f / 2);
+
+	for (int32 OptionIndex = 0; OptionIndex < Options.Num(); ++OptionIndex)
+	{
+		FDialogWheelOption& Option = Options[OptionIndex];
+
+		// Get actual dialog text from TLK string or use preview text
+		FString DialogText;
+		if (DataManager.IsValid())
+		{
+			DialogText = DataManager->GetTLKString(Option.Link.TLKStringID);
+			if (DialogText.IsEmpty())
+			{
+				DialogText = Option.Link.PreviewText;
+			}
+		}
+		if (DialogText.IsEmpty())
+		{
+			DialogText = FString::Printf(TEXT("[TLK %d]"), Option.Link.TLKStringID);
+		}
+
+		// Truncate long text for display
+		if (DialogText.Len() > 40)
+		{
+			DialogText = DialogText.Left(37) + TEXT("...");
+		}
+
+		Option.DisplayText = MoveTemp(DialogText);
+		Option.ToneColor = GetResponseTypeColor(Option.Link.ResponseType, Option.Link.IconOverride);
+		Option.ToneLabel = GetResponseTypeLabel(Option.Link.ResponseType, Option.Link.IconOverride);
+		Option.TextSize = FontMeasure.IsValid() ? FontMeasure->Measure(Option.DisplayText, TextFont) : FVector2D::ZeroVector;
+		Option.ToneLabelSize = FontMeasure.IsValid() ? FontMeasure->Measure(Option.ToneLabel, LabelFont) : FVector2D::ZeroVector;
+		Option.HitRect = FSlateRect(Option.Position - HitAreaHalfSize, Option.Position + HitAreaHalfSize);
+
+		// RefreshText re-caches under the mouse; the option it is over stays highlighted
+		Option.bIsHovered = (OptionIndex == HoveredOptionIndex);
+	}
+}
+
+void SDialogWheel::SetHoveredOption(int32 OptionIndex)
+{
+	if (OptionIndex == HoveredOptionIndex)
+	{
+		return;
+	}
+
+	if (Options.IsValidIndex(HoveredOptionIndex))
+	{
+		Options[HoveredOptionIndex].bIsHovered = false;
+	}
+
+	HoveredOptionIndex = OptionIndex;
+
+	if (Options.IsValidIndex(HoveredOptionIndex))
+	{
+		Options[HoveredOptionIndex].bIsHovered = true;
+		OnOptionHovered(HoveredOptionIndex);
+	}
+
+	// Paint-only invalidation: layout and every other widget in the window stay cached
+	Invalidate(EInvalidateWidgetReason::Paint);
 }
 
 int32 SDialogWheel::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry,
                             const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
                             int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
 {
+	DA2_SCOPE_CYCLE_COUNTER(STAT_DA2Dialog_WheelPaint);
+
 	const FVector2D Center = AllottedGeometry.GetLocalSize() / 2;
 
 	// Don't draw anything if no options (widget should be collapsed anyway)
@@ -184,8 +297,6 @@ int32 SDialogWheel::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeo
 	{
 		// Show hovered option's tone color and label
 		const FDialogWheelOption& HoveredOption = Options[HoveredOptionIndex];
-		FLinearColor ToneColor = GetResponseTypeColor(HoveredOption.Link.ResponseType, HoveredOption.Link.IconOverride);
-		FString ToneLabel = GetResponseTypeLabel(HoveredOption.Link.ResponseType, HoveredOption.Link.IconOverride);
 
 		// Larger center square for better text fit
 		const FVector2D SquareSize(100, 40);
@@ -197,32 +308,25 @@ int32 SDialogWheel::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeo
 			AllottedGeometry.ToPaintGeometry(FVector2f(SquareSize), FSlateLayoutTransform(FVector2f(Center - SquareSize / 2))),
 			FAppStyle::Get().GetBrush("WhiteBrush"),
 			ESlateDrawEffect::None,
-			ToneColor
+			HoveredOption.ToneColor
 		);
 
-		// Draw tone label centered in the square
-		// Measure text to center it properly
-		const FSlateFontInfo LabelFont = FCoreStyle::GetDefaultFontStyle("Bold", 10);
-		const TSharedRef<FSlateFontMeasure> FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
-		const FVector2D TextSize = FontMeasure->Measure(ToneLabel, LabelFont);
-
-		// Center text within the square
-		const FVector2D TextPosition = Center - TextSize / 2;
+		// Draw tone label centered in the square (measured when the node was set)
+		const FVector2D TextPosition = Center - HoveredOption.ToneLabelSize / 2;
 
 		FSlateDrawElement::MakeText(
 			OutDrawElements,
 			LayerId + 3,
 			AllottedGeometry.ToPaintGeometry(FSlateLayoutTransform(FVector2f(TextPosition))),
-			ToneLabel,
-			LabelFont,
+			HoveredOption.ToneLabel,
+			FCoreStyle::GetDefaultFontStyle("Bold", 10),
 			ESlateDrawEffect::None,
 			FLinearColor::Black
 		);
 	}
-	else if (CurrentNode)
+	else if (!CenterText.IsEmpty())
 	{
 		// Default center display showing node index
-		FString CenterText = FString::Printf(TEXT("Node %d"), CurrentNode->NodeIndex);
 		FSlateDrawElement::MakeText(
 			OutDrawElements,
 			LayerId + 2,
@@ -244,8 +348,7 @@ void SDialogWheel::OnMouseEnter(const FGeometry& MyGeometry, const FPointerEvent
 
 void SDialogWheel::OnMouseLeave(const FPointerEvent& MouseEvent)
 {
-	HoveredOptionIndex = -1;
-	Invalidate(EInvalidateWidgetReason::Paint);
+	SetHoveredOption(INDEX_NONE);
 	SCompoundWidget::OnMouseLeave(MouseEvent);
 }
 
@@ -272,20 +375,7 @@ FCursorReply SDialogWheel::OnCursorQuery(const FGeometry& MyGeometry, const FPoi
 FReply SDialogWheel::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
 	FVector2D LocalPosition = MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition());
-	int32 NewHoveredIndex = FindOptionAtPosition(MyGeometry, LocalPosition);
-
-	if (NewHoveredIndex != HoveredOptionIndex)
-	{
-		HoveredOptionIndex = NewHoveredIndex;
-
-		if (HoveredOptionIndex >= 0)
-		{
-			OnOptionHovered(HoveredOptionIndex);
-		}
-
-		// Force widget to repaint on hover change
-		const_cast<SDialogWheel*>(this)->Invalidate(EInvalidateWidgetReason::Paint);
-	}
+	SetHoveredOption(FindOptionAtPosition(MyGeometry, LocalPosition));
 
 	return FReply::Handled();
 }
@@ -618,19 +708,10 @@ int32 SDialogWheel::FindOptionAtPosition(const FGeometry& Geometry, const FVecto
 	FVector2D Center = Geometry.GetLocalSize() / 2;
 	FVector2D RelativePos = LocalPosition - Center;
 
-	// Use larger hit area for text-based options (120x40 text box)
-	const float HitAreaWidth = 120.0f;
-	const float HitAreaHeight = 40.0f;
-
+	// Check if mouse is within an option's cached rectangular bounds
 	for (int32 i = 0; i < Options.Num(); ++i)
 	{
-		FVector2D OptionPos = Options[i].Position;
-		FVector2D OptionTopLeft = OptionPos - FVector2D(HitAreaWidth / 2, HitAreaHeight / 2);
-		FVector2D OptionBottomRight = OptionPos + FVector2D(HitAreaWidth / 2, HitAreaHeight / 2);
-
-		// Check if mouse is within rectangular bounds
-		if (RelativePos.X >= OptionTopLeft.X && RelativePos.X <= OptionBottomRight.X &&
-			RelativePos.Y >= OptionTopLeft.Y && RelativePos.Y <= OptionBottomRight.Y)
+		if (Options[i].HitRect.ContainsPoint(RelativePos))
 		{
 			return i;
 		}
@@ -644,42 +725,7 @@ void SDialogWheel::DrawOption(const FDialogWheelOption& Option, const FGeometry&
 {
 	FVector2D Center = AllottedGeometry.GetLocalSize() / 2;
 	FVector2D OptionCenter = Center + Option.Position;
-
-	// Determine if hovered
-	bool bIsHovered = (Options.IndexOfByPredicate([&](const FDialogWheelOption& Opt)
-	{
-		return &Opt == &Option;
-	}) == HoveredOptionIndex);
-
-	// Get actual dialog text from TLK string or use preview text
-	FString DialogText;
-	if (DataManager.IsValid())
-	{
-		DialogText = DataManager->GetTLKString(Option.Link.TLKStringID);
-		if (DialogText.IsEmpty())
-		{
-			DialogText = Option.Link.PreviewText;
-		}
-		if (DialogText.IsEmpty())
-		{
-			DialogText = FString::Printf(TEXT("[TLK %d]"), Option.Link.TLKStringID);
-		}
-	}
-	else
-	{
-		DialogText = FString::Printf(TEXT("[TLK %d]"), Option.Link.TLKStringID);
-	}
-
-	// Truncate long text for display
-	if (DialogText.Len() > 40)
-	{
-		DialogText = DialogText.Left(37) + TEXT("...");
-	}
-
-	// Measure text to center it properly
-	const FSlateFontInfo TextFont = FCoreStyle::GetDefaultFontStyle("Regular", 9);
-	const TSharedRef<FSlateFontMeasure> FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
-	const FVector2D TextSize = FontMeasure->Measure(DialogText, TextFont);
+	const bool bIsHovered = Option.bIsHovered;
 
 	// Draw background for hovered option for better contrast
 	if (bIsHovered)
@@ -703,15 +749,15 @@ void SDialogWheel::DrawOption(const FDialogWheelOption& Option, const FGeometry&
 	FLinearColor TextColor = bIsHovered ? FLinearColor(1.0f, 1.0f, 1.0f) : FLinearColor(0.7f, 0.7f, 0.7f);
 
 	// Center text at option position
-	const FVector2D TextPosition = OptionCenter - TextSize / 2;
+	const FVector2D TextPosition = OptionCenter - Option.TextSize / 2;
 
 	// Draw dialog text centered
 	FSlateDrawElement::MakeText(
 		OutDrawElements,
 		LayerId + 1,
 		AllottedGeometry.ToPaintGeometry(FSlateLayoutTransform(FVector2f(TextPosition))),
-		DialogText,
-		TextFont,
+		Option.DisplayText,
+		FCoreStyle::GetDefaultFontStyle("Regular", 9),
 		ESlateDrawEffect::None,
 		TextColor
 	);
@@ -726,7 +772,7 @@ void SDialogWheel::OnOptionClicked(int32 OptionIndex)
 
 	const FDialogWheelOption& Option = Options[OptionIndex];
 
-	UE_LOG(LogTemp, Log, TEXT("Dialog option clicked: %s -> Node %d"),
+	UE_LOG(LogDA2Dialog, Log, TEXT("Dialog option clicked: %s -> Node %d"),
 	       *GetResponseTypeLabel(Option.Link.ResponseType), Option.Link.TargetNodeIndex);
 
 	// Execute action if current node has one
@@ -751,7 +797,7 @@ void SDialogWheel::OnOptionHovered(int32 OptionIndex)
 
 	const FDialogWheelOption& Option = Options[OptionIndex];
 
-	UE_LOG(LogTemp, Verbose, TEXT("Dialog option hovered: %s"),
+	UE_LOG(LogDA2Dialog, Verbose, TEXT("Dialog option hovered: %s"),
 	       *GetResponseTypeLabel(Option.Link.ResponseType));
 
 	// TODO: Play audio preview here
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Sorted set of the numeric file IDs (<id>.wav) present in the audio directory
+ * Immutable once built, so one snapshot can be read from any thread; changes produce a new index
+ */
+class FAudioFileIndex
+{
+public:
+	// Scan the directory for <id>.wav files (touches the filesystem, call from a worker thread)
+	static TSharedPtr<const FAudioFileIndex> Build(const FString& AudioDirectory);
+
+	// Copy of this index with files added and removed
+	TSharedPtr<const FAudioFileIndex> WithChanges(TConstArrayView<uint32> Added, TConstArrayView<uint32> Removed) const;
+
+	// Is there a file for this ID
+	bool Contains(uint32 FileID) const;
+
+	// Number of files
+	int32 Num() const { return FileIDs.Num(); }
+
+	// All file IDs, ascending
+	TConstArrayView<uint32> GetFileIDs() const { return FileIDs; }
+
+private:
+	// File IDs, ascending and unique
+	TArray<uint32> FileIDs;
+};
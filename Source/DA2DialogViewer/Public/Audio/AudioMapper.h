@@ -16,28 +16,33 @@ enum class EPlayerGender : uint8
 
 /**
  * Dialog audio mapping entry from dialog.csv
+ * Plain data (16 bytes), so the sorted entry array can be copied or mapped as one block
  */
 struct FDialogAudioInfo
 {
 	// Dialog ID (TLK string reference)
-	int32 DialogID;
+	int32 DialogID = -1;
 
-	// Audio file ID for male player
-	FString MaleAudioFile;
+	// Audio file IDs (<id>.wav) for male and female player
+	uint32 MaleAudioFileID = 0;
+	uint32 FemaleAudioFileID = 0;
 
-	// Audio file ID for female player
-	FString FemaleAudioFile;
+	// Index into the mapper's interned sound bank names
+	uint16 SoundBankIndex = 0;
 
-	// Sound bank name
-	FString SoundBank;
+	// Which of the file IDs are set
+	uint8 bHasMaleAudio : 1;
+	uint8 bHasFemaleAudio : 1;
 
 	FDialogAudioInfo()
-		: DialogID(-1)
+		: bHasMaleAudio(false)
+		, bHasFemaleAudio(false)
 	{}
 };
 
 /**
- * Maps TLK dialog IDs to audio file names
+ * Maps TLK dialog IDs to audio file IDs
+ * Entries live in one array sorted by dialog ID and are found by binary search, lookups never allocate
  */
 class FAudioMapper
 {
@@ -48,19 +53,34 @@ public:
 	// Load dialog.csv mapping
 	bool LoadDialogCSV(const FString& CSVPath);
 
-	// Get audio file for dialog ID and gender
-	FString GetAudioFile(int32 DialogID, EPlayerGender Gender) const;
+	// Get audio file ID for dialog ID and gender, false if there is no mapping
+	bool FindAudioFileID(int32 DialogID, EPlayerGender Gender, uint32& OutAudioFileID) const;
 
-	// Get full path to audio file
+	// Get full path to audio file (empty if there is no mapping)
 	FString GetAudioFilePath(int32 DialogID, EPlayerGender Gender, const FString& AudioDirectory) const;
 
+	// Sound bank the dialog ID's audio is in (empty if there is no mapping)
+	FStringView GetSoundBank(int32 DialogID) const;
+
 	// Check if dialog ID has audio mapping
-	bool HasAudioMapping(int32 DialogID) const;
+	bool HasAudioMapping(int32 DialogID) const { return FindEntry(DialogID) != nullptr; }
+
+	// Number of mapped dialog IDs
+	int32 Num() const { return Entries.Num(); }
+
+	// Heap memory held by the mapping
+	SIZE_T GetAllocatedSize() const;
 
 	// Clear all mappings
 	void Clear();
 
 private:
-	// Map from DialogID to audio info
-	TMap<int32, FDialogAudioInfo> AudioMap;
+	// Binary search for a dialog ID's entry
+	const FDialogAudioInfo* FindEntry(int32 DialogID) const;
+
+	// Mappings, ascending by dialog ID
+	TArray<FDialogAudioInfo> Entries;
+
+	// Distinct sound bank names, referenced by FDialogAudioInfo::SoundBankIndex
+	TArray<FString> SoundBanks;
 };
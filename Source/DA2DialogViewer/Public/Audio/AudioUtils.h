@@ -15,21 +15,33 @@ public:
 	 * Compute FNV-1a 32-bit hash of a string
 	 * Used by Dragon Age 2 to generate audio file IDs from string identifiers
 	 *
+	 * Lowercases character by character, nothing is allocated
+	 *
 	 * @param String Input string to hash
 	 * @return 32-bit FNV hash value
 	 */
-	static uint32 ComputeFNV32Hash(const FString& String);
+	static uint32 ComputeFNV32Hash(FStringView String);
 
 	/**
 	 * Compute audio file ID from TLK string ID with gender suffix
-	 * Converts TLK ID to string, appends gender suffix (_M or _F), then computes FNV32 hash
+	 * Hashes "<TLKID>_m" or "<TLKID>_f", with the digits written straight into a stack buffer (no string is built)
 	 *
 	 * @param TLKID The TLK string ID
-	 * @param bIsMale True for male (_M suffix), false for female (_F suffix)
+	 * @param bIsMale True for male (_m suffix), false for female (_f suffix)
 	 * @return FNV32 hash that matches audio file ID
 	 */
 	static uint32 ComputeAudioFileID(int32 TLKID, bool bIsMale);
 
+	/**
+	 * Compute audio file IDs for many TLK IDs at once, four per SIMD register
+	 * Same results as ComputeAudioFileID, for building whole-corpus ID tables
+	 *
+	 * @param TLKIDs TLK string IDs
+	 * @param bIsMale Gender suffix for every ID
+	 * @param OutAudioFileIDs Receives one file ID per TLK ID (must be at least as long as TLKIDs)
+	 */
+	static void ComputeAudioFileIDs(TConstArrayView<int32> TLKIDs, bool bIsMale, TArrayView<uint32> OutAudioFileIDs);
+
 	/**
 	 * Check if an audio file exists at the given path
 	 *
@@ -47,4 +59,22 @@ public:
 	 * @return Full path like "Data/all_conv_wav/267111449.wav"
 	 */
 	static FString BuildAudioFilePath(const FString& AudioDirectory, uint32 AudioFileID);
+
+	/**
+	 * Parse the numeric ID from an audio file name
+	 *
+	 * @param FileName File name like "267111449.wav" (no directory)
+	 * @param OutAudioFileID Parsed ID
+	 * @return False if the name is not <uint32>.wav
+	 */
+	static bool ParseAudioFileID(FStringView FileName, uint32& OutAudioFileID);
+
+	/**
+	 * Parse a bare audio file ID (the file name without ".wav")
+	 *
+	 * @param Digits 1-10 decimal digits, no sign or spaces
+	 * @param OutAudioFileID Parsed ID
+	 * @return False if the text is not a uint32
+	 */
+	static bool ParseAudioFileNumber(FStringView Digits, uint32& OutAudioFileID);
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "Audio/DialogWavReader.h"
+
+/**
+ * A whole line decoded to interleaved float PCM
+ */
+struct FDialogDecodedAudio
+{
+	// Source format (DataOffset/DataSize describe the file the samples came from)
+	FDialogWavFormat Format;
+
+	// Interleaved samples, Format.NumChannels per frame
+	TArray<float> Samples;
+
+	// Frames decoded
+	int64 GetNumFrames() const { return Format.NumChannels > 0 ? Samples.Num() / Format.NumChannels : 0; }
+
+	// Bytes counted against the cache budget
+	SIZE_T GetAllocatedSize() const { return sizeof(FDialogDecodedAudio) + Samples.GetAllocatedSize(); }
+};
+
+/**
+ * Byte-bounded LRU of decoded lines, keyed by file path
+ * Lookups never touch the disk; the owner calls Remove when the audio directory watcher reports a file changed
+ * Prefetches are decoded one at a time on a pool thread, newest request first, so clicking a likely next line plays from memory
+ */
+class FDialogAudioCache : public TSharedFromThis<FDialogAudioCache>
+{
+public:
+	explicit FDialogAudioCache(SIZE_T InMaxBytes = DefaultMaxBytes);
+	~FDialogAudioCache();
+
+	// Decoded line for a file, nullptr if it isn't cached (marks it most recently used)
+	TSharedPtr<const FDialogDecodedAudio> Find(const FString& FilePath);
+
+	// Cached line, or decode and cache it on the calling thread (nullptr if missing or unsupported)
+	TSharedPtr<const FDialogDecodedAudio> FindOrDecode(const FString& FilePath);
+
+	// Queue files to be decoded in the background, ahead of anything queued earlier
+	// Files already cached, queued or too large for the budget are skipped
+	void Prefetch(TConstArrayView<FString> FilePaths);
+
+	// Drop the cached line and pending prefetch of a file that was modified or removed
+	// A prefetch already decoding it is discarded when it finishes
+	void Remove(const FString& FilePath);
+
+	// Drop every cached line and pending prefetch (a prefetch already decoding is discarded too)
+	void Empty();
+
+	// Decode a whole file on the calling thread (nullptr if missing or unsupported)
+	// Files that would decode to more than MaxDecodedBytes are rejected from their header, before any sample is read
+	static TSharedPtr<const FDialogDecodedAudio> DecodeFile(const FString& FilePath, SIZE_T MaxDecodedBytes = TNumericLimits<SIZE_T>::Max());
+
+	// Bytes of decoded audio held
+	SIZE_T GetUsedBytes() const;
+
+	// 64 MB: about six minutes of 44.1 kHz mono
+	static constexpr SIZE_T DefaultMaxBytes = 64 * 1024 * 1024;
+
+private:
+	// Add a decoded line, evicting least recently used lines until it fits
+	void Add(const FString& FilePath, TSharedPtr<const FDialogDecodedAudio> Decoded);
+	void AddLocked(const FString& FilePath, TSharedPtr<const FDialogDecodedAudio> Decoded);
+
+	// Lines that would take most of the budget stream from disk instead
+	SIZE_T GetMaxLineBytes() const { return MaxBytes / 4; }
+
+	// Pool thread loop: decode queued files until the queue is empty
+	void ProcessPrefetchQueue();
+
+	// Budget for decoded samples
+	SIZE_T MaxBytes;
+
+	// Decoded lines, most recently used first; the entry count bound is only a backstop, bytes are what evicts
+	TLruCache<FString, TSharedPtr<const FDialogDecodedAudio>> Entries;
+	SIZE_T UsedBytes = 0;
+
+	// Files waiting to be decoded, most recent request first
+	TArray<FString> PendingPrefetches;
+
+	// File being decoded right now (so a repeat request doesn't queue it again), and whether it changed on disk meanwhile
+	FString InFlightPrefetch;
+	bool bInFlightPrefetchStale = false;
+
+	// A pool task is draining the queue
+	bool bPrefetchRunning = false;
+
+	// Guards everything above
+	mutable FCriticalSection Lock;
+
+	// Requests beyond this are dropped, oldest first (they belong to lines the user has moved on from)
+	static constexpr int32 MaxPendingPrefetches = 32;
+};
@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+class FDialogDataManager;
+
+/**
+ * Result of resolving the audio of every line used by every conversation
+ */
+struct FDialogAudioCoverageReport
+{
+	// Line with no audio file for at least one player gender
+	struct FMissingLine
+	{
+		int32 TLKID = 0;
+		bool bMissing[2] = {false, false}; // Indexed by EPlayerGender
+		int32 NumConversations = 0;
+		FString FirstConversation; // Relative to the conversation directory
+		int32 FirstNodeIndex = INDEX_NONE;
+	};
+
+	// File more than one line resolves to
+	struct FSharedFile
+	{
+		uint32 FileID = 0;
+		TArray<int32> TLKIDs;
+	};
+
+	// Loudness of a resolved file, from its waveform summary
+	struct FLoudness
+	{
+		uint32 FileID = 0;
+		float Duration = 0.0f;
+		float RMS = 0.0f;
+		float Peak = 0.0f;
+		uint32 NumClippedSamples = 0;
+	};
+
+	int32 NumConversations = 0;
+	int32 NumFailedConversations = 0;
+
+	// Distinct lines with text, and lines skipped because their TLK string is missing or empty
+	int32 NumLines = 0;
+	int32 NumLinesWithoutText = 0;
+
+	// Lines resolved through dialog.csv, and through the FNV hash of "<TLKID>_<m|f>", per gender
+	int32 NumMapped[2] = {0, 0};
+	int32 NumHashed[2] = {0, 0};
+
+	// Files in the audio directory, and those no line resolves to
+	int32 NumFiles = 0;
+	TArray<uint32> OrphanedFileIDs;
+
+	TArray<FMissingLine> MissingLines;
+	TArray<FSharedFile> SharedFiles;
+
+	// Resolved files that have a waveform summary (others are skipped, nothing is decoded), and how many of them clip
+	TArray<FLoudness> Loudness;
+	int32 NumClippedFiles = 0;
+
+	double Seconds = 0.0;
+};
+
+/**
+ * Corpus-wide audio audit: resolves every (TLK ID, gender) used by any conversation the same way playback does,
+ * then reports lines without audio, files shared by several lines and files no line uses
+ */
+class FDialogAudioCoverage
+{
+public:
+	/**
+	 * Parse every conversation and resolve its lines against the audio file index, in parallel across conversations
+	 * Returns false if the data isn't loaded, the audio directory scan hasn't finished yet or the run was cancelled
+	 */
+	static bool Run(const FDialogDataManager& DataManager, FDialogAudioCoverageReport& OutReport, const std::atomic<bool>* bCancelled = nullptr);
+
+	/** Write Missing.csv, Shared.csv, Orphaned.csv and Loudness.csv into a directory */
+	static bool WriteCSV(const FDialogAudioCoverageReport& Report, const FString& Directory);
+
+	/** Log totals */
+	static void LogSummary(const FDialogAudioCoverageReport& Report);
+
+	/** Run, log and write the CSVs to the default directory; parses the whole corpus, so call it from a pool thread */
+	static bool RunReport(const FDialogDataManager& DataManager, const std::atomic<bool>* bCancelled = nullptr);
+
+	/** Saved/DA2DialogViewer/AudioCoverage */
+	static FString GetDefaultReportDirectory();
+};
@@ -5,8 +5,11 @@
 #include "CoreMinimal.h"
 #include "Audio/AudioMapper.h"
 #include "Audio/DialogAudioPlayer.h"
+#include "Containers/Ticker.h"
 
 class FDialogDataManager;
+class FDialogAudioCache;
+struct FDialogAutoPlayDecode;
 
 /**
  * Dialog audio manager
@@ -20,7 +23,7 @@ public:
 	~FDialogAudioManager();
 
 	/**
-	 * Initialize with data manager reference
+	 * Initialize with data manager reference and open the audio output
 	 * @param InDataManager Dialog data manager for gender selection
 	 */
 	void Initialize(TSharedPtr<FDialogDataManager> InDataManager);
@@ -35,6 +38,32 @@ public:
 	 */
 	bool PlayDialogAudio(int32 SpokenTLKID, int32 ParaphraseTLKID);
 
+	/**
+	 * Decode the audio for lines the user is likely to play next into the cache, in the background
+	 * Lines without a file are skipped; earlier lines in the list are decoded first
+	 * @param TLKIDs Spoken line TLK IDs
+	 */
+	void PrefetchDialogAudio(TConstArrayView<int32> TLKIDs);
+
+	/**
+	 * Play a sequence of lines hands-free, each starting on the sample after the previous one ends
+	 * The next line is decoded on a worker thread while the current one plays; lines without audio are skipped
+	 * Manual playback or StopAudio ends the sequence
+	 * @param TLKIDs Spoken line TLK IDs in playback order
+	 * @return True if at least one line has audio
+	 */
+	bool StartAutoPlay(TConstArrayView<int32> TLKIDs);
+
+	/**
+	 * End auto-play (the line playing now is stopped too)
+	 */
+	void StopAutoPlay();
+
+	/**
+	 * Is an auto-play sequence running
+	 */
+	bool IsAutoPlaying() const { return AutoPlayTickerHandle.IsValid(); }
+
 	/**
 	 * Stop current audio playback
 	 */
@@ -59,9 +88,34 @@ private:
 	 */
 	bool TryPlayAudio(int32 TLKID, bool bIsMale);
 
+	/** Auto-play step: hand decoded lines to the player and start decoding the one after */
+	bool TickAutoPlay(float DeltaTime);
+
+	/** Stop the auto-play ticker and forget the sequence, leaving playback alone */
+	void ResetAutoPlay();
+
+	/** Drop decoded copies of files the data manager saw change on disk */
+	void OnAudioFilesChanged(TConstArrayView<uint32> FileIDs);
+
 	/** Data manager reference for gender selection */
 	TSharedPtr<FDialogDataManager> DataManager;
 
+	/** Subscription to the data manager's audio file changes */
+	FDelegateHandle AudioFilesChangedHandle;
+
 	/** Audio player instance */
 	TUniquePtr<FDialogAudioPlayer> AudioPlayer;
+
+	/** Decoded lines, recently played and prefetched */
+	TSharedPtr<FDialogAudioCache> AudioCache;
+
+	/** Auto-play sequence (resolved file paths) and the next one to decode */
+	TArray<FString> AutoPlayFiles;
+	int32 NextAutoPlayFile = 0;
+
+	/** Line being decoded for auto-play; with the playing line this makes the two buffers */
+	TSharedPtr<FDialogAutoPlayDecode> PendingDecode;
+
+	/** Core ticker driving auto-play (valid while it runs) */
+	FTSTicker::FDelegateHandle AutoPlayTickerHandle;
 };
\ No newline at end of file
@@ -3,11 +3,16 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Sound/SoundWave.h"
+
+class FDialogAudioOutput;
+struct FDialogAudioVoice;
+struct FDialogDecodedAudio;
 
 /**
  * Dialog audio player for WAV file playback
- * Uses GEditor->PlayPreviewSound() for editor-safe audio playback
+ * Streams PCM from the file in chunks into a small private mixer on the engine's audio mixer platform layer,
+ * so it runs wherever the editor has audio output and starts within the ~10 ms of queued device buffers (2 x 256 frames at 48 kHz) of PlayAudio
+ * Every file streams through a voice's ring, whatever its sample format; the mixer never reads from a file mapping
  */
 class FDialogAudioPlayer
 {
@@ -15,6 +20,12 @@ public:
 	FDialogAudioPlayer();
 	~FDialogAudioPlayer();
 
+	/**
+	 * Open the output device and start the streaming thread ahead of the first line, so the first click doesn't pay for it
+	 * @return True if the output is open
+	 */
+	bool Initialize();
+
 	/**
 	 * Load and play audio file
 	 * @param AudioFilePath Full path to WAV file
@@ -23,24 +34,80 @@ public:
 	bool PlayAudio(const FString& AudioFilePath);
 
 	/**
-	 * Stop current audio playback
+	 * Play a line that is already decoded in memory (no file access)
+	 * @param AudioFilePath File the samples came from (for logging)
+	 * @param Decoded Decoded samples, kept alive until the voice finishes
+	 * @return True if playback started
+	 */
+	bool PlayDecoded(const FString& AudioFilePath, TSharedPtr<const FDialogDecodedAudio> Decoded);
+
+	/**
+	 * Queue a decoded line to start on the sample after the current line ends (one line can be queued at a time)
+	 * Starts it right away if nothing is playing
+	 * @return True if the line was queued or started
+	 */
+	bool QueueDecoded(const FString& AudioFilePath, TSharedPtr<const FDialogDecodedAudio> Decoded);
+
+	/**
+	 * Is a queued line still waiting for the current one to end
+	 */
+	bool HasQueuedAudio() const { return QueuedVoice.IsValid(); }
+
+	/**
+	 * Make a queued line the current one once the mixer has started it (call regularly while queueing)
+	 */
+	void Update();
+
+	/**
+	 * Stop current audio playback (fades out over one device buffer)
 	 */
 	void StopAudio();
 
 	/**
-	 * Check if audio is currently playing
+	 * Check if audio is currently playing (false once the line has finished or was stopped)
 	 */
 	bool IsPlaying() const;
 
 	/**
-	 * Set playback volume (0.0 - 1.0)
+	 * Set playback volume (0.0 - 1.0), applies to the current line and later ones
 	 */
 	void SetVolume(float Volume);
 
+	/**
+	 * Get playback volume
+	 */
+	float GetVolume() const { return CurrentVolume; }
+
+	/**
+	 * Seconds played of the current line
+	 */
+	float GetPlaybackTime() const;
+
+	/**
+	 * Length of the current line in seconds (0 if nothing is loaded)
+	 */
+	float GetDuration() const;
+
 private:
-	/** Current volume (not used by Windows PlaySound) */
+	/** Reopen the output device if Initialize couldn't open it or the device was lost since */
+	bool EnsureOutput();
+
+	/** Hand a prepared voice to the mixer and make it the current line */
+	void StartVoice(const FString& AudioFilePath, TSharedPtr<FDialogAudioVoice> Voice);
+
+	/** Current volume */
 	float CurrentVolume;
 
 	/** Currently playing audio file path */
 	FString CurrentAudioFile;
+
+	/** Output device and mixer (opened by Initialize) */
+	TUniquePtr<FDialogAudioOutput> Output;
+
+	/** Voice of the current line */
+	TSharedPtr<FDialogAudioVoice> CurrentVoice;
+
+	/** Voice chained behind the current line, and its file */
+	TSharedPtr<FDialogAudioVoice> QueuedVoice;
+	FString QueuedAudioFile;
 };
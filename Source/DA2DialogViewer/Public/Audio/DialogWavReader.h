@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Sample format and data location of a WAV file
+ */
+struct FDialogWavFormat
+{
+	// Frames per second
+	int32 SampleRate = 0;
+
+	// Interleaved channels per frame
+	int32 NumChannels = 0;
+
+	// Bits per sample (8, 16, 24 or 32)
+	int32 BitsPerSample = 0;
+
+	// True for IEEE float samples, false for integer PCM
+	bool bFloat = false;
+
+	// Byte range of the sample data in the file
+	int64 DataOffset = 0;
+	int64 DataSize = 0;
+
+	// Bytes per frame
+	int32 GetBlockAlign() const { return NumChannels * (BitsPerSample / 8); }
+
+	// Frames in the data chunk
+	int64 GetNumFrames() const { return GetBlockAlign() > 0 ? DataSize / GetBlockAlign() : 0; }
+
+	// Length in seconds
+	float GetDuration() const { return SampleRate > 0 ? static_cast<float>(GetNumFrames()) / SampleRate : 0.0f; }
+};
+
+/**
+ * Reads a RIFF/WAVE file in chunks, converting samples to interleaved float
+ * Handles 8/16/24/32-bit integer PCM and 32-bit float, including WAVE_FORMAT_EXTENSIBLE headers
+ * The file is memory-mapped: chunks are parsed and samples converted straight from the mapped pages, with no read buffer
+ */
+class FDialogWavReader
+{
+public:
+	FDialogWavReader();
+	~FDialogWavReader();
+
+	// Open a file and parse its header, false if it is missing or not a supported WAV
+	bool Open(const FString& FilePath);
+
+	// Release the file
+	void Close();
+
+	// Is a file open
+	bool IsOpen() const { return FileData != nullptr; }
+
+	// Format of the open file
+	const FDialogWavFormat& GetFormat() const { return Format; }
+
+	// Read up to MaxFrames frames (NumChannels floats each) into OutSamples, returns the frames read (0 at the end)
+	int32 ReadFrames(float* OutSamples, int32 MaxFrames);
+
+	// Frames not read yet
+	int64 GetFramesRemaining() const { return Format.GetNumFrames() - FramesRead; }
+
+	// Raw bytes of the data chunk (Format.DataSize long), in place in the mapping; valid until Close
+	const uint8* GetSampleData() const { return FileData ? FileData + Format.DataOffset : nullptr; }
+
+	// The data chunk as interleaved floats in place, if the file stores aligned 32-bit float samples (nullptr otherwise)
+	const float* GetFloatSamples() const;
+
+private:
+	// Walk the RIFF chunks up to the data chunk, filling Format
+	bool ReadHeader();
+
+	// Mapping of the open file, or the whole file read into memory on platforms that can't map files
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedData;
+
+	// Bytes of the open file
+	const uint8* FileData = nullptr;
+	int64 FileSize = 0;
+
+	// Format of the open file
+	FDialogWavFormat Format;
+
+	// Frames returned so far
+	int64 FramesRead = 0;
+};
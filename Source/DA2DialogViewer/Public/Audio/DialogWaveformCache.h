@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+
+/**
+ * Waveform and loudness of one audio file, computed once from the decoded samples
+ * Fixed size plain data, so the cache file is a header followed by an array of these
+ */
+struct FDialogWaveformSummary
+{
+	// Buckets in the finest level of the peak pyramid; each coarser level halves the count down to one
+	static constexpr int32 NumBaseBuckets = 128;
+	static constexpr int32 NumLevels = 8;
+	static constexpr int32 PyramidSize = NumBaseBuckets * 2 - 1;
+
+	// File this describes, and its modification time when it was decoded (FDateTime ticks)
+	uint32 FileID = 0;
+	int64 Timestamp = 0;
+
+	// Length in seconds
+	float Duration = 0.0f;
+
+	// Loudness over every sample: RMS and absolute peak, both linear (1 = full scale)
+	float RMS = 0.0f;
+	float Peak = 0.0f;
+
+	// Samples at or beyond full scale (a clipped take has runs of these)
+	uint32 NumClippedSamples = 0;
+
+	// Min/max of each bucket across all channels, quantized to -127..127; level 0 first, then each coarser level
+	int8 Mins[PyramidSize] = {};
+	int8 Maxs[PyramidSize] = {};
+
+	// First bucket and bucket count of a level (0 = finest)
+	static int32 GetLevelOffset(int32 Level) { return NumBaseBuckets * 2 - ((NumBaseBuckets * 2) >> Level); }
+	static int32 GetLevelSize(int32 Level) { return NumBaseBuckets >> Level; }
+
+	// Coarsest level with at least MinBuckets buckets (the finest if none is that fine)
+	static int32 FindLevel(int32 MinBuckets);
+
+	// Full-scale clipping is audible once a take has more than a few clipped samples
+	bool IsClipped() const { return NumClippedSamples > 8; }
+};
+
+/**
+ * Waveform summaries of audio files, persisted so each WAV is decoded once per modification
+ * Summaries are loaded and computed on pool threads as conversations ask for them; rows read them without touching the disk
+ */
+class FDialogWaveformCache : public TSharedFromThis<FDialogWaveformCache>
+{
+public:
+	FDialogWaveformCache(const FString& InCachePath, const FString& InAudioDirectory);
+	~FDialogWaveformCache();
+
+	// Load summaries saved by an earlier session on a pool thread (missing or outdated files just start empty)
+	// Requests made before it finishes are summarized after it, so files loaded up to date aren't decoded again
+	void Load();
+
+	// Summary of a file, nullptr until it has been loaded or computed
+	TSharedPtr<const FDialogWaveformSummary> Find(uint32 FileID) const;
+
+	// Compute summaries for files that don't have an up to date one, in the background
+	// New summaries are appended to the cache file after each batch
+	void Request(TConstArrayView<uint32> FileIDs);
+
+	// Stop background work (a batch in progress stops between files)
+	void Cancel();
+
+	// Number of summaries held
+	int32 Num() const;
+
+	// Changes whenever summaries are added or replaced, so widgets can skip lookups while it stays the same
+	uint32 GetGeneration() const { return Generation.load(std::memory_order_acquire); }
+
+	// Saved/DA2DialogViewer/Waveforms.bin
+	static FString GetDefaultCachePath();
+
+	// Decode a file and summarize it (nullptr if it can't be read)
+	static TSharedPtr<FDialogWaveformSummary> ComputeSummary(const FString& FilePath, uint32 FileID, int64 Timestamp);
+
+	// Summarize interleaved float samples (SIMD min/max/sum of squares per bucket)
+	static void SummarizeSamples(TConstArrayView<float> Samples, int32 NumChannels, int32 SampleRate, FDialogWaveformSummary& OutSummary);
+
+private:
+	// Run ProcessQueue on a pool thread (the caller has set bProcessing)
+	void StartWorker();
+
+	// Pool thread loop: load the cache file if that hasn't happened yet, then summarize queued files until the queue is empty
+	void ProcessQueue();
+
+	// Read the cache file into Summaries
+	void LoadFromDisk();
+
+	// Append summaries computed since the last save to the cache file (rewrites it whole if it can't be appended to)
+	void Save();
+
+	// Write every summary to a fresh cache file
+	bool SaveAll() const;
+
+	// Cache file and the directory the audio files are in
+	FString CachePath;
+	FString AudioDirectory;
+
+	// Summaries by file ID, and those not yet written to the cache file
+	TMap<uint32, TSharedPtr<const FDialogWaveformSummary>> Summaries;
+	TArray<TSharedPtr<const FDialogWaveformSummary>> UnsavedSummaries;
+	mutable FRWLock SummariesLock;
+
+	// Whether the cache file has been read, and whether it has a valid header and whole records so new ones can go on the end
+	// Only touched by the queue worker
+	bool bLoaded = false;
+	bool bCanAppend = false;
+
+	// Files waiting to be summarized (QueuedFileIDs also holds the batch in progress), and whether a pool task is draining them
+	TArray<uint32> PendingFileIDs;
+	TSet<uint32> QueuedFileIDs;
+	bool bProcessing = false;
+	FCriticalSection QueueLock;
+
+	// Set to stop background work
+	std::atomic<bool> bCancelled{false};
+
+	// Bumped after each change to Summaries
+	std::atomic<uint32> Generation{0};
+};
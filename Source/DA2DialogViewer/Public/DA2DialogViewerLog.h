@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+#include <atomic>
+
+/**
+ * Compile-time verbosity ceiling for LogDA2Dialog
+ * With DA2DIALOG_VERBOSE_LOGGING=0 (default) Verbose/VeryVerbose lines are stripped from the binary,
+ * so per-node diagnostics in hot loops cost nothing. Define DA2DIALOG_VERBOSE_LOGGING=1 in the
+ * module's Build.cs to compile them back in.
+ */
+#ifndef DA2DIALOG_VERBOSE_LOGGING
+	#define DA2DIALOG_VERBOSE_LOGGING 0
+#endif
+
+#if DA2DIALOG_VERBOSE_LOGGING
+	#define DA2DIALOG_LOG_COMPILE_VERBOSITY All
+#else
+	#define DA2DIALOG_LOG_COMPILE_VERBOSITY Log
+#endif
+
+DECLARE_LOG_CATEGORY_EXTERN(LogDA2Dialog, Log, DA2DIALOG_LOG_COMPILE_VERBOSITY);
+
+/**
+ * Per-subsystem runtime switches for high-volume diagnostics (all off by default)
+ * Toggle from the console, e.g. "DA2Dialog.Log.TreeBuild 1"
+ * Set on the game thread by the console variables and read from worker threads, hence atomic (relaxed loads are enough)
+ */
+namespace DA2DialogLog
+{
+	// Per-node tree construction (party speaker resolution)
+	extern std::atomic<bool> bTreeBuild;
+
+	// Per-line speaker classification (during conversation analysis)
+	extern std::atomic<bool> bSpeaker;
+
+	// Per-file UTC owner tag scanning
+	extern std::atomic<bool> bUTCScan;
+
+	// Per-action plot state changes
+	extern std::atomic<bool> bActions;
+}
+
+/**
+ * Log to LogDA2Dialog only when the given subsystem switch is on
+ * Format arguments are not evaluated when the switch is off or the verbosity is compiled out
+ */
+#define DA2_LOG(Subsystem, Verbosity, Format, ...) \
+	do \
+	{ \
+		if (DA2DialogLog::Subsystem.load(std::memory_order_relaxed)) \
+		{ \
+			UE_LOG(LogDA2Dialog, Verbosity, Format, ##__VA_ARGS__); \
+		} \
+	} while (0)
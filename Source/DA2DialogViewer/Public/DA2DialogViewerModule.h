@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Async/Future.h"
+#include <atomic>
 
 class FDialogDataManager;
+class IConsoleObject;
 
 /**
  * Main module for DA2 Dialog Viewer plugin
@@ -45,7 +48,19 @@ private:
 	/** Create dialog viewer window */
 	void CreateDialogViewerWindow();
 
+	/** DA2Dialog.AudioCoverage console command */
+	void RunAudioCoverageReport();
+
 private:
 	/** Singleton data manager */
 	TSharedPtr<FDialogDataManager> DataManager;
+
+	/** Registered console command (unregistered on shutdown) */
+	IConsoleObject* AudioCoverageCommand = nullptr;
+
+	/** Coverage report running on the thread pool, if any */
+	TFuture<bool> AudioCoverageTask;
+
+	/** Set to stop the running coverage report */
+	std::atomic<bool> bAudioCoverageCancelled{false};
 };
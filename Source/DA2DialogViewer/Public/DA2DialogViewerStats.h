@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * Profiling hooks for the dialog viewer
+ * Cycle and memory stats show up under "stat DA2Dialog" in the editor console,
+ * scoped events show up in Unreal Insights when the DA2Dialog trace channel is enabled
+ * (e.g. -trace=cpu,DA2Dialog or "Trace.Enable DA2Dialog")
+ */
+DECLARE_STATS_GROUP(TEXT("DA2 Dialog"), STATGROUP_DA2Dialog, STATCAT_Advanced);
+
+// Data ingest
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parse Conversation"), STAT_DA2Dialog_ParseConversation, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Read CSV"), STAT_DA2Dialog_ReadCSV, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get TLK String"), STAT_DA2Dialog_GetTLKString, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Owner Tag"), STAT_DA2Dialog_FindOwnerTag, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Tree Model"), STAT_DA2Dialog_BuildTreeModel, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resolve Audio Availability"), STAT_DA2Dialog_ResolveAudioAvailability, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Decode Audio"), STAT_DA2Dialog_DecodeAudio, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Summarize Waveform"), STAT_DA2Dialog_SummarizeWaveform, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Audio Coverage"), STAT_DA2Dialog_AudioCoverage, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Search Index"), STAT_DA2Dialog_BuildSearchIndex, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Search Query"), STAT_DA2Dialog_SearchQuery, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+
+// UI
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Tree"), STAT_DA2Dialog_BuildTree, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wheel SetCurrentNode"), STAT_DA2Dialog_WheelSetCurrentNode, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wheel OnPaint"), STAT_DA2Dialog_WheelPaint, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Graph OnPaint"), STAT_DA2Dialog_GraphPaint, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Graph Layout"), STAT_DA2Dialog_GraphLayout, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+
+// Accumulators (persist across frames, reset per load)
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("UTC Files Scanned"), STAT_DA2Dialog_NumUTCFilesScanned, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Tree Items"), STAT_DA2Dialog_NumTreeItems, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+
+// Per-frame counters
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Graph Nodes Drawn"), STAT_DA2Dialog_NumGraphNodesDrawn, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Graph Links Drawn"), STAT_DA2Dialog_NumGraphLinksDrawn, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+
+// Memory
+DECLARE_MEMORY_STAT_EXTERN(TEXT("TLK Strings"), STAT_DA2Dialog_TLKStringMemory, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Conversation"), STAT_DA2Dialog_ConversationMemory, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Audio Cache"), STAT_DA2Dialog_AudioCacheMemory, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Tree Items"), STAT_DA2Dialog_TreeItemMemory, STATGROUP_DA2Dialog, DA2DIALOGVIEWER_API);
+
+// Insights trace channel for dialog viewer CPU events
+UE_TRACE_CHANNEL_EXTERN(DA2DialogChannel, DA2DIALOGVIEWER_API);
+
+// Scope a cycle stat and an Insights CPU event (on DA2DialogChannel) with the same name
+#define DA2_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, DA2DialogChannel)
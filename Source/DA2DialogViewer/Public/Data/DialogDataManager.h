@@ -7,6 +7,15 @@
 #include "Plot/PlotState.h"
 #include "Audio/AudioMapper.h"
 #include "DialogFlow/Conversation.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+
+class FAudioFileIndex;
+class FDialogWaveformCache;
+struct FFileChangeData;
+
+/** Audio files added, modified or removed on disk (an empty list means any file may have changed) */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAudioFilesChanged, TConstArrayView<uint32> /*FileIDs*/);
 
 /**
  * Central data manager for dialog system
@@ -21,9 +30,18 @@ public:
 	/** Initialize data manager - load plots.csv and dialog.csv */
 	bool Initialize(const FString& DataDirectory);
 
-	/** Load a conversation from XML file */
+	/** Load a conversation from XML file and make it current (synchronous) */
 	bool LoadConversation(const FString& ConversationPath);
 
+	/**
+	 * Parse a conversation and resolve its owner tag without touching any state
+	 * Safe to call from a worker thread, returns nullptr on failure or cancellation
+	 */
+	TSharedPtr<FConversation> ReadConversation(const FString& ConversationPath, const std::atomic<bool>* bCancelled = nullptr) const;
+
+	/** Make a conversation current and reset plot state (game thread) */
+	void SetCurrentConversation(TSharedPtr<FConversation> InConversation);
+
 	/** Get current conversation */
 	TSharedPtr<FConversation> GetCurrentConversation() const { return CurrentConversation; }
 
@@ -43,25 +61,74 @@ public:
 	/** Get audio directory */
 	FString GetAudioDirectory() const;
 
+	/** Audio file index (nullptr until the startup scan of the audio directory finishes) */
+	TSharedPtr<const FAudioFileIndex> GetAudioFileIndex() const;
+
+	/**
+	 * Resolve the audio file for a line: dialog.csv mapping first, then the FNV hash of "<TLKID>_<m|f>"
+	 * Looks files up in the audio file index (the filesystem is only hit until the startup scan finishes)
+	 * Returns an empty string if there is no file
+	 */
+	FString ResolveAudioFilePath(int32 TLKID, EPlayerGender Gender) const;
+
+	/**
+	 * Batched ResolveAudioFilePath for many lines at once, against a single snapshot of the audio file index
+	 * Sets OutHasAudio[i] if TLKIDs[i] resolves to a file, returns false (and leaves OutHasAudio empty) until the startup scan finishes
+	 * OutFileIDs, if given, receives the resolved file ID of every line that has one (0 for the rest)
+	 */
+	bool ResolveAudioAvailability(TConstArrayView<int32> TLKIDs, EPlayerGender Gender, TBitArray<>& OutHasAudio, TArray<uint32>* OutFileIDs = nullptr) const;
+
+	/** Broadcast on the game thread when the directory watcher sees audio files change, so decoded copies can be dropped */
+	FOnAudioFilesChanged& OnAudioFilesChanged() { return AudioFilesChangedEvent; }
+
+	/** Waveform and loudness summaries of audio files (nullptr before Initialize) */
+	TSharedPtr<FDialogWaveformCache> GetWaveformCache() const { return WaveformCache; }
+
+	/** Get conversation XML directory */
+	FString GetConversationDirectory() const;
+
 	/** Reset plot state to default */
 	void ResetPlotState();
 
-	/** Set player gender for audio selection */
-	void SetPlayerGender(EPlayerGender Gender) { PlayerGender = Gender; }
+	/** Set player gender for audio selection (game thread) */
+	void SetPlayerGender(EPlayerGender Gender) { PlayerGender.store(Gender, std::memory_order_relaxed); }
 
-	/** Get player gender */
-	EPlayerGender GetPlayerGender() const { return PlayerGender; }
+	/** Get player gender (work queued for other threads should capture it rather than read it later) */
+	EPlayerGender GetPlayerGender() const { return PlayerGender.load(std::memory_order_relaxed); }
 
 	/** Get TLK string by ID */
 	FString GetTLKString(int32 TLKID) const;
 
-	/** Process TLK string for rich text and special markers */
-	FString ProcessTLKString(const FString& RawString) const;
+	/** Raw TLK strings (fixed after Initialize, safe to read from worker threads) */
+	const TMap<int32, FString>& GetTLKStrings() const { return TLKStrings; }
+
+	/**
+	 * Get processed TLK text (current gender) as a view into the processed string pool
+	 * Views stay valid for the manager's lifetime (a re-Initialize retires the pool rather than freeing it)
+	 * Returns an empty view for missing, placeholder or empty strings
+	 */
+	FStringView GetTLKStringView(int32 TLKID) const;
 
-	/** Find owner tag from UTC files that reference this conversation */
-	FString FindOwnerTagForConversation(const FString& ConversationName) const;
+	/** Same, for an explicit gender (what worker threads use, with the gender captured when their work was queued) */
+	FStringView GetTLKStringView(int32 TLKID, EPlayerGender Gender) const;
+
+	/** Process TLK string for rich text and special markers (Gender picks the player name) */
+	FString ProcessTLKString(const FString& RawString, EPlayerGender Gender) const;
+
+	/** Find owner tag from UTC files that reference this conversation (stops early if cancelled) */
+	FString FindOwnerTagForConversation(const FString& ConversationName, const std::atomic<bool>* bCancelled = nullptr) const;
 
 private:
+	/** Scan the audio directory on a worker thread and publish the index when done */
+	void StartAudioFileScan();
+
+	/** Watch the audio directory so the index follows files being added or removed */
+	void RegisterAudioDirectoryWatcher();
+	void UnregisterAudioDirectoryWatcher();
+
+	/** Apply audio directory changes to the index (game thread) */
+	void OnAudioDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
 	/** Data directory path */
 	FString DataDirectory;
 
@@ -77,12 +144,46 @@ private:
 	/** Currently loaded conversation */
 	TSharedPtr<FConversation> CurrentConversation;
 
-	/** Player gender for audio selection */
-	EPlayerGender PlayerGender;
+	/** Player gender for audio selection (written by the game thread, read from anywhere) */
+	std::atomic<EPlayerGender> PlayerGender;
 
 	/** TLK string map (TLK ID -> localized text) */
 	TMap<int32, FString> TLKStrings;
 
+	/** Processed TLK strings per player gender, filled on first lookup (views handed out point into these) */
+	mutable TMap<int32, FString> ProcessedTLKStrings[2];
+
+	/** Pools replaced by a re-Initialize, kept because rows built before it may still hold views into them */
+	TArray<TMap<int32, FString>> RetiredProcessedTLKStrings;
+
+	/** Guards ProcessedTLKStrings (lookups can come from worker threads) */
+	mutable FRWLock ProcessedTLKLock;
+
+	/** Files present in the audio directory (replaced as a whole, never modified) */
+	TSharedPtr<const FAudioFileIndex> AudioFileIndex;
+
+	/** Guards the AudioFileIndex pointer (read from worker threads, swapped by the scan and the watcher) */
+	mutable FRWLock AudioFileIndexLock;
+
+	/** Waveform summaries, persisted under Saved/ */
+	TSharedPtr<FDialogWaveformCache> WaveformCache;
+
+	/** Bumped by every scan, so a slow scan cannot overwrite a newer one */
+	std::atomic<uint32> AudioFileScanSerial{0};
+
+	/** A scan is running; watcher changes seen meanwhile are kept in PendingAudioFileChanges (both guarded by AudioFileIndexLock) */
+	bool bAudioFileScanInFlight = false;
+
+	/** Latest watcher change per file ID since the running scan started (true = added), replayed onto its result */
+	TMap<uint32, bool> PendingAudioFileChanges;
+
+	/** Directory watcher registration */
+	FString WatchedAudioDirectory;
+	FDelegateHandle AudioDirectoryWatcherHandle;
+
+	/** Audio file changes reported by the watcher */
+	FOnAudioFilesChanged AudioFilesChangedEvent;
+
 	/** Is initialized */
 	bool bIsInitialized;
 };
@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+class FDialogDataManager;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * One place a matching line is shown
+ */
+struct FDialogSearchHit
+{
+	// Conversation file, relative to the conversation directory
+	FString ConversationPath;
+
+	// Node that shows the line (for link text, the node the link leads to)
+	int32 NodeIndex = INDEX_NONE;
+
+	// Matching TLK string
+	int32 TLKID = 0;
+};
+
+/**
+ * Full-text index over the dialog lines of every conversation
+ * Maps lowercase words to the TLK IDs containing them, and TLK IDs back to the conversation nodes that show them
+ * Built once on a worker thread, written to disk and memory-mapped afterwards, so a query only touches the
+ * words and posting lists it reads
+ */
+class FDialogSearchIndex
+{
+public:
+	~FDialogSearchIndex();
+
+	/**
+	 * Open the index file if it was built from the current data, otherwise rebuild it (parses every conversation)
+	 * Safe to call from a worker thread, returns nullptr on failure or cancellation
+	 */
+	static TSharedPtr<const FDialogSearchIndex> LoadOrBuild(const FString& IndexPath, const FDialogDataManager& DataManager,
+		const std::atomic<bool>* bCancelled = nullptr);
+
+	/** Where the index is kept by default (project Saved directory) */
+	static FString GetDefaultIndexPath();
+
+	/** Find lines containing every word of the query (the last word may be a prefix), at most MaxHits results */
+	void Search(FStringView Query, int32 MaxHits, TArray<FDialogSearchHit>& OutHits) const;
+
+	/** Split text into lowercase words, skipping markup tags; apostrophes do not split words */
+	static void Tokenize(FStringView Text, TArray<FString>& OutWords);
+
+	/** Number of distinct words */
+	int32 GetNumWords() const;
+
+	/** Number of distinct lines (TLK strings used by conversations) */
+	int32 GetNumLines() const;
+
+private:
+	// On-disk layout, defined in the .cpp
+	struct FFileHeader;
+	struct FWordEntry;
+	struct FLineEntry;
+	struct FRefEntry;
+	struct FConversationEntry;
+
+	FDialogSearchIndex();
+
+	// Map the file and check it was built from SourceStamp
+	bool Open(const FString& IndexPath, uint64 SourceStamp);
+
+	// Parse the conversations, tokenize their lines and write the index file
+	static bool Build(const FString& IndexPath, const FDialogDataManager& DataManager, const TArray<FString>& ConversationFiles,
+		uint64 SourceStamp, const std::atomic<bool>* bCancelled);
+
+	// Hash of the index version, TableTalk.csv and every conversation file (path, size, timestamp)
+	static uint64 ComputeSourceStamp(const FDialogDataManager& DataManager, TArray<FString>& OutConversationFiles);
+
+	// Sorted TLK IDs of lines containing Word (or any word starting with it)
+	void FindWord(const FString& Word, bool bPrefix, TArray<uint32>& OutLines) const;
+
+	// Conversation path by index in the file
+	FString GetConversationPath(uint32 ConversationIndex) const;
+
+	// Mapped index file (region is released before the file)
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// File contents when mapping is not available on this platform
+	TArray<uint8> LoadedData;
+
+	// Sections of the file
+	const FFileHeader* Header = nullptr;
+	const FWordEntry* Words = nullptr;
+	const uint32* Postings = nullptr;
+	const FLineEntry* Lines = nullptr;
+	const FRefEntry* Refs = nullptr;
+	const FConversationEntry* Conversations = nullptr;
+	const uint8* Strings = nullptr;
+};
@@ -36,6 +36,9 @@ public:
 	// Clear all data
 	void Clear();
 
+	// Heap memory owned by this conversation (for memory stats)
+	SIZE_T GetAllocatedSize() const;
+
 	// Debug: Print conversation structure
 	void DebugPrint() const;
 };
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+class FConversation;
+
+/**
+ * Spacing and effort settings for the layered graph layout
+ */
+struct FDialogGraphLayoutSettings
+{
+	// Center-to-center distance between neighbouring nodes in a layer
+	float NodeSpacing = 200.0f;
+
+	// Distance between layers
+	float LayerSpacing = 200.0f;
+
+	// Barycenter sweeps (each sweep is one pass down and one pass up)
+	int32 CrossingSweeps = 8;
+
+	// Alternating parent/child alignment passes during coordinate assignment
+	int32 AlignmentPasses = 4;
+};
+
+/**
+ * Sugiyama-style layered layout of a conversation graph
+ * Layers come from a breadth-first walk from the entry links, node order within each layer from barycenter
+ * crossing minimization, and x coordinates from alternating parent/child alignment with minimum separation
+ * Contains no Slate state, so it can be computed on a worker thread and handed to the panel when done
+ */
+class FDialogGraphLayout
+{
+public:
+	// Lay out a conversation, returns nullptr if cancelled
+	// If Previous was computed for the same graph structure, its layering and ordering are reused and only coordinates are recomputed
+	static TSharedPtr<const FDialogGraphLayout> Compute(TSharedPtr<FConversation> InConversation, const FDialogGraphLayoutSettings& Settings,
+		TSharedPtr<const FDialogGraphLayout> Previous = nullptr, const std::atomic<bool>* bCancelled = nullptr);
+
+	// Conversation this layout describes
+	TSharedPtr<FConversation> Conversation;
+
+	// Top-left node positions in graph space, parallel to the conversation's node array
+	TArray<FVector2D> NodePositions;
+
+	// Layer of every node, parallel to the conversation's node array
+	TArray<int32> NodeLayers;
+
+	// Node array indices of every layer, in display order
+	TArray<TArray<int32>> Layers;
+
+	// Hash of the link structure, used to decide whether a relayout can be incremental
+	uint32 StructureHash = 0;
+
+	// True if layering and ordering were reused from a previous layout
+	bool bWasIncremental = false;
+
+private:
+	// Adjacency by node array index, packed: node N's targets are Targets[Starts[N] .. Starts[N + 1])
+	struct FAdjacency
+	{
+		TArray<int32> Starts;
+		TArray<int32> Targets;
+
+		TConstArrayView<int32> Get(int32 Node) const { return TConstArrayView<int32>(Targets.GetData() + Starts[Node], Starts[Node + 1] - Starts[Node]); }
+	};
+
+	// Build the outgoing adjacency (by array index) and the structure hash
+	static uint32 BuildAdjacency(const FConversation& InConversation, FAdjacency& OutLinks);
+
+	// Build up/down adjacency restricted to links between neighbouring layers
+	void BuildLayerAdjacency(const FAdjacency& Links, FAdjacency& OutUp, FAdjacency& OutDown) const;
+
+	// Breadth-first layering from the entry links (unreachable nodes start their own walks at layer 0)
+	bool AssignLayers(const FAdjacency& Links, const std::atomic<bool>* bCancelled);
+
+	// Reorder every layer by the barycenter of its neighbours in the adjacent layer
+	bool MinimizeCrossings(const FAdjacency& Up, const FAdjacency& Down, int32 NumSweeps, const std::atomic<bool>* bCancelled);
+
+	// Assign x within layers (order preserved, minimum separation kept) and y by layer
+	void AssignCoordinates(const FAdjacency& Up, const FAdjacency& Down, const FDialogGraphLayoutSettings& Settings);
+};
@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform grid over axis-aligned rectangles or line segments in graph space
+ * Rebuilt whenever the graph layout changes, queried every frame for culling and on every click for hit-testing
+ * Items are identified by their index in the array the grid was built from
+ */
+class FDialogGraphSpatialGrid
+{
+public:
+	struct FSegment
+	{
+		FVector2D Start;
+		FVector2D End;
+	};
+
+	// Rebuild from item bounds, cells are at least MinCellSize wide (grown so the cell count stays proportional to the item count)
+	void Build(TConstArrayView<FBox2D> ItemBounds, double MinCellSize);
+
+	// Rebuild from line segments, each registered only in the cells it passes through rather than every cell of its bounding box,
+	// so a long diagonal link costs a band of cells instead of a rectangle covering most of the graph
+	void BuildSegments(TConstArrayView<FSegment> Segments, double MinCellSize);
+
+	// Drop every item
+	void Reset();
+
+	// Append every item whose cells overlap the area, each item once
+	void Query(const FBox2D& Area, TArray<int32>& OutItems) const;
+
+	// Items registered in the cell containing a point (candidates only, the caller tests exact bounds)
+	TConstArrayView<int32> GetCellItems(const FVector2D& Point) const;
+
+	bool IsEmpty() const { return CellItems.Num() == 0; }
+
+private:
+	// Place and size the cells to cover Bounds
+	void SetupCells(const FBox2D& Bounds, int32 NumItems, double MinCellSize);
+
+	// Fill CellStarts/CellItems; ForEachItemCell(ItemIndex, Visit) calls Visit(Cell) for every cell an item occupies
+	template <typename ForEachItemCellType>
+	void FillCells(int32 NumItems, ForEachItemCellType&& ForEachItemCell);
+
+	// Call Visit(Cell) for every cell a segment passes through, walking from its start cell to its end cell
+	template <typename VisitType>
+	void ForEachSegmentCell(const FSegment& Segment, VisitType&& Visit) const;
+
+	// Clamp an area to the grid's cell range, false if it misses the grid entirely
+	bool GetCellRange(const FBox2D& Area, FIntPoint& OutMin, FIntPoint& OutMax) const;
+
+	// Grid placement
+	FVector2D Origin = FVector2D::ZeroVector;
+	double CellSize = 1.0;
+	int32 NumCellsX = 0;
+	int32 NumCellsY = 0;
+
+	// Items per cell, packed: cell C owns CellItems[CellStarts[C] .. CellStarts[C + 1])
+	TArray<int32> CellStarts;
+	TArray<int32> CellItems;
+
+	// Per-item stamp of the last query that returned it, so items spanning several cells are reported once
+	mutable TArray<uint32> ItemQueryStamps;
+	mutable uint32 QueryStamp = 0;
+};
@@ -0,0 +1,173 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Audio/AudioMapper.h"
+#include <atomic>
+
+class FConversation;
+class FDialogDataManager;
+struct FDialogNode;
+
+/**
+ * Speaker type classification for dialog lines
+ */
+enum class ESpeakerType : uint8
+{
+	Player, // Blue - Hawke (player character)
+	Owner, // Red - Conversation owner (main NPC)
+	Henchman, // Green - Party companion
+	OtherNPC, // Magenta - Other named NPC (NOT FULLY IMPLEMENTED)
+	Reference // Gray - Reference to another node
+};
+
+/**
+ * What the speaker column shows for a dialog line
+ */
+enum class ESpeakerLabel : uint8
+{
+	Owner, // "OWNER" (owner name is displayed in the static header)
+	Player, // "PLAYER"
+	Companion, // Individual companion name (e.g. "Carver")
+	OtherNPC // "Speaker <id>"
+};
+
+/**
+ * Party member resolved from a plt_gen00pt_party condition (see ResolveCompanionFromPartyFlag)
+ */
+enum class EDialogCompanion : uint8
+{
+	None, // No party condition involved
+
+	// Individual companions (FOLLOWER_STATE_ACTIVE checks) - these are henchmen speaking
+	Carver,
+	Bethany,
+	Varric,
+	Aveline,
+	Isabela,
+	Merrill,
+	Anders,
+	Fenris,
+	Sebastian,
+	Unknown, // Party flag outside the known map
+
+	// Composite party flags - party-related conditions, NOT a companion speaking
+	PartyFemale,
+	PartyMage,
+	PartySolo
+};
+
+/**
+ * A place a node appears in the tree: the link that leads to it
+ * Only the first occurrence in a depth-first walk is expanded, every other one is shown as a reference
+ */
+struct FDialogOccurrence
+{
+	// Node whose link leads here (INDEX_NONE for entry lines)
+	int32 ParentNodeIndex = INDEX_NONE;
+
+	// Link index within the parent (entry link index for entry lines)
+	int32 LinkIndex = INDEX_NONE;
+
+	// Speaker classification, resolved once during analysis so rows never have to work it out
+	bool bIsNPCTurn = true; // Flip-flop state: entries start with NPC, children flip from their parent
+	bool bHasSpokenText = false; // Spoken line has real text (not a placeholder or missing)
+	bool bIsAmbient = false; // Spoken text but no links
+	ESpeakerType SpeakerType = ESpeakerType::Owner;
+	ESpeakerLabel SpeakerLabel = ESpeakerLabel::Owner;
+	EDialogCompanion Companion = EDialogCompanion::None;
+};
+
+/**
+ * Immutable structural analysis of a conversation that the tree view is built from
+ * Contains no Slate state, so it can be built on a worker thread and handed to the UI when done
+ */
+class FDialogTreeModel
+{
+public:
+	// Analyze a conversation, returns nullptr if cancelled
+	// The data manager is only used to tell which spoken lines have text (without one, none do), with the text for Gender;
+	// gender only changes the player's name, never whether a line has text, so the model stays valid across a gender toggle
+	static TSharedPtr<const FDialogTreeModel> Build(TSharedPtr<FConversation> InConversation, TSharedPtr<const FDialogDataManager> InDataManager = nullptr,
+		EPlayerGender Gender = EPlayerGender::Male, const std::atomic<bool>* bCancelled = nullptr);
+
+	// Find where a node first appears (nullptr if unreachable)
+	const FDialogOccurrence* FindFirstOccurrence(int32 NodeIndex) const { return FirstOccurrences.Find(NodeIndex); }
+
+	// Find every place a node appears, in tree order (first occurrence first)
+	void FindAllOccurrences(int32 NodeIndex, TArray<FDialogOccurrence>& OutOccurrences) const { AllOccurrences.MultiFind(NodeIndex, OutOccurrences, true); }
+
+	// Number of places a node appears
+	int32 GetNumOccurrences(int32 NodeIndex) const { return AllOccurrences.Num(NodeIndex); }
+
+	// Find one specific occurrence of a node (nullptr if the node is never reached through that link)
+	const FDialogOccurrence* FindOccurrence(int32 NodeIndex, int32 ParentNodeIndex, int32 LinkIndex) const;
+
+	// Audio availability, resolved once against the audio file index when the model is built (no I/O)
+	// Only meaningful when bAudioAvailabilityKnown, callers fall back to "has spoken text" otherwise
+	bool HasAudio(int32 TLKID, EPlayerGender Gender) const;
+	bool HasNodeAudio(int32 NodeIndex, EPlayerGender Gender) const;
+	bool HasLinkAudio(int32 NodeIndex, int32 LinkIndex, EPlayerGender Gender) const;
+
+	// File a line's audio resolved to, false if it has none (or availability isn't known)
+	bool FindAudioFileID(int32 TLKID, EPlayerGender Gender, uint32& OutFileID) const;
+
+	// Every distinct resolved file, both genders (for precomputing per-file data such as waveforms)
+	void GetAudioFileIDs(TArray<uint32>& OutFileIDs) const;
+
+	// Resolve companion from party flag
+	static EDialogCompanion ResolveCompanionFromPartyFlag(int32 FlagIndex);
+
+	// Display name for a resolved companion ("Carver", "[Party: Solo Player]", ...)
+	static const TCHAR* GetCompanionName(EDialogCompanion Companion);
+
+	// True for individual companions, false for no companion and for composite party flags
+	static bool IsCompanionSpeaker(EDialogCompanion Companion) { return Companion != EDialogCompanion::None && Companion < EDialogCompanion::PartyFemale; }
+
+	// Hardcoded player speaker IDs (identified via flip-flop analysis of all conversations)
+	// These speaker IDs are used >95% of the time for player lines
+	// Derived from analyzing 704 DA2 conversations with flip-flop logic
+	static const TSet<int32> KnownPlayerSpeakerIDs;
+
+	// Conversation this model describes
+	TSharedPtr<FConversation> Conversation;
+
+	// First occurrence of every reachable node, keyed by node index
+	TMap<int32, FDialogOccurrence> FirstOccurrences;
+
+	// Every occurrence (first and references) of every reachable node, keyed by node index
+	TMultiMap<int32, FDialogOccurrence> AllOccurrences;
+
+	// Detected owner speaker ID (heuristic: most frequent NPC speaker, -1 if none)
+	int32 OwnerSpeakerID = -1;
+
+	// Upper bound on tree rows: one per entry link plus one per link of every expandable (first occurrence) node
+	int32 MaxTreeItems = 0;
+
+	// False if the audio file index wasn't ready when the model was built (availability is then unknown)
+	bool bAudioAvailabilityKnown = false;
+
+	// Distinct TLK IDs of every reachable node's spoken line and link paraphrase, ascending
+	TArray<int32> AudioTLKIDs;
+
+	// Per gender (indexed by EPlayerGender), parallel to AudioTLKIDs: the line resolves to an audio file, and which one
+	TBitArray<> AudioAvailable[2];
+	TArray<uint32> AudioFileIDs[2];
+
+private:
+	// Record occurrences depth-first (pre-order, link order), matching the order rows appear in the tree
+	// Uses an explicit stack so arbitrarily deep conversations can't overflow the thread's stack
+	bool AnalyzeOccurrences(int32 EntryNodeIndex, int32 EntryIndex, const FDialogDataManager* InDataManager, EPlayerGender Gender,
+		const std::atomic<bool>* bCancelled);
+
+	// Collect the reachable lines and resolve them for both genders in one batched lookup per gender
+	void ResolveAudioAvailability(const FDialogDataManager& InDataManager);
+
+	// Work out who speaks one occurrence (party resolution, speaker type and label)
+	static void ClassifyOccurrence(FDialogOccurrence& Occurrence, const FDialogNode& Node, const FDialogNode* ParentNode,
+		bool bIsReference, bool bIsPlaceholder);
+
+	// Detect conversation owner using heuristic: most frequent NPC speaker (excluding player IDs)
+	static int32 DetectConversationOwner(const FConversation& InConversation);
+};
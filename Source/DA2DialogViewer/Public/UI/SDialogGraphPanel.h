@@ -4,15 +4,71 @@
 
 #include "CoreMinimal.h"
 #include "Widgets/SCompoundWidget.h"
+#include "Rendering/RenderingCommon.h"
+#include "UI/DialogGraphSpatialGrid.h"
+#include "UI/DialogGraphLayout.h"
 
 class FConversation;
+struct FGraphLayoutRequest;
 struct FDialogNode;
 struct FDialogLink;
 class SDialogWheel;
 
+/**
+ * One link drawn in the graph, by node array index
+ */
+struct FDialogGraphEdge
+{
+	int32 FromNode = INDEX_NONE;
+	int32 ToNode = INDEX_NONE;
+	int32 LinkIndex = INDEX_NONE;
+
+	// Color bucket the link is batched into
+	int32 Bucket = INDEX_NONE;
+};
+
+/**
+ * Visible links of one color, as screen-space quads submitted in a single draw element
+ */
+struct FDialogGraphEdgeBatch
+{
+	FColor Color;
+	TArray<FSlateVertex> Vertices;
+	TArray<SlateIndex> Indices;
+};
+
+/**
+ * View state a set of edge batches was built for; the batches are reused while it is unchanged
+ */
+struct FDialogGraphEdgeBatchKey
+{
+	FSlateRenderTransform RenderTransform;
+	FVector2D LocalSize = FVector2D::ZeroVector;
+	FVector2D PanOffset = FVector2D::ZeroVector;
+	float ZoomAmount = 0.0f;
+	const FDialogNode* SelectedNode = nullptr;
+
+	bool operator==(const FDialogGraphEdgeBatchKey& Other) const
+	{
+		return RenderTransform == Other.RenderTransform && LocalSize == Other.LocalSize && PanOffset == Other.PanOffset
+			&& ZoomAmount == Other.ZoomAmount && SelectedNode == Other.SelectedNode;
+	}
+};
+
+/**
+ * Level of detail a graph node is drawn at, picked from its size on screen
+ */
+enum class EGraphNodeLOD : uint8
+{
+	Point, // Colored dot, at most one per few pixels
+	Box, // Filled box, no outline or text
+	Detail // Box, outline and label
+};
+
 /**
  * Dialog graph visualization panel
  * Displays conversation flow as node graph
+ * Right-drag pans, the mouse wheel zooms around the cursor; only nodes and links in view are drawn
  */
 class SDialogGraphPanel : public SCompoundWidget
 {
@@ -23,9 +79,14 @@ public:
 
 	void Construct(const FArguments& InArgs);
 
-	// Load conversation into graph
+	~SDialogGraphPanel();
+
+	// Load conversation into graph (laid out on a worker thread, drawn when done)
 	void LoadConversation(TSharedPtr<FConversation> InConversation);
 
+	// Change layout spacing, reusing the current layering and ordering
+	void SetLayoutSpacing(float NodeSpacing, float LayerSpacing);
+
 	// Clear graph
 	void Clear();
 
@@ -44,26 +105,52 @@ private:
 		const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements,
 		int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
 
-	// Handle mouse button down
+	// Handle mouse button down (left selects, right starts panning)
 	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
 
-	// Calculate node positions
+	// Pan/zoom input
+	virtual FReply OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FCursorReply OnCursorQuery(const FGeometry& MyGeometry, const FPointerEvent& CursorEvent) const override;
+
+	// Start laying out the current conversation on a worker thread, replacing any layout in progress
 	void CalculateNodePositions();
 
+	// Swap in a finished layout (game thread), dropped if a newer one was requested since
+	void OnLayoutComputed(TSharedPtr<FGraphLayoutRequest> Request, TSharedPtr<const FDialogGraphLayout> Layout);
+
+	// Cancel the layout in progress, if any
+	void CancelPendingLayout();
+
+	// Rebuild the edge list and the node/edge grids from the current positions
+	void RebuildSpatialIndex();
+
 	// Get node position for index
 	FVector2D GetNodePosition(int32 NodeIndex) const;
 
-	// Find node at screen position
-	const FDialogNode* FindNodeAtPosition(const FGeometry& Geometry, const FVector2D& ScreenPosition) const;
+	// Array index of a node in the conversation (INDEX_NONE if missing)
+	int32 GetNodeArrayIndex(int32 NodeIndex) const;
+
+	// Graph space <-> widget local space
+	FVector2D GraphToLocal(const FVector2D& GraphPosition) const { return GraphPosition * ZoomAmount + PanOffset; }
+	FVector2D LocalToGraph(const FVector2D& LocalPosition) const { return (LocalPosition - PanOffset) / ZoomAmount; }
+
+	// Find node at a widget-local position
+	const FDialogNode* FindNodeAtPosition(const FGeometry& Geometry, const FVector2D& LocalPosition) const;
+
+	// Pick the level of detail for the current zoom
+	EGraphNodeLOD GetNodeLOD(const FGeometry& AllottedGeometry) const;
+
+	// Draw a single node (by array index) at its graph position
+	void DrawNode(int32 ArrayIndex, const FGeometry& AllottedGeometry, FSlateWindowElementList& OutDrawElements,
+		int32 LayerId, bool bIsSelected, EGraphNodeLOD LOD) const;
 
-	// Draw a single node
-	void DrawNode(const FDialogNode& Node, const FGeometry& AllottedGeometry,
-		FSlateWindowElementList& OutDrawElements, int32 LayerId, bool bIsSelected) const;
+	// Label shown on detailed nodes, formatted on first use
+	const FString& GetNodeLabel(int32 ArrayIndex) const;
 
-	// Draw connection between nodes
-	void DrawConnection(const FVector2D& StartPos, const FVector2D& EndPos,
-		const FGeometry& AllottedGeometry, FSlateWindowElementList& OutDrawElements,
-		int32 LayerId, const FLinearColor& Color) const;
+	// Rebuild the per-color batches from the links overlapping VisibleArea (thin unless detailed)
+	void BuildEdgeBatches(const FGeometry& AllottedGeometry, const FBox2D& VisibleArea, EGraphNodeLOD LOD) const;
 
 	// Get color for response type
 	FLinearColor GetResponseTypeColor(const FDialogLink& Link) const;
@@ -75,8 +162,55 @@ private:
 	// Current conversation
 	TSharedPtr<FConversation> CurrentConversation;
 
-	// Node positions (node index -> position)
-	TMap<int32, FVector2D> NodePositions;
+	// Node positions in graph space, parallel to the conversation's node array
+	TArray<FVector2D> NodePositions;
+
+	// Every link, flattened
+	TArray<FDialogGraphEdge> Edges;
+
+	// Distinct link colors; each link's Bucket indexes into this
+	TArray<FLinearColor> EdgeBucketColors;
+
+	// Layered layout the positions came from (reused for incremental relayout)
+	TSharedPtr<const FDialogGraphLayout> CurrentLayout;
+
+	// Layout being computed on a worker thread (null when idle)
+	TSharedPtr<FGraphLayoutRequest> PendingLayout;
+
+	// Layout spacing and effort
+	FDialogGraphLayoutSettings LayoutSettings;
+
+	// Spatial indices over node rectangles and link bounding boxes (graph space)
+	FDialogGraphSpatialGrid NodeGrid;
+	FDialogGraphSpatialGrid EdgeGrid;
+
+	// Scratch results of the per-frame visibility queries (kept to avoid reallocating every paint)
+	mutable TArray<int32> VisibleNodes;
+	mutable TArray<int32> VisibleEdges;
+
+	// Screen cells already holding a point (Point LOD), so overlapping nodes cost one draw element
+	mutable TBitArray<> PointCells;
+
+	// Node labels, parallel to the node array (empty until first drawn in detail)
+	mutable TArray<FString> NodeLabels;
+
+	// Link quads per color bucket, plus a last batch for the selected node's links (drawn on top)
+	mutable TArray<FDialogGraphEdgeBatch> EdgeBatches;
+	mutable int32 NumBatchedLinks = 0;
+
+	// What EdgeBatches were built for; a layout change marks them stale regardless
+	mutable FDialogGraphEdgeBatchKey EdgeBatchKey;
+	mutable bool bEdgeBatchesStale = true;
+
+	// Render resource the link quads are drawn with
+	mutable FSlateResourceHandle EdgeBrushHandle;
+
+	// View transform: local = graph * ZoomAmount + PanOffset
+	FVector2D PanOffset = FVector2D::ZeroVector;
+	float ZoomAmount = 1.0f;
+
+	// Right mouse button is held
+	bool bIsPanning = false;
 
 	// Selected node
 	const FDialogNode* SelectedNode;
@@ -91,7 +225,21 @@ private:
 	static constexpr float NodeWidth = 150.0f;
 	static constexpr float NodeHeight = 80.0f;
 
-	// Spacing between nodes
+	// Default spacing between nodes in a layer and between layers
 	static constexpr float HorizontalSpacing = 200.0f;
-	static constexpr float VerticalSpacing = 120.0f;
+	static constexpr float VerticalSpacing = 180.0f;
+
+	// Zoom limits
+	static constexpr float MinZoom = 0.05f;
+	static constexpr float MaxZoom = 4.0f;
+
+	// On-screen node width (pixels) needed for the Box and Detail levels of detail
+	static constexpr float BoxLODMinWidth = 12.0f;
+	static constexpr float DetailLODMinWidth = 90.0f;
+
+	// Point size and the screen cell each point claims (pixels)
+	static constexpr float PointSize = 3.0f;
+
+	// Smallest spatial grid cell (graph units)
+	static constexpr double GridCellSize = 256.0;
 };
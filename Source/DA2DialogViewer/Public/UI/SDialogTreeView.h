@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "Widgets/SCompoundWidget.h"
 #include "Widgets/Views/STreeView.h"
+#include "UI/DialogTreeModel.h"
+#include "String/Find.h"
+#include "DA2DialogViewerLog.h"
 
 class FConversation;
 struct FDialogNode;
@@ -12,20 +15,9 @@ class SDialogWheel;
 class FDialogDataManager;
 class FDialogAudioManager;
 
-/**
- * Speaker type classification for dialog lines
- */
-enum class ESpeakerType : uint8
-{
-	Player, // Blue - Hawke (player character)
-	Owner, // Red - Conversation owner (main NPC)
-	Henchman, // Green - Party companion
-	OtherNPC, // Magenta - Other named NPC (NOT FULLY IMPLEMENTED)
-	Reference // Gray - Reference to another node
-};
-
 /**
  * Tree item representing a dialog line in the tree
+ * Items live contiguously in the tree view's item pool and refer to each other by pool index
  */
 class FDialogTreeItem
 {
@@ -33,11 +25,15 @@ public:
 	// Node index in conversation
 	int32 NodeIndex;
 
-	// Parent item (nullptr for root entries)
-	TSharedPtr<FDialogTreeItem> Parent;
+	// Index of the link in the parent node that leads here (entry link index for roots)
+	int32 LinkIndex;
+
+	// Parent item pool index (INDEX_NONE for root entries)
+	int32 ParentIndex;
 
-	// Child items
-	TArray<TSharedPtr<FDialogTreeItem>> Children;
+	// Children occupy a contiguous range of the item pool once built
+	int32 FirstChildIndex;
+	int32 NumChildren;
 
 	// Cached node data for display
 	int32 SpeakerID;
@@ -47,30 +43,46 @@ public:
 	bool bHasAction;
 	int32 NumLinks;
 
-	// Display text
-	FString ParaphraseText; // Short preview (for player choices)
-	FString SpokenText; // Full dialog line
+	// Display text - views into the TLK string pool (or the static placeholders below)
+	// The TLK ID prefix and reference arrow are only added when a row widget is generated
+	FStringView ParaphraseText; // Short preview (for player choices)
+	FStringView SpokenText; // Full dialog line
 
 	// Reference tracking
 	bool bIsReference; // True if this is a reference to an existing node
 	int32 ReferencedNodeIndex; // The original node this references (for display)
 
+	// Lazy construction state - children and display text are filled in on first use
+	bool bChildrenBuilt;
+	bool bTextResolved;
+
 	// Flip-flop tracking - determines if this should be NPC or Player based on alternation
 	bool bIsNPCTurn; // True = NPC turn, False = Player turn
 
-	// Speaker 257 resolution - dynamically determined based on parent party conditions
-	FString ResolvedSpeakerName; // "OWNER", "Carver", "Bethany", etc. (empty if not Speaker 257)
+	// Speaker classification, copied from the tree model's analysis of this occurrence
+	bool bHasSpokenText; // Spoken line has real text (not a placeholder or missing)
+	bool bIsAmbient; // Spoken text but no links - always the conversation owner
+	ESpeakerType SpeakerType;
+	ESpeakerLabel SpeakerLabel;
+	EDialogCompanion Companion; // Resolved from this node's or (for Speaker 257) its parent's party condition
+
+	// Spoken line resolves to an audio file, per player gender (indexed by EPlayerGender)
+	// Copied from the tree model's precomputed availability, or bHasSpokenText when that wasn't known
+	bool bHasAudio[2];
 
-	// Static tracking for encountered player speaker IDs (to avoid log spam)
-	static TSet<int32> EncounteredPlayerSpeakerIDs;
+	// File the spoken line resolves to per player gender (0 if none), for looking up its waveform
+	uint32 AudioFileID[2];
 
-	// Hardcoded player speaker IDs (identified via flip-flop analysis of all conversations)
-	// These speaker IDs are used >95% of the time for player lines
-	// Derived from analyzing 704 DA2 conversations with flip-flop logic
-	static TSet<int32> KnownPlayerSpeakerIDs;
+	// Spoken line placeholders for lines without text
+	static constexpr const TCHAR* ContinueText = TEXT("[[CONTINUE]]");
+	static constexpr const TCHAR* EndDialogText = TEXT("[[END DIALOG]]");
 
 	FDialogTreeItem()
 		: NodeIndex(-1)
+		  , LinkIndex(-1)
+		  , ParentIndex(INDEX_NONE)
+		  , FirstChildIndex(INDEX_NONE)
+		  , NumChildren(0)
 		  , SpeakerID(-1)
 		  , TLKStringID(-1)
 		  , ParaphraseTLKID(-1)
@@ -79,7 +91,16 @@ public:
 		  , NumLinks(0)
 		  , bIsReference(false)
 		  , ReferencedNodeIndex(-1)
+		  , bChildrenBuilt(false)
+		  , bTextResolved(false)
 		  , bIsNPCTurn(false)
+		  , bHasSpokenText(false)
+		  , bIsAmbient(false)
+		  , SpeakerType(ESpeakerType::Owner)
+		  , SpeakerLabel(ESpeakerLabel::Owner)
+		  , Companion(EDialogCompanion::None)
+		  , bHasAudio{false, false}
+		  , AudioFileID{0, 0}
 	{
 	}
 
@@ -97,16 +118,40 @@ public:
 	}
 
 	// Check if a text string is "validly empty" (empty, placeholder, or not found)
-	static bool IsValidlyEmpty(const FString& Text)
+	static bool IsValidlyEmpty(FStringView Text)
 	{
-		return Text.IsEmpty() || Text.Contains("[[") || Text.EndsWith(TEXT("Found]"));
+		return Text.IsEmpty() || UE::String::FindFirst(Text, TEXT("[[")) != INDEX_NONE || Text.EndsWith(TEXT("Found]"));
 	}
 
-	// Check if this line is an ambient line
-	// Ambient = has valid spoken text but no children (links)
-	bool IsAmbient() const
+	// Check if the spoken line is a [[CONTINUE]] / [[END DIALOG]] placeholder
+	bool IsPlaceholderLine() const
 	{
-		return !IsValidlyEmpty(SpokenText) && NumLinks == 0;
+		return SpokenText.Equals(ContinueText) || SpokenText.Equals(EndDialogText);
+	}
+
+	// Spoken line as displayed in the row ("[TLK id] text", arrow prefix for references)
+	FString GetSpokenDisplayText() const
+	{
+		FString Text = bIsReference ? TEXT("→ ") : TEXT("");
+		if (!IsPlaceholderLine())
+		{
+			Text += FString::Printf(TEXT("[TLK %d] "), TLKStringID);
+		}
+		Text.Append(SpokenText.GetData(), SpokenText.Len());
+		return Text;
+	}
+
+	// Paraphrase as displayed in the row ("[TLK id] text", empty if there is none)
+	FString GetParaphraseDisplayText() const
+	{
+		if (ParaphraseText.IsEmpty())
+		{
+			return FString();
+		}
+
+		FString Text = FString::Printf(TEXT("[TLK %d] "), ParaphraseTLKID);
+		Text.Append(ParaphraseText.GetData(), ParaphraseText.Len());
+		return Text;
 	}
 
 	// Validate player line has proper paraphrase/spoken text combination
@@ -126,163 +171,49 @@ public:
 
 		if (!bHasValidParaphrase && bHasValidSpokenText)
 		{
-			UE_LOG(LogTemp, Error, TEXT("INVALID Player Line: NO paraphrase but HAS spoken text! Paraphrase='%s', Spoken='%s'"),
-			       *ParaphraseText, *SpokenText);
+			UE_LOG(LogDA2Dialog, Error, TEXT("INVALID Player Line: NO paraphrase but HAS spoken text! Paraphrase='%s', Spoken='%s'"),
+			       *FString(ParaphraseText), *FString(SpokenText));
 			checkf(false, TEXT("Player line has spoken text but no paraphrase - this should not happen!"));
 		}
 	}
 
-	// Check if this line is from a henchman (based on party plot conditions)
+	// Check if this line is from a henchman (an individual companion resolved from party conditions)
 	bool IsHenchman() const
 	{
-		// Henchman is ONLY identified when ResolvedSpeakerName is a specific companion name (FOLLOWER_STATE_ACTIVE check)
-		// NOT for composite party flags like "[Party: Solo Player]", "[Party: Contains Mage/s]", etc.
-
-		// Individual companion names (these indicate FOLLOWER_STATE_ACTIVE):
-		// "Carver", "Bethany", "Varric", "Aveline", "Isabela", "Merrill", "Anders", "Fenris", "Sebastian"
-
-		// Composite party flags (these do NOT indicate a henchman is speaking):
-		// "[Party: Female/s or Female Player]", "[Party: Contains Mage/s]", "[Party: Solo Player]"
-
-		// Check if ResolvedSpeakerName is set and does NOT start with "[Party:"
-		if (!ResolvedSpeakerName.IsEmpty() && !ResolvedSpeakerName.StartsWith(TEXT("[Party:")))
-		{
-			return true; // This is an individual companion speaking (green color)
-		}
-
-		return false; // Either empty or composite flag (not a henchman speaking)
+		return FDialogTreeModel::IsCompanionSpeaker(Companion);
 	}
 
-	// Determine speaker type - SINGLE SOURCE OF TRUTH for both text and color
-	// This method consolidates all speaker identification logic in one place
+	// Speaker type - SINGLE SOURCE OF TRUTH for both text and color, classified when the conversation is analyzed
 	ESpeakerType GetSpeakerType() const
 	{
-		// PRIORITY 1 (HIGHEST): Reference nodes
-		if (bIsReference)
-		{
-			return ESpeakerType::Reference;
-		}
-
-		// PRIORITY 2: Ambient line detection
-		// Ambient lines (spoken text with no children) ALWAYS use the conversation owner
-		if (IsAmbient())
-		{
-			return ESpeakerType::Owner;
-		}
-
-		// PRIORITY 3: Player detection via hardcoded speaker IDs
-		// These IDs were identified via flip-flop analysis of all DA2 conversations
-		if (KnownPlayerSpeakerIDs.Contains(SpeakerID))
-		{
-			return ESpeakerType::Player;
-		}
-
-		// PRIORITY 4: Empty/Continue/End Dialog lines
-		// These are always OWNER (red) even if they have party conditions
-		if (SpokenText.Contains(TEXT("[[CONTINUE]]")) || SpokenText.Contains(TEXT("[[END DIALOG]]")))
-		{
-			return ESpeakerType::Owner;
-		}
-
-		// PRIORITY 5: NPC type identification
-		// Now we know it's an NPC turn with actual dialogue - determine which type
-
-		// Henchman (party member)
-		if (IsHenchman())
-		{
-			return ESpeakerType::Henchman;
-		}
-
-		// Speaker 257 defaults to OWNER
-		if (SpeakerID == 257)
-		{
-			return ESpeakerType::Owner;
-		}
-
-		// Other named NPC (NOT FULLY IMPLEMENTED)
-		return ESpeakerType::OtherNPC;
+		return SpeakerType;
 	}
 
-	// Get speaker type string using flip-flop logic and conversation context
+	// Get speaker column text
 	FString GetSpeakerString(const FString& OwnerTag = TEXT("")) const
 	{
-		// PRIORITY 1 (HIGHEST): Ambient line detection
-		// Ambient lines (spoken text with no children) ALWAYS use the conversation owner
-		// This supersedes even player detection because ambient lines are always NPC lines
-		if (IsAmbient())
-		{
-			// Validate that the conversation has an owner defined
-			// If not, this is a data integrity issue (possibly cut content)
-			checkf(!OwnerTag.IsEmpty(),
-			       TEXT("Ambient line detected (Node %d, Speaker %d, TLK %d) but conversation has NO OWNER! This may be cut content or a data error."),
-			       NodeIndex, SpeakerID, TLKStringID);
-
-			UE_LOG(LogTemp, Log, TEXT("Ambient line detected: Node %d, Speaker %d -> treating as OWNER (%s)"),
-			       NodeIndex, SpeakerID, *OwnerTag);
-
-			return TEXT("OWNER");
-		}
-
-		// PRIORITY 2: Player detection via flip-flop
-		// This supersedes EVERYTHING (except ambient) - if flip-flop says player, it's PLAYER (blue)
-		if (!bIsNPCTurn)
+		switch (SpeakerLabel)
 		{
-			// Log unique speaker IDs for player lines (only once per ID)
-			if (!EncounteredPlayerSpeakerIDs.Contains(SpeakerID))
-			{
-				EncounteredPlayerSpeakerIDs.Add(SpeakerID);
-				UE_LOG(LogTemp, Warning, TEXT("Found PLAYER with Speaker ID: %d"), SpeakerID);
-			}
-
+		case ESpeakerLabel::Player:
 			return TEXT("PLAYER");
-		}
 
-		// PRIORITY 3: Empty/Continue/End Dialog lines
-		// If this is an NPC line but has no actual dialogue, treat as OWNER
-		// Owner name is displayed in static header, so just show "OWNER"
-		if (SpokenText.Contains(TEXT("[[CONTINUE]]")) || SpokenText.Contains(TEXT("[[END DIALOG]]")))
-		{
-			return TEXT("OWNER");
-		}
-
-		// PRIORITY 4: NPC type identification
-		// Now we know it's an NPC turn with actual dialogue - determine which type
+		case ESpeakerLabel::Companion:
+			return FDialogTreeModel::GetCompanionName(Companion); // Individual companion name (e.g., "Carver", "Bethany")
 
-		// Check if this is a party henchman (based on resolved name from party conditions)
-		if (!ResolvedSpeakerName.IsEmpty())
-		{
-			// WORKAROUND: Composite party flags (e.g., "[Party: Solo Player]") should display as OWNER
-			// These are NOT individual companions speaking, they're just party-related conditions
-			// NOTE: This logic is incomplete - we don't fully understand all speaker ID patterns yet
-			// For now, we assume composite party flags with NPC turn = OWNER
-			if (ResolvedSpeakerName.StartsWith(TEXT("[Party:")))
-			{
-				return TEXT("OWNER"); // Composite party flag → OWNER
-			}
-			else
-			{
-				return ResolvedSpeakerName; // Individual companion name (e.g., "Carver", "Bethany")
-			}
-		}
+		case ESpeakerLabel::OtherNPC:
+			return FString::Printf(TEXT("Speaker %d"), SpeakerID);
 
-		// Check if henchman (fallback detection)
-		if (IsHenchman())
-		{
-			return TEXT("HENCHMAN");
-		}
+		case ESpeakerLabel::Owner:
+		default:
+			// Validate that the conversation has an owner defined
+			// If not, this is a data integrity issue (possibly cut content)
+			checkf(!bIsAmbient || !OwnerTag.IsEmpty(),
+			       TEXT("Ambient line detected (Node %d, Speaker %d, TLK %d) but conversation has NO OWNER! This may be cut content or a data error."),
+			       NodeIndex, SpeakerID, TLKStringID);
 
-		// Speaker 257 defaults to OWNER
-		// Owner name is displayed in static header, so just show "OWNER"
-		if (SpeakerID == 257)
-		{
+			// Owner name is displayed in static header, so just show "OWNER"
 			return TEXT("OWNER");
 		}
-
-		// Other named NPC
-		// NOTE: Incomplete logic - some other speaker IDs may also mean OWNER or other named NPCs
-		// We don't have enough information to properly identify all speaker types yet
-		UE_LOG(LogTemp, VeryVerbose, TEXT("TODO: Identify named NPC with Speaker ID: %d"), SpeakerID);
-		return FString::Printf(TEXT("Speaker %d"), SpeakerID);
 	}
 };
 
@@ -302,12 +233,21 @@ public:
 
 	void Construct(const FArguments& InArgs, TSharedPtr<FDialogDataManager> InDataManager);
 
-	// Load conversation into tree
+	// Load conversation into tree (analyzes it on the calling thread)
 	void LoadConversation(TSharedPtr<FConversation> InConversation);
 
+	// Swap in a tree model that was already built (e.g. on a worker thread)
+	void LoadModel(TSharedPtr<const FDialogTreeModel> InModel);
+
+	// Audio manager shared with the dialog wheel (for prefetching option audio)
+	TSharedPtr<FDialogAudioManager> GetAudioManager() const { return AudioManager; }
+
 	// Clear tree
 	void Clear();
 
+	// Re-resolve row text after a player gender change (rows keep their expansion and selection)
+	void RefreshText();
+
 	// Get currently selected node
 	const FDialogNode* GetSelectedNode() const;
 
@@ -323,23 +263,24 @@ public:
 	void NavigateToPlayerChoice(int32 PlayerNodeIndex);
 
 	// Expand/collapse operations
+	// Work is done breadth-first within a per-frame time budget, large trees finish over several frames
 	void ExpandAll();
 	void CollapseAll();
-	void ExpandBranch(TSharedPtr<FDialogTreeItem> Item);
-	void CollapseBranch(TSharedPtr<FDialogTreeItem> Item);
+	void ExpandBranch(FDialogTreeItem* Item);
+	void CollapseBranch(FDialogTreeItem* Item);
 
 private:
 	// Generate tree row widget
-	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FDialogTreeItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateRow(FDialogTreeItem* Item, const TSharedRef<STableViewBase>& OwnerTable);
 
 	// Get children for tree item
-	void OnGetChildren(TSharedPtr<FDialogTreeItem> Item, TArray<TSharedPtr<FDialogTreeItem>>& OutChildren);
+	void OnGetChildren(FDialogTreeItem* Item, TArray<FDialogTreeItem*>& OutChildren);
 
 	// Selection changed
-	void OnSelectionChanged(TSharedPtr<FDialogTreeItem> Item, ESelectInfo::Type SelectInfo);
+	void OnSelectionChanged(FDialogTreeItem* Item, ESelectInfo::Type SelectInfo);
 
 	// Double-click handler - jump to original node for references
-	void OnMouseDoubleClick(TSharedPtr<FDialogTreeItem> Item);
+	void OnMouseDoubleClick(FDialogTreeItem* Item);
 
 	// Context menu
 	TSharedPtr<SWidget> OnContextMenuOpening();
@@ -347,26 +288,51 @@ private:
 	// Build tree from conversation
 	void BuildTreeFromConversation();
 
-	// Recursively build tree items
-	void BuildTreeRecursive(int32 NodeIndex, TSharedPtr<FDialogTreeItem> ParentItem, TMap<int32, TSharedPtr<FDialogTreeItem>>& FirstOccurrences);
+	// Create a single tree item without children or display text
+	FDialogTreeItem* CreateTreeItem(int32 NodeIndex, FDialogTreeItem* ParentItem, int32 LinkIndex);
+
+	// Create an item's children on first expansion
+	void MaterializeChildren(FDialogTreeItem* Item);
+
+	// Look up an item's spoken/paraphrase text on first display
+	void ResolveItemText(FDialogTreeItem* Item);
+
+	// Display text helpers (views into the TLK string pool)
+	FStringView GetSpokenTextView(const FDialogNode& Node) const;
+	FStringView GetParaphraseTextView(int32 ParaphraseTLKID) const;
+
+	// Pool index of an item (items are only ever handed out from the pool)
+	int32 GetItemIndex(const FDialogTreeItem* Item) const { return static_cast<int32>(Item - ItemPool.GetData()); }
 
 	// Find tree item by node index
-	TSharedPtr<FDialogTreeItem> FindTreeItem(int32 NodeIndex);
-	TSharedPtr<FDialogTreeItem> FindTreeItemRecursive(int32 NodeIndex, TSharedPtr<FDialogTreeItem> Item);
+	FDialogTreeItem* FindTreeItem(int32 NodeIndex);
 
-	// Find first (non-reference) occurrence of a node
-	TSharedPtr<FDialogTreeItem> FindFirstOccurrence(int32 NodeIndex);
-	TSharedPtr<FDialogTreeItem> FindFirstOccurrenceRecursive(int32 NodeIndex, TSharedPtr<FDialogTreeItem> Item);
+	// Find first (non-reference) occurrence of a node, materializing the path to it
+	FDialogTreeItem* FindFirstOccurrence(int32 NodeIndex);
 
-	// Get color for speaker
-	FSlateColor GetSpeakerColor(int32 SpeakerID) const;
+	// Find the row for one specific occurrence of a node, materializing its parent if needed
+	FDialogTreeItem* FindOccurrenceItem(int32 NodeIndex, const FDialogOccurrence& Occurrence);
 
-	// Resolve companion name from party flag
-	static FString ResolveCompanionFromPartyFlag(int32 FlagIndex);
+	// Select the next place the item's node appears in the tree (wraps around)
+	void JumpToNextOccurrence(FDialogTreeItem* Item);
 
-private:
-	// Detect conversation owner using heuristic: most frequent NPC speaker (excluding player IDs)
-	int32 DetectConversationOwner() const;
+	// Auto-play the path through an item: its ancestors from the entry line down, then first children until a leaf or reference
+	void AutoPlayPath(FDialogTreeItem* Item);
+
+	// Expand an item's ancestors, select it and scroll it into view
+	void RevealItem(FDialogTreeItem* Item);
+
+	// Queue items (and everything below them) for expansion or collapse, replacing any pass in progress
+	void StartExpansionPass(TConstArrayView<FDialogTreeItem*> StartItems, bool bExpand);
+
+	// Drop any expansion pass in progress
+	void CancelExpansionPass();
+
+	// Process queued expansion work until the frame budget runs out
+	EActiveTimerReturnType ProcessExpansionPass(double InCurrentTime, float InDeltaTime);
+
+	// Get color for speaker
+	FSlateColor GetSpeakerColor(int32 SpeakerID) const;
 
 private:
 	// Data manager reference
@@ -375,17 +341,36 @@ private:
 	// Current conversation
 	TSharedPtr<FConversation> CurrentConversation;
 
-	// Detected owner speaker ID for current conversation (using heuristic)
-	int32 DetectedOwnerSpeakerID;
+	// Structural analysis of the current conversation (first occurrences, detected owner)
+	TSharedPtr<const FDialogTreeModel> TreeModel;
 
 	// Tree view widget
-	TSharedPtr<STreeView<TSharedPtr<FDialogTreeItem>>> TreeView;
+	TSharedPtr<STreeView<FDialogTreeItem*>> TreeView;
+
+	// Every item of the current tree, stored contiguously
+	// Reserved for the model's worst case up front so it never reallocates and item pointers stay stable,
+	// rebuilding or clearing the tree is a single Reset
+	TArray<FDialogTreeItem> ItemPool;
+
+	// Root items (entry points, pointers into ItemPool)
+	TArray<FDialogTreeItem*> RootItems;
+
+	// Node index -> pool index of its first-occurrence row (materialized rows only)
+	TMap<int32, int32> FirstOccurrenceItems;
+
+	// Node index -> pool indices of every row showing it (materialized rows only)
+	TMultiMap<int32, int32> OccurrenceItems;
+
+	// Breadth-first queue of pool indices for the expansion pass in progress
+	TArray<int32> ExpansionQueue;
+	int32 ExpansionQueueHead = 0;
+	bool bExpansionPassExpands = true;
 
-	// Root items (entry points)
-	TArray<TSharedPtr<FDialogTreeItem>> RootItems;
+	// Active timer driving an expansion pass across frames
+	TWeakPtr<FActiveTimerHandle> ExpansionTimerHandle;
 
 	// Currently selected item
-	TSharedPtr<FDialogTreeItem> SelectedItem;
+	FDialogTreeItem* SelectedItem = nullptr;
 
 	// Dialog wheel reference
 	TSharedPtr<SDialogWheel> DialogWheel;
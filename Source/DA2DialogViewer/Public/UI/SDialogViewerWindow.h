@@ -6,9 +6,18 @@
 #include "Widgets/SCompoundWidget.h"
 
 class FDialogDataManager;
+class FDialogTreeModel;
+class FDialogSearchIndex;
 class SDialogTreeView;
 class SDialogWheel;
 class STextBlock;
+class SSearchBox;
+class ITableRow;
+class STableViewBase;
+template <typename ItemType> class SListView;
+struct FConversationLoadRequest;
+struct FSearchIndexLoadRequest;
+struct FDialogSearchHit;
 
 /**
  * Main dialog viewer window
@@ -20,12 +29,51 @@ public:
 	SLATE_BEGIN_ARGS(SDialogViewerWindow) {}
 	SLATE_END_ARGS()
 
+	~SDialogViewerWindow();
+
 	void Construct(const FArguments& InArgs, TSharedPtr<FDialogDataManager> InDataManager);
 
 private:
 	// Load conversation button clicked
 	FReply OnLoadConversationClicked();
 
+	// Parse the conversation and build its tree model on a worker thread, then show NodeIndex (or the first entry node)
+	// Cancels any load that is still in flight
+	void StartLoadConversation(const FString& ConversationPath, int32 NodeIndex = INDEX_NONE);
+
+	// Worker finished (game thread) - swap the new model in unless the request is stale
+	void OnConversationLoaded(TSharedPtr<FConversationLoadRequest> Request, TSharedPtr<const FDialogTreeModel> Model);
+
+	// Cancel the in-flight load, if any
+	void CancelPendingLoad();
+
+	// Throbber visibility while a load is in flight
+	EVisibility GetLoadingVisibility() const;
+
+	// Open the search index, or build it if the data changed, on a worker thread
+	void StartLoadSearchIndex();
+
+	// Search box edited - query the index and refresh the results
+	void OnSearchTextChanged(const FText& InText);
+
+	// Enter in the search box jumps to the first result
+	void OnSearchTextCommitted(const FText& InText, ETextCommit::Type CommitType);
+
+	// Generate a search result row
+	TSharedRef<ITableRow> OnGenerateSearchResultRow(TSharedPtr<FDialogSearchHit> Hit, const TSharedRef<STableViewBase>& OwnerTable);
+
+	// Search result clicked
+	void OnSearchResultClicked(TSharedPtr<FDialogSearchHit> Hit);
+
+	// Show a search hit, loading its conversation first if it is not the current one
+	void NavigateToSearchHit(const FDialogSearchHit& Hit);
+
+	// Results list is only shown while there are results
+	EVisibility GetSearchResultsVisibility() const;
+
+	// Search box hint (tells the user while the index is still being built)
+	FText GetSearchHintText() const;
+
 	// Reset plot state button clicked
 	FReply OnResetPlotStateClicked();
 
@@ -62,4 +110,25 @@ private:
 
 	// Current status message
 	FText CurrentStatus;
+
+	// In-flight background load (nullptr when idle)
+	TSharedPtr<FConversationLoadRequest> PendingLoad;
+
+	// Full-text index over all conversations (nullptr until loaded)
+	TSharedPtr<const FDialogSearchIndex> SearchIndex;
+
+	// In-flight search index open/build (nullptr when idle)
+	TSharedPtr<FSearchIndexLoadRequest> PendingSearchIndex;
+
+	// Hits for the current search text
+	TArray<TSharedPtr<FDialogSearchHit>> SearchResults;
+
+	// Search results list
+	TSharedPtr<SListView<TSharedPtr<FDialogSearchHit>>> SearchResultsList;
+
+	// Search box (its text is searched again once the index arrives)
+	TSharedPtr<SSearchBox> SearchBox;
+
+	// Results shown per query
+	static constexpr int32 MaxSearchResults = 200;
 };
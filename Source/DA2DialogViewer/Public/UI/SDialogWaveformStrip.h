@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+struct FDialogWaveformSummary;
+
+/**
+ * Small waveform of one line, drawn from its precomputed summary
+ * Picks the pyramid level closest to one bucket per pixel, so painting is one line batch regardless of the file's length
+ */
+class SDialogWaveformStrip : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SDialogWaveformStrip)
+		: _DesiredSize(FVector2D(64.0f, 14.0f))
+		{
+		}
+
+		// Summary to draw, nothing is drawn while it is null
+		SLATE_ATTRIBUTE(TSharedPtr<const FDialogWaveformSummary>, Summary)
+		SLATE_ARGUMENT(FVector2D, DesiredSize)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	// SWidget interface
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+	                      FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float) const override;
+
+private:
+	TAttribute<TSharedPtr<const FDialogWaveformSummary>> Summary;
+	FVector2D DesiredSize;
+
+	// Reused across paints
+	mutable TArray<FVector2f> LinePoints;
+};
@@ -19,10 +19,21 @@ struct FDialogWheelOption
 	float Angle;
 	bool bIsHovered;
 
+	// Display data, cached when the node is set so painting never touches the TLK table or measures text
+	FString DisplayText; // Option text (truncated for display)
+	FVector2D TextSize;
+	FString ToneLabel; // Shown in the center square while hovered
+	FVector2D ToneLabelSize;
+	FLinearColor ToneColor;
+	FSlateRect HitRect; // Hit-test area, relative to the wheel center
+
 	FDialogWheelOption()
 		: Position(),
 		  Angle(0.0f)
 		  , bIsHovered(false)
+		  , TextSize(FVector2D::ZeroVector)
+		  , ToneLabelSize(FVector2D::ZeroVector)
+		  , ToneColor(FLinearColor::White)
 	{
 	}
 };
@@ -48,6 +59,9 @@ public:
 	// Clear wheel
 	void Clear();
 
+	// Re-resolve the cached option text (e.g. after the player gender changes)
+	void RefreshText();
+
 	// Set tree view reference for navigation
 	void SetTreeView(TSharedPtr<SDialogTreeView> InTreeView) { TreeView = InTreeView; }
 
@@ -74,6 +88,12 @@ private:
 	// Calculate option positions
 	void CalculateOptionPositions();
 
+	// Resolve and measure option text, colors and hit areas once per node
+	void CacheOptionVisuals();
+
+	// Move the hover highlight, repainting only if it changed
+	void SetHoveredOption(int32 OptionIndex);
+
 	// Get angle for response type
 	float GetAngleForResponseType(EResponseType Type) const;
 
@@ -119,6 +139,9 @@ private:
 	// Currently hovered option
 	int32 HoveredOptionIndex = INDEX_NONE;
 
+	// Cached center text when nothing is hovered ("Node <index>")
+	FString CenterText;
+
 	// Wheel radius
 	static constexpr float WheelRadius = 150.0f;
 